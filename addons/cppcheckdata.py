@@ -436,6 +436,9 @@ class Scope:
         function       If this scope belongs at a function call, this attribute
                        has the Function information. See the Function class.
         type           Type of scope: Global, Function, Class, If, While
+        valueflowSteps  Number of ValueFlow analysis steps in a function scope
+        valueflowTimeMs Time of the ValueFlow analysis of a function scope in ms
+        valueflowBailout Was the ValueFlow analysis of the function cut off?
     """
 
     Id = None
@@ -452,6 +455,9 @@ class Scope:
     isExecutable = None
     varlistId = None
     varlist = None
+    valueflowSteps = None
+    valueflowTimeMs = None
+    valueflowBailout = None
 
     def __init__(self, element):
         self.Id = element.get('id')
@@ -469,6 +475,9 @@ class Scope:
                                            'Switch', 'Try', 'Catch', 'Unconditional', 'Lambda'))
         self.varlistId = list()
         self.varlist = list()
+        self.valueflowSteps = int(element.get('valueflowSteps', '0'))
+        self.valueflowTimeMs = int(element.get('valueflowTimeMs', '0'))
+        self.valueflowBailout = element.get('valueflowBailout') == 'true'
 
     def __repr__(self):
         attrs = ["Id", "className", "functionId", "bodyStartId", "bodyEndId",
@@ -222,6 +222,15 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
             else if (std::strncmp(argv[i], "--bug-hunting-check-function-max-time=", 38) == 0)
                 mSettings->bugHuntingCheckFunctionMaxTime = std::atoi(argv[i] + 38);
 
+            // Analyze the functions in parallel in bug hunting mode
+            else if (std::strncmp(argv[i], "--bug-hunting-jobs=", 19) == 0) {
+                mSettings->bugHuntingJobs = std::atoi(argv[i] + 19);
+                if (mSettings->bugHuntingJobs < 1) {
+                    printError("argument to '--bug-hunting-jobs=' must be at least 1.");
+                    return false;
+                }
+            }
+
             // Check configuration
             else if (std::strcmp(argv[i], "--check-config") == 0)
                 mSettings->checkConfiguration = true;
@@ -301,6 +310,18 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
             else if (std::strcmp(argv[i], "--dump") == 0)
                 mSettings->dump = true;
 
+            else if (std::strncmp(argv[i], "--dump-format=", 14) == 0) {
+                const std::string format = argv[i] + 14;
+                if (format == "xml")
+                    mSettings->dumpFormat = Settings::DumpFormat::Xml;
+                else if (format == "binary")
+                    mSettings->dumpFormat = Settings::DumpFormat::Binary;
+                else {
+                    printError("unrecognized dump format: \"" + format + "\". Supported formats: xml, binary.");
+                    return false;
+                }
+            }
+
             else if (std::strncmp(argv[i], "--enable=", 9) == 0) {
                 const std::string errmsg = mSettings->addEnabled(argv[i] + 9);
                 if (!errmsg.empty()) {
@@ -544,6 +565,32 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
             else if (std::strncmp(argv[i], "--max-ctu-depth=", 16) == 0)
                 mSettings->maxCtuDepth = std::atoi(argv[i] + 16);
 
+            // ValueFlow limits per function
+            else if (std::strncmp(argv[i], "--max-valueflow-function-steps=", 31) == 0) {
+                mSettings->maxValueFlowFunctionSteps = std::atoi(argv[i] + 31);
+                if (mSettings->maxValueFlowFunctionSteps < 0) {
+                    printError("argument to '--max-valueflow-function-steps=' must not be negative.");
+                    return false;
+                }
+            }
+
+            else if (std::strncmp(argv[i], "--max-valueflow-function-time=", 30) == 0) {
+                mSettings->maxValueFlowFunctionTime = std::atoi(argv[i] + 30);
+                if (mSettings->maxValueFlowFunctionTime < 0) {
+                    printError("argument to '--max-valueflow-function-time=' must not be negative.");
+                    return false;
+                }
+            }
+
+            // ValueFlow memory budget
+            else if (std::strncmp(argv[i], "--max-valueflow-memory=", 23) == 0) {
+                mSettings->maxValueFlowMemory = std::atoi(argv[i] + 23);
+                if (mSettings->maxValueFlowMemory < 0) {
+                    printError("argument to '--max-valueflow-memory=' must not be negative.");
+                    return false;
+                }
+            }
+
             // Write results in file
             else if (std::strncmp(argv[i], "--output-file=", 14) == 0)
                 mSettings->outputFile = Path::simplifyPath(Path::fromNativeSeparators(argv[i] + 14));
@@ -746,6 +793,14 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
 #endif
 
             // show timing information..
+            else if (std::strncmp(argv[i], "--showtime-output=", 18) == 0) {
+                mSettings->showtimeOutput = Path::fromNativeSeparators(argv[i] + 18);
+                if (mSettings->showtimeOutput.empty()) {
+                    printError("no file name given for option '--showtime-output'.");
+                    return false;
+                }
+            }
+
             else if (std::strncmp(argv[i], "--showtime=", 11) == 0) {
                 const std::string showtimeMode = argv[i] + 11;
                 if (showtimeMode == "file")
@@ -941,6 +996,10 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
     else if ((def || mSettings->preprocessOnly) && !maxconfigs)
         mSettings->maxConfigs = 1U;
 
+    // The trace is written from the accumulated timer results
+    if (!mSettings->showtimeOutput.empty() && (mSettings->showtime == SHOWTIME_MODES::SHOWTIME_NONE || mSettings->showtime == SHOWTIME_MODES::SHOWTIME_FILE))
+        mSettings->showtime = SHOWTIME_MODES::SHOWTIME_SUMMARY;
+
     if (mSettings->checks.isEnabled(Checks::unusedFunction) && mSettings->jobs > 1) {
         printMessage("unusedFunction check can't be used with '-j' option. Disabling unusedFunction check.");
     }
@@ -989,6 +1048,9 @@ void CmdLineParser::printHelp()
         "    --bug-hunting\n"
         "                         Enable noisy and soundy analysis. The normal Cppcheck\n"
         "                         analysis is turned off.\n"
+        "    --bug-hunting-jobs=<jobs>\n"
+        "                         Number of threads that analyze the functions of a\n"
+        "                         file in parallel in bug hunting mode. Default is 1.\n"
         "    --cppcheck-build-dir=<dir>\n"
         "                         Cppcheck work folder. Advantages:\n"
         "                          * whole program analysis\n"
@@ -1017,6 +1079,15 @@ void CmdLineParser::printHelp()
         "    --dump               Dump xml data for each translation unit. The dump\n"
         "                         files have the extension .dump and contain ast,\n"
         "                         tokenlist, symboldatabase, valueflow.\n"
+        "    --dump-format=<format>\n"
+        "                         Format of the dump files written by --dump:\n"
+        "                          * xml\n"
+        "                                  The default xml format.\n"
+        "                          * binary\n"
+        "                                  Compact binary format with string tables,\n"
+        "                                  much smaller and faster to write. It can\n"
+        "                                  be read with BinaryDump::read(). Addons\n"
+        "                                  always get xml dumps.\n"
         "    -D<ID>               Define preprocessor symbol. Unless --max-configs or\n"
         "                         --force is used, Cppcheck will only check the given\n"
         "                         configuration when -D is used.\n"
@@ -1112,6 +1183,22 @@ void CmdLineParser::printHelp()
     "    --max-ctu-depth=N    Max depth in whole program analysis. The default value\n"
     "                         is 2. A larger value will mean more errors can be found\n"
     "                         but also means the analysis will be slower.\n"
+    "    --max-valueflow-function-steps=N\n"
+    "                         Max number of ValueFlow analysis steps for a single\n"
+    "                         function. When the limit is reached the analysis of\n"
+    "                         that function is cut off and the rest of the file is\n"
+    "                         analyzed normally. Default is 0, no limit.\n"
+    "    --max-valueflow-function-time=<seconds>\n"
+    "                         Max time for the ValueFlow analysis of a single\n"
+    "                         function. When the limit is reached the analysis of\n"
+    "                         that function is cut off and the rest of the file is\n"
+    "                         analyzed normally. Default is 0, no limit.\n"
+    "    --max-valueflow-memory=N\n"
+    "                         Memory budget in MB for the ValueFlow values of each\n"
+    "                         file. When the budget is used up the analysis of the\n"
+    "                         file continues with less precision: possible values\n"
+    "                         are dropped and expensive passes are skipped. The\n"
+    "                         default value 0 means no limit.\n"
     "    --output-file=<file> Write results to file, rather than standard error.\n"
     "    --project=<file>     Run Cppcheck on project. The <file> can be a Visual\n"
     "                         Studio Solution (*.sln), Visual Studio Project\n"
@@ -32,6 +32,7 @@
 #include "settings.h"
 #include "suppressions.h"
 #include "threadexecutor.h"
+#include "timer.h"
 #include "utils.h"
 #include "checkunusedfunctions.h"
 
@@ -39,6 +40,7 @@
 #include <cstdio>
 #include <cstdlib> // EXIT_SUCCESS and EXIT_FAILURE
 #include <cstring>
+#include <fstream>
 #include <iostream>
 #include <list>
 #include <memory>
@@ -863,10 +865,20 @@ int CppCheckExecutor::check_internal(CppCheck& cppcheck, int /*argc*/, const cha
 {
     Settings& settings = cppcheck.settings();
     mSettings = &settings;
-    const bool std = tryLoadLibrary(settings.library, argv[0], "std.cfg");
+    // The configuration is cached in the build dir so the xml files don't need to be parsed each time
+    std::vector<std::string> cfgs(1, "std.cfg");
+    cfgs.insert(cfgs.end(), settings.libraries.begin(), settings.libraries.end());
+    if (settings.posix())
+        cfgs.emplace_back("posix.cfg");
+    if (settings.isWindowsPlatform())
+        cfgs.emplace_back("windows.cfg");
+    const std::string libraryCache = settings.buildDir.empty() ? std::string() : (settings.buildDir + "/library.cache");
+    const bool cached = !libraryCache.empty() && settings.library.loadCache(libraryCache, argv[0], cfgs);
+
+    const bool std = cached || tryLoadLibrary(settings.library, argv[0], "std.cfg");
 
     for (const std::string &lib : settings.libraries) {
-        if (!tryLoadLibrary(settings.library, argv[0], lib.c_str())) {
+        if (!cached && !tryLoadLibrary(settings.library, argv[0], lib.c_str())) {
             const std::string msg("Failed to load the library " + lib);
             const std::list<ErrorMessage::FileLocation> callstack;
             ErrorMessage errmsg(callstack, emptyString, Severity::information, msg, "failedToLoadCfg", Certainty::normal);
@@ -876,12 +888,15 @@ int CppCheckExecutor::check_internal(CppCheck& cppcheck, int /*argc*/, const cha
     }
 
     bool posix = true;
-    if (settings.posix())
+    if (settings.posix() && !cached)
         posix = tryLoadLibrary(settings.library, argv[0], "posix.cfg");
     bool windows = true;
-    if (settings.isWindowsPlatform())
+    if (settings.isWindowsPlatform() && !cached)
         windows = tryLoadLibrary(settings.library, argv[0], "windows.cfg");
 
+    if (!cached && !libraryCache.empty() && std && posix && windows)
+        settings.library.saveCache(libraryCache);
+
     if (!std || !posix || !windows) {
         const std::list<ErrorMessage::FileLocation> callstack;
         const std::string msg("Failed to load " + std::string(!std ? "std.cfg" : !posix ? "posix.cfg" : "windows.cfg") + ". Your Cppcheck installation is broken, please re-install.");
@@ -1015,6 +1030,12 @@ int CppCheckExecutor::check_internal(CppCheck& cppcheck, int /*argc*/, const cha
         }
     }
 
+    // All results of the worker processes are merged at this point
+    if (!settings.showtimeOutput.empty()) {
+        std::ofstream fout(settings.showtimeOutput);
+        CppCheck::timerResults().writeJson(fout);
+    }
+
     if (settings.xml) {
         reportErr(ErrorMessage::getXMLFooter());
     }
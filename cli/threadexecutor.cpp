@@ -25,6 +25,7 @@
 #include "importproject.h"
 #include "settings.h"
 #include "suppressions.h"
+#include "timer.h"
 
 #include <algorithm>
 #include <cerrno>
@@ -96,7 +97,7 @@ int ThreadExecutor::handleRead(int rpipe, unsigned int &result)
         return -1;
     }
 
-    if (type != REPORT_OUT && type != REPORT_ERROR && type != REPORT_INFO && type != CHILD_END) {
+    if (type != REPORT_OUT && type != REPORT_ERROR && type != REPORT_INFO && type != REPORT_TIMER && type != CHILD_END) {
         std::cerr << "#### ThreadExecutor::handleRead error, type was:" << type << std::endl;
         std::exit(EXIT_FAILURE);
     }
@@ -110,7 +111,21 @@ int ThreadExecutor::handleRead(int rpipe, unsigned int &result)
     // Don't rely on incoming data being null-terminated.
     // Allocate +1 element and null-terminate the buffer.
     char *buf = new char[len + 1];
-    const ssize_t readIntoBuf = read(rpipe, buf, len);
+    ssize_t readIntoBuf = 0;
+    // Large messages (timer results) are not written into the pipe at once
+    while (readIntoBuf < static_cast<ssize_t>(len)) {
+        const ssize_t r = read(rpipe, buf + readIntoBuf, len - readIntoBuf);
+        if (r > 0) {
+            readIntoBuf += r;
+        } else if (r < 0 && errno == EAGAIN) {
+            fd_set rfds;
+            FD_ZERO(&rfds);
+            FD_SET(rpipe, &rfds);
+            select(rpipe + 1, &rfds, nullptr, nullptr, nullptr);
+        } else {
+            break;
+        }
+    }
     if (readIntoBuf <= 0) {
         std::cerr << "#### ThreadExecutor::handleRead error, type was:" << type << std::endl;
         std::exit(EXIT_FAILURE);
@@ -139,6 +154,9 @@ int ThreadExecutor::handleRead(int rpipe, unsigned int &result)
                     mErrorLogger.reportInfo(msg);
             }
         }
+    } else if (type == REPORT_TIMER) {
+        if (!CppCheck::timerResults().merge(buf))
+            std::cerr << "#### ThreadExecutor::handleRead error, invalid timer results" << std::endl;
     } else if (type == CHILD_END) {
         std::istringstream iss(buf);
         unsigned int fileResult = 0;
@@ -225,6 +243,9 @@ unsigned int ThreadExecutor::check()
                 fileChecker.settings() = mSettings;
                 unsigned int resultOfCheck = 0;
 
+                // Only the results of this child are sent to the parent
+                CppCheck::timerResults().clear();
+
                 if (iFileSettings != mSettings.project.fileSettings.end()) {
                     resultOfCheck = fileChecker.check(*iFileSettings);
                 } else if (!mFileContents.empty() && mFileContents.find(iFile->first) != mFileContents.end()) {
@@ -235,6 +256,9 @@ unsigned int ThreadExecutor::check()
                     resultOfCheck = fileChecker.check(iFile->first);
                 }
 
+                if (mSettings.showtime != SHOWTIME_MODES::SHOWTIME_NONE)
+                    writeToPipe(REPORT_TIMER, CppCheck::timerResults().serialize());
+
                 std::ostringstream oss;
                 oss << resultOfCheck;
                 writeToPipe(CHILD_END, oss.str());
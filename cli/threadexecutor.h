@@ -78,7 +78,7 @@ private:
     /** @brief Key is file name, and value is the content of the file */
     std::map<std::string, std::string> mFileContents;
 private:
-    enum PipeSignal {REPORT_OUT='1',REPORT_ERROR='2', REPORT_INFO='3', REPORT_VERIFICATION='4', CHILD_END='5'};
+    enum PipeSignal {REPORT_OUT='1',REPORT_ERROR='2', REPORT_INFO='3', REPORT_VERIFICATION='4', CHILD_END='5', REPORT_TIMER='6'};
 
     /**
      * Read from the pipe, parse and handle what ever is in there.
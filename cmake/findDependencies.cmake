@@ -14,6 +14,9 @@ if (BUILD_GUI)
     endif()
 endif()
 
+# the whole program analysis runs the checks in threads
+find_package(Threads REQUIRED)
+
 if (HAVE_RULES)
     find_path(PCRE_INCLUDE pcre.h)
     find_library(PCRE_LIBRARY pcre)
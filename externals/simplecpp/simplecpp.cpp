@@ -24,22 +24,34 @@
 
 #include <algorithm>
 #include <climits>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <ctime>
 #include <exception>
-#include <fstream>
 #include <iostream>
 #include <limits>
+#include <map>
 #include <sstream>
 #include <stack>
 #include <stdexcept>
 #include <utility>
+#if __cplusplus >= 201103L
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#endif
 
 #ifdef SIMPLECPP_WINDOWS
 #include <windows.h>
 #undef ERROR
 #undef TRUE
+#else
+#include <dirent.h>
+#include <pthread.h>
 #endif
+#include <sys/stat.h>
 
 static bool isHex(const std::string &s)
 {
@@ -207,6 +219,599 @@ void simplecpp::Token::printOut() const
     std::cout << std::endl;
 }
 
+#if __cplusplus >= 201103L
+namespace {
+    struct FreeBlock {
+        FreeBlock *next;
+        /** only used in the shared list of the pool */
+        FreeBlock *prev;
+    };
+
+    /**
+     * Memory for the tokens. The memory is allocated in chunks that hold many
+     * tokens so consecutive tokens are close to each other and there is no
+     * allocation overhead per token. When all tokens of a chunk have been
+     * deleted the chunk is freed, except for a few spare chunks.
+     */
+    class TokenPool {
+    public:
+        static const std::size_t tokensPerChunk = 1024;
+        /** number of blocks that are moved between the shared list and a thread cache */
+        static const std::size_t batchSize = 256;
+        /** number of unused chunks that are kept */
+        static const std::size_t spareChunks = 2;
+
+        TokenPool() : mUnusedChunks(0) {
+            mFree.next = mFree.prev = &mFree;
+        }
+
+        /** take a list of at most batchSize free blocks */
+        FreeBlock *take(std::size_t &count) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mFree.next == &mFree)
+                addChunk();
+            FreeBlock *first = NULL;
+            FreeBlock *last = NULL;
+            count = 0;
+            while (count < batchSize && mFree.next != &mFree) {
+                FreeBlock * const block = mFree.next;
+                unlink(block);
+                if (chunkOf(block)->second-- == tokensPerChunk)
+                    --mUnusedChunks;
+                block->next = NULL;
+                if (last)
+                    last->next = block;
+                else
+                    first = block;
+                last = block;
+                ++count;
+            }
+            return first;
+        }
+
+        /** give back the free blocks first..last */
+        void give(FreeBlock *first, FreeBlock *last) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (FreeBlock *block = first;;) {
+                FreeBlock * const next = (block == last) ? NULL : block->next;
+                link(block);
+                const Chunks::iterator chunk = chunkOf(block);
+                if (++chunk->second == tokensPerChunk && ++mUnusedChunks > spareChunks)
+                    releaseChunk(chunk);
+                if (!next)
+                    break;
+                block = next;
+            }
+        }
+
+    private:
+        /** start of the chunk memory => number of blocks in the free list */
+        typedef std::map<const char *, std::size_t> Chunks;
+
+        void link(FreeBlock *block) {
+            block->next = mFree.next;
+            block->prev = &mFree;
+            mFree.next->prev = block;
+            mFree.next = block;
+        }
+
+        static void unlink(FreeBlock *block) {
+            block->prev->next = block->next;
+            block->next->prev = block->prev;
+        }
+
+        Chunks::iterator chunkOf(const FreeBlock *block) {
+            Chunks::iterator it = mChunks.upper_bound(reinterpret_cast<const char *>(block));
+            return --it;
+        }
+
+        void addChunk() {
+            char * const chunk = static_cast<char *>(::operator new(sizeof(simplecpp::Token) * tokensPerChunk));
+            mChunks[chunk] = tokensPerChunk;
+            ++mUnusedChunks;
+            for (std::size_t i = 0; i < tokensPerChunk; ++i)
+                link(reinterpret_cast<FreeBlock *>(chunk + i * sizeof(simplecpp::Token)));
+        }
+
+        /** all blocks of the chunk are in the free list */
+        void releaseChunk(Chunks::iterator chunk) {
+            char * const memory = const_cast<char *>(chunk->first);
+            for (std::size_t i = 0; i < tokensPerChunk; ++i)
+                unlink(reinterpret_cast<FreeBlock *>(memory + i * sizeof(simplecpp::Token)));
+            mChunks.erase(chunk);
+            --mUnusedChunks;
+            ::operator delete(memory);
+        }
+
+        std::mutex mMutex;
+        Chunks mChunks;
+        /** list of free blocks, mFree is the head */
+        FreeBlock mFree;
+        std::size_t mUnusedChunks;
+    };
+
+    /** The pool is never destroyed, tokens might be deleted during static destruction */
+    TokenPool &tokenPool()
+    {
+        static TokenPool * const pool = new TokenPool;
+        return *pool;
+    }
+
+    /** Free blocks of a thread, so most allocations don't need to lock the pool */
+    struct TokenCache {
+        FreeBlock *free;
+        std::size_t count;
+        /** the thread is exiting, blocks are given directly to the pool */
+        bool closed;
+    };
+
+    thread_local TokenCache tokenCache;
+
+    /** Gives the free blocks of a thread back to the pool when the thread exits */
+    class TokenCacheCleanup {
+    public:
+        TokenCacheCleanup() {}
+        ~TokenCacheCleanup() {
+            tokenCache.closed = true;
+            if (!tokenCache.free)
+                return;
+            FreeBlock *last = tokenCache.free;
+            while (last->next)
+                last = last->next;
+            tokenPool().give(tokenCache.free, last);
+            tokenCache.free = NULL;
+            tokenCache.count = 0;
+        }
+        void use() {}
+    };
+
+    thread_local TokenCacheCleanup tokenCacheCleanup;
+}
+
+void *simplecpp::Token::operator new(std::size_t size)
+{
+    if (size != sizeof(Token))
+        return ::operator new(size);
+    TokenCache &cache = tokenCache;
+    if (!cache.free) {
+        if (cache.closed) {
+            std::size_t count;
+            FreeBlock * const block = tokenPool().take(count);
+            if (block->next) {
+                FreeBlock *last = block->next;
+                while (last->next)
+                    last = last->next;
+                tokenPool().give(block->next, last);
+            }
+            return block;
+        }
+        tokenCacheCleanup.use();
+        cache.free = tokenPool().take(cache.count);
+    }
+    FreeBlock * const block = cache.free;
+    cache.free = block->next;
+    --cache.count;
+    return block;
+}
+
+void simplecpp::Token::operator delete(void *p)
+{
+    if (!p)
+        return;
+    FreeBlock * const block = static_cast<FreeBlock *>(p);
+    TokenCache &cache = tokenCache;
+    if (cache.closed) {
+        tokenPool().give(block, block);
+        return;
+    }
+    block->next = cache.free;
+    cache.free = block;
+    if (++cache.count < 2U * TokenPool::batchSize)
+        return;
+    // give a batch back to the pool, tokens might be deleted by another thread than they were created in
+    FreeBlock *last = cache.free;
+    for (std::size_t i = 1U; i < TokenPool::batchSize; ++i)
+        last = last->next;
+    FreeBlock * const first = cache.free;
+    cache.free = last->next;
+    cache.count -= TokenPool::batchSize;
+    tokenPool().give(first, last);
+}
+#else
+void *simplecpp::Token::operator new(std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void simplecpp::Token::operator delete(void *p)
+{
+    ::operator delete(p);
+}
+#endif
+
+/**
+ * Characters of a file that has been read into memory. The interface
+ * behaves like the std::istream functions that were used before, so the
+ * end of file is handled the same way.
+ */
+class simplecpp::TokenList::Stream {
+public:
+    Stream(const unsigned char *data, std::size_t size) : mBegin(data), mPos(data), mEnd(data + size), mEof(false), mFail(false) {}
+
+    int get() {
+        if (!good() || mPos == mEnd) {
+            mEof = mEof || mPos == mEnd;
+            mFail = true;
+            return EOF;
+        }
+        return *mPos++;
+    }
+
+    int peek() {
+        if (!good()) {
+            mFail = true;
+            return EOF;
+        }
+        if (mPos == mEnd) {
+            mEof = true;
+            return EOF;
+        }
+        return *mPos;
+    }
+
+    void unget() {
+        mEof = false;
+        if (mFail || mPos == mBegin)
+            mFail = true;
+        else
+            --mPos;
+    }
+
+    bool good() const {
+        return !mEof && !mFail;
+    }
+
+    unsigned char readChar(unsigned int bom) {
+        unsigned char ch = (unsigned char)get();
+
+        // For UTF-16 encoded files the BOM is 0xfeff/0xfffe. If the
+        // character is non-ASCII character then replace it with 0xff
+        if (bom == 0xfeff || bom == 0xfffe) {
+            const unsigned char ch2 = (unsigned char)get();
+            const int ch16 = (bom == 0xfeff) ? (ch<<8 | ch2) : (ch2<<8 | ch);
+            ch = (unsigned char)((ch16 >= 0x80) ? 0xff : ch16);
+        }
+
+        // Handling of newlines..
+        if (ch == '\r') {
+            ch = '\n';
+            if (bom == 0 && (char)peek() == '\n')
+                (void)get();
+            else if (bom == 0xfeff || bom == 0xfffe) {
+                int c1 = get();
+                int c2 = get();
+                int ch16 = (bom == 0xfeff) ? (c1<<8 | c2) : (c2<<8 | c1);
+                if (ch16 != '\n') {
+                    unget();
+                    unget();
+                }
+            }
+        }
+
+        return ch;
+    }
+
+    unsigned char peekChar(unsigned int bom) {
+        unsigned char ch = (unsigned char)peek();
+
+        // For UTF-16 encoded files the BOM is 0xfeff/0xfffe. If the
+        // character is non-ASCII character then replace it with 0xff
+        if (bom == 0xfeff || bom == 0xfffe) {
+            (void)get();
+            const unsigned char ch2 = (unsigned char)peek();
+            unget();
+            const int ch16 = (bom == 0xfeff) ? (ch<<8 | ch2) : (ch2<<8 | ch);
+            ch = (unsigned char)((ch16 >= 0x80) ? 0xff : ch16);
+        }
+
+        // Handling of newlines..
+        if (ch == '\r')
+            ch = '\n';
+
+        return ch;
+    }
+
+    void ungetChar(unsigned int bom) {
+        unget();
+        if (bom == 0xfeff || bom == 0xfffe)
+            unget();
+    }
+
+    unsigned short getAndSkipBOM() {
+        const int ch1 = peek();
+
+        // The UTF-16 BOM is 0xfffe or 0xfeff.
+        if (ch1 >= 0xfe) {
+            unsigned short bom = ((unsigned char)get() << 8);
+            if (peek() >= 0xfe)
+                return bom | (unsigned char)get();
+            unget();
+            return 0;
+        }
+
+        // Skip UTF-8 BOM 0xefbbbf
+        if (ch1 == 0xef) {
+            (void)get();
+            if (get() == 0xbb && peek() == 0xbf) {
+                (void)get();
+            } else {
+                unget();
+                unget();
+            }
+        }
+
+        return 0;
+    }
+
+private:
+    const unsigned char * const mBegin;
+    const unsigned char *mPos;
+    const unsigned char * const mEnd;
+    bool mEof;
+    bool mFail;
+};
+
+namespace {
+    /** Size and modification time of a file */
+    struct FileStat {
+        long long size;
+        long long mtime;
+    };
+}
+
+static bool getFileStat(const std::string &path, FileStat &st)
+{
+#ifdef SIMPLECPP_WINDOWS
+    struct _stat64 file_stat;
+    if (_stat64(path.c_str(), &file_stat) != 0)
+        return false;
+#else
+    struct stat file_stat;
+    if (stat(path.c_str(), &file_stat) != 0)
+        return false;
+#endif
+    st.size = file_stat.st_size;
+    st.mtime = file_stat.st_mtime;
+    return true;
+}
+
+/** Read the whole file, the size is a hint so it can normally be read with a single read */
+static bool readFileContents(const std::string &path, std::size_t size, std::string &data)
+{
+    std::FILE * const f = std::fopen(path.c_str(), "rb");
+    if (!f)
+        return false;
+    data.resize(size);
+    std::size_t len = size ? std::fread(&data[0], 1, size, f) : 0;
+    if (len == size) {
+        // the file is larger than expected
+        char buf[4096];
+        std::size_t n;
+        while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0) {
+            data.append(buf, n);
+            len += n;
+        }
+    }
+    data.resize(len);
+    std::fclose(f);
+    return true;
+}
+
+/** FNV-1a hash of the file contents */
+static unsigned long long hashContents(const std::string &data)
+{
+    unsigned long long h = 14695981039346656037ULL;
+    for (std::string::const_iterator it = data.begin(); it != data.end(); ++it) {
+        h ^= static_cast<unsigned char>(*it);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+/** Read the whole file, the status is taken from the contents that were read */
+static bool readFile(const std::string &path, std::string &data, simplecpp::FileStatus &status)
+{
+    FileStat st;
+    if (!getFileStat(path, st) || !readFileContents(path, st.size, data))
+        return false;
+    status.size = static_cast<long long>(data.size());
+    status.mtime = st.mtime;
+    status.hash = hashContents(data);
+    return true;
+}
+
+#if __cplusplus >= 201103L
+namespace {
+    /**
+     * Contents of the files that have been read by this process, so the
+     * headers are read once even if many source files include them. The
+     * size and modification time tell if a file has changed since it was
+     * read. The modification time has a coarse resolution, a file that was
+     * modified in the same second as it was read is read again. The least
+     * recently used files are dropped when the cache is full.
+     */
+    class FileBufferCache {
+    public:
+        FileBufferCache() : mBytes(0), mHits(0), mMisses(0) {}
+
+        /** Returns NULL if the file can't be read */
+        std::shared_ptr<const std::string> get(const std::string &path, simplecpp::FileStatus &status) {
+            FileStat st;
+            if (!getFileStat(path, st))
+                return std::shared_ptr<const std::string>();
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                const std::unordered_map<std::string, Entry>::iterator it = mFiles.find(path);
+                if (it != mFiles.end() && it->second.stat.size == st.size && it->second.stat.mtime == st.mtime && st.mtime < it->second.readTime) {
+                    ++mHits;
+                    mLru.splice(mLru.begin(), mLru, it->second.lru);
+                    status = it->second.status;
+                    return it->second.data;
+                }
+                ++mMisses;
+            }
+
+            const std::time_t readTime = std::time(NULL);
+            const std::shared_ptr<std::string> data = std::make_shared<std::string>();
+            if (!readFileContents(path, st.size, *data))
+                return std::shared_ptr<const std::string>();
+            status.size = static_cast<long long>(data->size());
+            status.mtime = st.mtime;
+            status.hash = hashContents(*data);
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            const std::unordered_map<std::string, Entry>::iterator it = mFiles.find(path);
+            if (it != mFiles.end())
+                erase(it);
+            if (data->size() > maxBytes)
+                return data;
+            while (mBytes + data->size() > maxBytes)
+                erase(mFiles.find(mLru.back()));
+            mLru.push_front(path);
+            Entry &entry = mFiles[path];
+            entry.data = data;
+            entry.stat = st;
+            entry.status = status;
+            entry.readTime = readTime;
+            entry.lru = mLru.begin();
+            mBytes += data->size();
+            return data;
+        }
+
+        simplecpp::FileBufferStats stats() {
+            std::lock_guard<std::mutex> lock(mMutex);
+            simplecpp::FileBufferStats ret;
+            ret.hits = mHits;
+            ret.misses = mMisses;
+            return ret;
+        }
+
+    private:
+        /** the cache is not filled beyond this size */
+        static const std::size_t maxBytes = 256U * 1024U * 1024U;
+
+        struct Entry {
+            std::shared_ptr<const std::string> data;
+            FileStat stat;
+            simplecpp::FileStatus status;
+            /** when the file was read */
+            std::time_t readTime;
+            /** position in \ref mLru */
+            std::list<std::string>::iterator lru;
+        };
+
+        void erase(std::unordered_map<std::string, Entry>::iterator it) {
+            mBytes -= it->second.data->size();
+            mLru.erase(it->second.lru);
+            mFiles.erase(it);
+        }
+
+        std::mutex mMutex;
+        std::unordered_map<std::string, Entry> mFiles;
+        /** paths of the cached files, the most recently used first */
+        std::list<std::string> mLru;
+        std::size_t mBytes;
+        unsigned long long mHits;
+        unsigned long long mMisses;
+    };
+
+    /** The cache is never destroyed, files might be read during static destruction */
+    FileBufferCache &fileBufferCache()
+    {
+        static FileBufferCache * const cache = new FileBufferCache;
+        return *cache;
+    }
+}
+#endif
+
+namespace {
+    /**
+     * Contents of a file. Files are opened like a std::ifstream. Headers
+     * are read through the file buffer cache, source files are read once
+     * and are not cached.
+     */
+    class FileData {
+    public:
+#if __cplusplus >= 201103L
+        void open(const std::string &path, bool cache = true) {
+            mStatus = simplecpp::FileStatus();
+            if (cache) {
+                mData = fileBufferCache().get(path, mStatus);
+                return;
+            }
+            const std::shared_ptr<std::string> data = std::make_shared<std::string>();
+            if (readFile(path, *data, mStatus))
+                mData = data;
+            else
+                mData.reset();
+        }
+        bool is_open() const {
+            return !!mData;
+        }
+        const unsigned char *data() const {
+            return mData ? reinterpret_cast<const unsigned char *>(mData->data()) : NULL;
+        }
+        std::size_t size() const {
+            return mData ? mData->size() : 0;
+        }
+        const simplecpp::FileStatus &status() const {
+            return mStatus;
+        }
+
+    private:
+        std::shared_ptr<const std::string> mData;
+#else
+        FileData() : mOpen(false) {}
+        void open(const std::string &path, bool /*cache*/ = true) {
+            mStatus = simplecpp::FileStatus();
+            mOpen = readFile(path, mData, mStatus);
+        }
+        bool is_open() const {
+            return mOpen;
+        }
+        const unsigned char *data() const {
+            return reinterpret_cast<const unsigned char *>(mData.data());
+        }
+        std::size_t size() const {
+            return mData.size();
+        }
+        const simplecpp::FileStatus &status() const {
+            return mStatus;
+        }
+
+    private:
+        std::string mData;
+        bool mOpen;
+#endif
+        simplecpp::FileStatus mStatus;
+    };
+}
+
+simplecpp::FileBufferStats simplecpp::getFileBufferStats()
+{
+#if __cplusplus >= 201103L
+    return fileBufferCache().stats();
+#else
+    return FileBufferStats();
+#endif
+}
+
+bool simplecpp::getFileStatus(const std::string &path, FileStatus &status)
+{
+    std::string data;
+    return readFile(path, data, status);
+}
+
 simplecpp::TokenList::TokenList(std::vector<std::string> &filenames) : frontToken(NULL), backToken(NULL), files(filenames) {}
 
 simplecpp::TokenList::TokenList(std::istream &istr, std::vector<std::string> &filenames, const std::string &filename, OutputList *outputList)
@@ -215,6 +820,24 @@ simplecpp::TokenList::TokenList(std::istream &istr, std::vector<std::string> &fi
     readfile(istr,filename,outputList);
 }
 
+simplecpp::TokenList::TokenList(const unsigned char *data, std::size_t size, std::vector<std::string> &filenames, const std::string &filename, OutputList *outputList)
+    : frontToken(NULL), backToken(NULL), files(filenames)
+{
+    Stream stream(data, size);
+    readfile(stream,filename,outputList);
+}
+
+simplecpp::TokenList::TokenList(const std::string &filename, std::vector<std::string> &filenames, OutputList *outputList)
+    : frontToken(NULL), backToken(NULL), files(filenames)
+{
+    FileData f;
+    f.open(filename, false);
+    Stream stream(f.data(), f.size());
+    readfile(stream,filename,outputList);
+    if (f.is_open())
+        fileStatus = f.status();
+}
+
 simplecpp::TokenList::TokenList(const TokenList &other) : frontToken(NULL), backToken(NULL), files(other.files)
 {
     *this = other;
@@ -239,6 +862,7 @@ simplecpp::TokenList &simplecpp::TokenList::operator=(const TokenList &other)
         for (const Token *tok = other.cfront(); tok; tok = tok->next)
             push_back(new Token(*tok));
         sizeOfType = other.sizeOfType;
+        fileStatus = other.fileStatus;
     }
     return *this;
 }
@@ -253,6 +877,7 @@ simplecpp::TokenList &simplecpp::TokenList::operator=(TokenList &&other)
         frontToken = other.frontToken;
         other.frontToken = NULL;
         sizeOfType = std::move(other.sizeOfType);
+        fileStatus = other.fileStatus;
     }
     return *this;
 }
@@ -310,92 +935,6 @@ std::string simplecpp::TokenList::stringify() const
     return ret.str();
 }
 
-static unsigned char readChar(std::istream &istr, unsigned int bom)
-{
-    unsigned char ch = (unsigned char)istr.get();
-
-    // For UTF-16 encoded files the BOM is 0xfeff/0xfffe. If the
-    // character is non-ASCII character then replace it with 0xff
-    if (bom == 0xfeff || bom == 0xfffe) {
-        const unsigned char ch2 = (unsigned char)istr.get();
-        const int ch16 = (bom == 0xfeff) ? (ch<<8 | ch2) : (ch2<<8 | ch);
-        ch = (unsigned char)((ch16 >= 0x80) ? 0xff : ch16);
-    }
-
-    // Handling of newlines..
-    if (ch == '\r') {
-        ch = '\n';
-        if (bom == 0 && (char)istr.peek() == '\n')
-            (void)istr.get();
-        else if (bom == 0xfeff || bom == 0xfffe) {
-            int c1 = istr.get();
-            int c2 = istr.get();
-            int ch16 = (bom == 0xfeff) ? (c1<<8 | c2) : (c2<<8 | c1);
-            if (ch16 != '\n') {
-                istr.unget();
-                istr.unget();
-            }
-        }
-    }
-
-    return ch;
-}
-
-static unsigned char peekChar(std::istream &istr, unsigned int bom)
-{
-    unsigned char ch = (unsigned char)istr.peek();
-
-    // For UTF-16 encoded files the BOM is 0xfeff/0xfffe. If the
-    // character is non-ASCII character then replace it with 0xff
-    if (bom == 0xfeff || bom == 0xfffe) {
-        (void)istr.get();
-        const unsigned char ch2 = (unsigned char)istr.peek();
-        istr.unget();
-        const int ch16 = (bom == 0xfeff) ? (ch<<8 | ch2) : (ch2<<8 | ch);
-        ch = (unsigned char)((ch16 >= 0x80) ? 0xff : ch16);
-    }
-
-    // Handling of newlines..
-    if (ch == '\r')
-        ch = '\n';
-
-    return ch;
-}
-
-static void ungetChar(std::istream &istr, unsigned int bom)
-{
-    istr.unget();
-    if (bom == 0xfeff || bom == 0xfffe)
-        istr.unget();
-}
-
-static unsigned short getAndSkipBOM(std::istream &istr)
-{
-    const int ch1 = istr.peek();
-
-    // The UTF-16 BOM is 0xfffe or 0xfeff.
-    if (ch1 >= 0xfe) {
-        unsigned short bom = ((unsigned char)istr.get() << 8);
-        if (istr.peek() >= 0xfe)
-            return bom | (unsigned char)istr.get();
-        istr.unget();
-        return 0;
-    }
-
-    // Skip UTF-8 BOM 0xefbbbf
-    if (ch1 == 0xef) {
-        (void)istr.get();
-        if (istr.get() == 0xbb && istr.peek() == 0xbf) {
-            (void)istr.get();
-        } else {
-            istr.unget();
-            istr.unget();
-        }
-    }
-
-    return 0;
-}
-
 static bool isNameChar(unsigned char ch)
 {
     return std::isalnum(ch) || ch == '_' || ch == '$';
@@ -450,6 +989,16 @@ void simplecpp::TokenList::lineDirective(unsigned int fileIndex, unsigned int li
 }
 
 void simplecpp::TokenList::readfile(std::istream &istr, const std::string &filename, OutputList *outputList)
+{
+    std::string data;
+    char buf[4096];
+    while (istr.read(buf, sizeof(buf)) || istr.gcount() > 0)
+        data.append(buf, istr.gcount());
+    Stream stream(reinterpret_cast<const unsigned char *>(data.data()), data.size());
+    readfile(stream,filename,outputList);
+}
+
+void simplecpp::TokenList::readfile(Stream &stream, const std::string &filename, OutputList *outputList)
 {
     std::stack<simplecpp::Location> loc;
 
@@ -457,15 +1006,15 @@ void simplecpp::TokenList::readfile(std::istream &istr, const std::string &filen
 
     const Token *oldLastToken = NULL;
 
-    const unsigned short bom = getAndSkipBOM(istr);
+    const unsigned short bom = stream.getAndSkipBOM();
 
     Location location(files);
     location.fileIndex = fileIndex(filename);
     location.line = 1U;
     location.col  = 1U;
-    while (istr.good()) {
-        unsigned char ch = readChar(istr,bom);
-        if (!istr.good())
+    while (stream.good()) {
+        unsigned char ch = stream.readChar(bom);
+        if (!stream.good())
             break;
         if (ch < ' ' && ch != '\t' && ch != '\n' && ch != '\r')
             ch = ' ';
@@ -541,12 +1090,12 @@ void simplecpp::TokenList::readfile(std::istream &istr, const std::string &filen
 
         if (cback() && cback()->location.line == location.line && cback()->previous && cback()->previous->op == '#' && (lastLine() == "# error" || lastLine() == "# warning")) {
             char prev = ' ';
-            while (istr.good() && (prev == '\\' || (ch != '\r' && ch != '\n'))) {
+            while (stream.good() && (prev == '\\' || (ch != '\r' && ch != '\n'))) {
                 currentToken += ch;
                 prev = ch;
-                ch = readChar(istr, bom);
+                ch = stream.readChar(bom);
             }
-            ungetChar(istr, bom);
+            stream.ungetChar(bom);
             push_back(new Token(currentToken, location));
             location.adjust(currentToken);
             continue;
@@ -555,21 +1104,21 @@ void simplecpp::TokenList::readfile(std::istream &istr, const std::string &filen
         // number or name
         if (isNameChar(ch)) {
             const bool num = std::isdigit(ch);
-            while (istr.good() && isNameChar(ch)) {
+            while (stream.good() && isNameChar(ch)) {
                 currentToken += ch;
-                ch = readChar(istr,bom);
-                if (num && ch=='\'' && isNameChar(peekChar(istr,bom)))
-                    ch = readChar(istr,bom);
+                ch = stream.readChar(bom);
+                if (num && ch=='\'' && isNameChar(stream.peekChar(bom)))
+                    ch = stream.readChar(bom);
             }
 
-            ungetChar(istr,bom);
+            stream.ungetChar(bom);
         }
 
         // comment
-        else if (ch == '/' && peekChar(istr,bom) == '/') {
-            while (istr.good() && ch != '\r' && ch != '\n') {
+        else if (ch == '/' && stream.peekChar(bom) == '/') {
+            while (stream.good() && ch != '\r' && ch != '\n') {
                 currentToken += ch;
-                ch = readChar(istr, bom);
+                ch = stream.readChar(bom);
             }
             const std::string::size_type pos = currentToken.find_last_not_of(" \t");
             if (pos < currentToken.size() - 1U && currentToken[pos] == '\\')
@@ -578,20 +1127,20 @@ void simplecpp::TokenList::readfile(std::istream &istr, const std::string &filen
                 ++multiline;
                 currentToken.erase(currentToken.size() - 1U);
             } else {
-                ungetChar(istr, bom);
+                stream.ungetChar(bom);
             }
         }
 
         // comment
-        else if (ch == '/' && peekChar(istr,bom) == '*') {
+        else if (ch == '/' && stream.peekChar(bom) == '*') {
             currentToken = "/*";
-            (void)readChar(istr,bom);
-            ch = readChar(istr,bom);
-            while (istr.good()) {
+            (void)stream.readChar(bom);
+            ch = stream.readChar(bom);
+            while (stream.good()) {
                 currentToken += ch;
                 if (currentToken.size() >= 4U && endsWith(currentToken, "*/"))
                     break;
-                ch = readChar(istr,bom);
+                ch = stream.readChar(bom);
             }
             // multiline..
 
@@ -622,12 +1171,12 @@ void simplecpp::TokenList::readfile(std::istream &istr, const std::string &filen
                 std::string delim;
                 currentToken = ch;
                 prefix.resize(prefix.size() - 1);
-                ch = readChar(istr,bom);
-                while (istr.good() && ch != '(' && ch != '\n') {
+                ch = stream.readChar(bom);
+                while (stream.good() && ch != '(' && ch != '\n') {
                     delim += ch;
-                    ch = readChar(istr,bom);
+                    ch = stream.readChar(bom);
                 }
-                if (!istr.good() || ch == '\n') {
+                if (!stream.good() || ch == '\n') {
                     if (outputList) {
                         Output err(files);
                         err.type = Output::SYNTAX_ERROR;
@@ -638,8 +1187,8 @@ void simplecpp::TokenList::readfile(std::istream &istr, const std::string &filen
                     return;
                 }
                 const std::string endOfRawString(')' + delim + currentToken);
-                while (istr.good() && !(endsWith(currentToken, endOfRawString) && currentToken.size() > 1))
-                    currentToken += readChar(istr,bom);
+                while (stream.good() && !(endsWith(currentToken, endOfRawString) && currentToken.size() > 1))
+                    currentToken += stream.readChar(bom);
                 if (!endsWith(currentToken, endOfRawString)) {
                     if (outputList) {
                         Output err(files);
@@ -663,7 +1212,7 @@ void simplecpp::TokenList::readfile(std::istream &istr, const std::string &filen
                 continue;
             }
 
-            currentToken = readUntil(istr,location,ch,ch,outputList,bom);
+            currentToken = readUntil(stream,location,ch,ch,outputList,bom);
             if (currentToken.size() < 2U)
                 // Error is reported by readUntil()
                 return;
@@ -695,7 +1244,7 @@ void simplecpp::TokenList::readfile(std::istream &istr, const std::string &filen
         }
 
         if (currentToken == "<" && lastLine() == "# include") {
-            currentToken = readUntil(istr, location, '<', '>', outputList, bom);
+            currentToken = readUntil(stream, location, '<', '>', outputList, bom);
             if (currentToken.size() < 2U)
                 return;
         }
@@ -1140,15 +1689,15 @@ void simplecpp::TokenList::removeComments()
     }
 }
 
-std::string simplecpp::TokenList::readUntil(std::istream &istr, const Location &location, const char start, const char end, OutputList *outputList, unsigned int bom)
+std::string simplecpp::TokenList::readUntil(Stream &stream, const Location &location, const char start, const char end, OutputList *outputList, unsigned int bom)
 {
     std::string ret;
     ret += start;
 
     bool backslash = false;
     char ch = 0;
-    while (ch != end && ch != '\r' && ch != '\n' && istr.good()) {
-        ch = readChar(istr, bom);
+    while (ch != end && ch != '\r' && ch != '\n' && stream.good()) {
+        ch = stream.readChar(bom);
         if (backslash && ch == '\n') {
             ch = 0;
             backslash = false;
@@ -1160,7 +1709,7 @@ std::string simplecpp::TokenList::readUntil(std::istream &istr, const Location &
             bool update_ch = false;
             char next = 0;
             do {
-                next = readChar(istr, bom);
+                next = stream.readChar(bom);
                 if (next == '\r' || next == '\n') {
                     ret.erase(ret.size()-1U);
                     backslash = (next == '\r');
@@ -1174,7 +1723,7 @@ std::string simplecpp::TokenList::readUntil(std::istream &istr, const Location &
         }
     }
 
-    if (!istr.good() || ch != end) {
+    if (!stream.good() || ch != end) {
         clear();
         if (outputList) {
             Output err(files);
@@ -1218,6 +1767,144 @@ unsigned int simplecpp::TokenList::fileIndex(const std::string &filename)
 
 
 namespace simplecpp {
+    class Macro;
+    struct HeaderRecorder;
+
+    static void recordMacroLookup(HeaderRecorder *recorder, const TokenString &name, const Macro *macro);
+    static void recordMacroUsage(HeaderRecorder *recorder, const TokenString &name, const Location &location);
+
+    /**
+     * Macros by name, looked up for every name token that is preprocessed.
+     * While an included file is preprocessed the lookups and macro usages
+     * are reported to its recorder, see PreprocessCache.
+     */
+    template<class M>
+    class BasicMacroMap {
+    public:
+#if __cplusplus >= 201103L
+        typedef std::unordered_map<TokenString, M> Map;
+#else
+        typedef std::map<TokenString, M> Map;
+#endif
+        typedef typename Map::iterator iterator;
+        typedef typename Map::const_iterator const_iterator;
+
+        BasicMacroMap() : recorder(NULL) {}
+
+        const_iterator find(const TokenString &name) const {
+            const const_iterator it = mMap.find(name);
+            if (recorder)
+                recordMacroLookup(recorder, name, it == mMap.end() ? NULL : &it->second);
+            return it;
+        }
+
+        iterator find(const TokenString &name) {
+            const iterator it = mMap.find(name);
+            if (recorder)
+                recordMacroLookup(recorder, name, it == mMap.end() ? NULL : &it->second);
+            return it;
+        }
+
+        /** find without reporting the lookup */
+        iterator peek(const TokenString &name) {
+            return mMap.find(name);
+        }
+
+        const_iterator peek(const TokenString &name) const {
+            return mMap.find(name);
+        }
+
+        const_iterator begin() const {
+            return mMap.begin();
+        }
+
+        const_iterator end() const {
+            return mMap.end();
+        }
+
+        iterator end() {
+            return mMap.end();
+        }
+
+        std::size_t size() const {
+            return mMap.size();
+        }
+
+        std::pair<iterator, bool> insert(const typename Map::value_type &value) {
+            return mMap.insert(value);
+        }
+
+        void erase(const TokenString &name) {
+            mMap.erase(name);
+        }
+
+        /** report that the macro was expanded */
+        void used(const TokenString &name, const Location &location) const {
+            if (recorder)
+                recordMacroUsage(recorder, name, location);
+        }
+
+        HeaderRecorder *recorder;
+
+    private:
+        Map mMap;
+    };
+
+    typedef BasicMacroMap<Macro> MacroMap;
+
+    /** Identifies a macro definition. Macros with the same id expand the same way. */
+    struct MacroId {
+        MacroId() : defineToken(NULL) {}
+        MacroId(const Token *defineToken_, const std::string &text_) : defineToken(defineToken_), text(text_) {}
+
+        bool operator==(const MacroId &other) const {
+            return defineToken == other.defineToken && text == other.text;
+        }
+
+        /** name token of a #define in the code */
+        const Token *defineToken;
+        /** definition of a macro that is not defined in the code */
+        std::string text;
+    };
+
+    /**
+     * Names of the macros that are being expanded (the "hide set"). A macro
+     * is not expanded again while its name is in the hide set. The set is a
+     * chain of nodes that live on the stack of the expanding functions so
+     * adding a name neither copies the set nor allocates memory.
+     */
+    class HideSet {
+    public:
+        HideSet() : mName(NULL), mParent(NULL), mSize(0) {}
+
+        /** the names in parent plus name. name must outlive the set. */
+        HideSet(const HideSet &parent, const TokenString &name) : mName(&name), mParent(&parent), mSize(parent.mSize + 1U) {
+            if (parent.contains(name)) {
+                mName = parent.mName;
+                mParent = parent.mParent;
+                mSize = parent.mSize;
+            }
+        }
+
+        bool contains(const TokenString &name) const {
+            for (const HideSet *set = this; set; set = set->mParent) {
+                if (set->mName && *set->mName == name)
+                    return true;
+            }
+            return false;
+        }
+
+        /** number of distinct names */
+        std::size_t size() const {
+            return mSize;
+        }
+
+    private:
+        const TokenString *mName;
+        const HideSet *mParent;
+        std::size_t mSize;
+    };
+
     class Macro {
     public:
         explicit Macro(std::vector<std::string> &f) : nameTokDef(NULL), variadic(false), valueToken(NULL), endToken(NULL), files(f), tokenListDefine(f), valueDefinedInCode_(false) {}
@@ -1277,9 +1964,11 @@ namespace simplecpp {
          */
         const Token * expand(TokenList * const output,
                              const Token * rawtok,
-                             const std::map<TokenString,Macro> &macros,
+                             const MacroMap &macros,
                              std::vector<std::string> &inputFiles) const {
-            std::set<TokenString> expandedmacros;
+            const HideSet noMacros;
+            const HideSet thisMacro(noMacros, name());
+            const HideSet *expandedmacros = &noMacros;
 
             TokenList output2(inputFiles);
 
@@ -1305,10 +1994,10 @@ namespace simplecpp {
                 bool first = true;
                 if (valueToken && valueToken->str() == rawtok1->str())
                     first = false;
-                if (expand(&output2, rawtok1->location, rawtokens2.cfront(), macros, expandedmacros, first))
+                if (expand(&output2, rawtok1->location, rawtokens2.cfront(), macros, *expandedmacros, first))
                     rawtok = rawtok1->next;
             } else {
-                rawtok = expand(&output2, rawtok->location, rawtok, macros, expandedmacros);
+                rawtok = expand(&output2, rawtok->location, rawtok, macros, *expandedmacros);
             }
             while (output2.cback() && rawtok) {
                 unsigned int par = 0;
@@ -1324,14 +2013,14 @@ namespace simplecpp {
                 }
                 if (macro2tok) { // macro2tok->op == '('
                     macro2tok = macro2tok->previous;
-                    expandedmacros.insert(name());
+                    expandedmacros = &thisMacro;
                 } else if (rawtok->op == '(')
                     macro2tok = output2.back();
                 if (!macro2tok || !macro2tok->name)
                     break;
                 if (output2.cfront() != output2.cback() && macro2tok->str() == this->name())
                     break;
-                const std::map<TokenString,Macro>::const_iterator macro = macros.find(macro2tok->str());
+                const MacroMap::const_iterator macro = macros.find(macro2tok->str());
                 if (macro == macros.end() || !macro->second.functionLike())
                     break;
                 TokenList rawtokens2(inputFiles);
@@ -1356,7 +2045,7 @@ namespace simplecpp {
                 }
                 if (!rawtok2 || par != 1U)
                     break;
-                if (macro->second.expand(&output2, rawtok->location, rawtokens2.cfront(), macros, expandedmacros) != NULL)
+                if (macro->second.expand(&output2, rawtok->location, rawtokens2.cfront(), macros, *expandedmacros) != NULL)
                     break;
                 rawtok = rawtok2->next;
             }
@@ -1379,6 +2068,20 @@ namespace simplecpp {
             return usageList;
         }
 
+        void addUsage(const Location &loc) const {
+            usageList.push_back(loc);
+        }
+
+        /** identity of the definition, the macro state is compared by id in the PreprocessCache */
+        MacroId id() const {
+            if (valueDefinedInCode_)
+                return MacroId(nameTokDef, std::string());
+            std::string text(functionLike() ? "(" : " ");
+            for (const Token *tok = tokenListDefine.cfront(); tok; tok = tok->next)
+                text += ' ' + tok->str();
+            return MacroId(NULL, text);
+        }
+
         /** is this a function like macro */
         bool functionLike() const {
             return nameTokDef->next &&
@@ -1494,8 +2197,8 @@ namespace simplecpp {
         const Token *appendTokens(TokenList *tokens,
                                   const Location &rawloc,
                                   const Token * const lpar,
-                                  const std::map<TokenString,Macro> &macros,
-                                  const std::set<TokenString> &expandedmacros,
+                                  const MacroMap &macros,
+                                  const HideSet &expandedmacros,
                                   const std::vector<const Token*> &parametertokens) const {
             if (!lpar || lpar->op != '(')
                 return NULL;
@@ -1510,8 +2213,8 @@ namespace simplecpp {
                 } else {
                     if (!expandArg(tokens, tok, rawloc, macros, expandedmacros, parametertokens)) {
                         bool expanded = false;
-                        const std::map<TokenString, Macro>::const_iterator it = macros.find(tok->str());
-                        if (it != macros.end() && expandedmacros.find(tok->str()) == expandedmacros.end()) {
+                        const MacroMap::const_iterator it = macros.find(tok->str());
+                        if (it != macros.end() && !expandedmacros.contains(tok->str())) {
                             const Macro &m = it->second;
                             if (!m.functionLike()) {
                                 m.expand(tokens, rawloc, tok, macros, expandedmacros);
@@ -1540,12 +2243,11 @@ namespace simplecpp {
             return sameline(lpar,tok) ? tok : NULL;
         }
 
-        const Token * expand(TokenList * const output, const Location &loc, const Token * const nameTokInst, const std::map<TokenString,Macro> &macros, std::set<TokenString> expandedmacros, bool first=false) const {
-
-            if (!first)
-                expandedmacros.insert(nameTokInst->str());
+        const Token * expand(TokenList * const output, const Location &loc, const Token * const nameTokInst, const MacroMap &macros, const HideSet &expandedmacros0, bool first=false) const {
+            const HideSet expandedmacros = first ? expandedmacros0 : HideSet(expandedmacros0, nameTokInst->str());
 
             usageList.push_back(loc);
+            macros.used(name(), loc);
 
             if (nameTokInst->str() == "__FILE__") {
                 output->push_back(new Token('\"'+loc.file()+'\"', loc));
@@ -1595,7 +2297,7 @@ namespace simplecpp {
                     }
                 }
 
-                const std::map<TokenString,Macro>::const_iterator m = macros.find("__COUNTER__");
+                const MacroMap::const_iterator m = counter ? macros.find("__COUNTER__") : macros.end();
 
                 if (!counter || m == macros.end())
                     parametertokens2.swap(parametertokens1);
@@ -1686,7 +2388,7 @@ namespace simplecpp {
             return functionLike() ? parametertokens2.back()->next : nameTokInst->next;
         }
 
-        const Token *recursiveExpandToken(TokenList *output, TokenList &temp, const Location &loc, const Token *tok, const std::map<TokenString,Macro> &macros, const std::set<TokenString> &expandedmacros, const std::vector<const Token*> &parametertokens) const {
+        const Token *recursiveExpandToken(TokenList *output, TokenList &temp, const Location &loc, const Token *tok, const MacroMap &macros, const HideSet &expandedmacros, const std::vector<const Token*> &parametertokens) const {
             if (!(temp.cback() && temp.cback()->name && tok->next && tok->next->op == '(')) {
                 output->takeTokens(temp);
                 return tok->next;
@@ -1697,8 +2399,8 @@ namespace simplecpp {
                 return tok->next;
             }
 
-            const std::map<TokenString, Macro>::const_iterator it = macros.find(temp.cback()->str());
-            if (it == macros.end() || expandedmacros.find(temp.cback()->str()) != expandedmacros.end()) {
+            const MacroMap::const_iterator it = macros.find(temp.cback()->str());
+            if (it == macros.end() || expandedmacros.contains(temp.cback()->str())) {
                 output->takeTokens(temp);
                 return tok->next;
             }
@@ -1721,7 +2423,7 @@ namespace simplecpp {
             return tok2->next;
         }
 
-        const Token *expandToken(TokenList *output, const Location &loc, const Token *tok, const std::map<TokenString,Macro> &macros, const std::set<TokenString> &expandedmacros, const std::vector<const Token*> &parametertokens) const {
+        const Token *expandToken(TokenList *output, const Location &loc, const Token *tok, const MacroMap &macros, const HideSet &expandedmacros, const std::vector<const Token*> &parametertokens) const {
             // Not name..
             if (!tok->name) {
                 output->push_back(newMacroToken(tok->str(), loc, true, tok));
@@ -1736,10 +2438,9 @@ namespace simplecpp {
             }
 
             // Macro..
-            const std::map<TokenString, Macro>::const_iterator it = macros.find(tok->str());
-            if (it != macros.end() && expandedmacros.find(tok->str()) == expandedmacros.end()) {
-                std::set<std::string> expandedmacros2(expandedmacros);
-                expandedmacros2.insert(tok->str());
+            const MacroMap::const_iterator it = macros.find(tok->str());
+            if (it != macros.end() && !expandedmacros.contains(tok->str())) {
+                const HideSet expandedmacros2(expandedmacros, tok->str());
 
                 const Macro &calledMacro = it->second;
                 if (!calledMacro.functionLike()) {
@@ -1815,7 +2516,7 @@ namespace simplecpp {
             return true;
         }
 
-        bool expandArg(TokenList *output, const Token *tok, const Location &loc, const std::map<TokenString, Macro> &macros, const std::set<TokenString> &expandedmacros, const std::vector<const Token*> &parametertokens) const {
+        bool expandArg(TokenList *output, const Token *tok, const Location &loc, const MacroMap &macros, const HideSet &expandedmacros, const std::vector<const Token*> &parametertokens) const {
             if (!tok->name)
                 return false;
             const unsigned int argnr = getArgNum(tok->str());
@@ -1824,8 +2525,8 @@ namespace simplecpp {
             if (variadic && argnr + 1U >= parametertokens.size()) // empty variadic parameter
                 return true;
             for (const Token *partok = parametertokens[argnr]->next; partok != parametertokens[argnr + 1U];) {
-                const std::map<TokenString, Macro>::const_iterator it = macros.find(partok->str());
-                if (it != macros.end() && !partok->isExpandedFrom(&it->second) && (partok->str() == name() || expandedmacros.find(partok->str()) == expandedmacros.end()))
+                const MacroMap::const_iterator it = macros.find(partok->str());
+                if (it != macros.end() && !partok->isExpandedFrom(&it->second) && (partok->str() == name() || !expandedmacros.contains(partok->str())))
                     partok = it->second.expand(output, loc, partok, macros, expandedmacros);
                 else {
                     output->push_back(newMacroToken(partok->str(), loc, isReplaced(expandedmacros), partok));
@@ -1846,7 +2547,7 @@ namespace simplecpp {
          * @param parametertokens  parameters given when expanding this macro
          * @return token after the X
          */
-        const Token *expandHash(TokenList *output, const Location &loc, const Token *tok, const std::map<TokenString, Macro> &macros, const std::set<TokenString> &expandedmacros, const std::vector<const Token*> &parametertokens) const {
+        const Token *expandHash(TokenList *output, const Location &loc, const Token *tok, const MacroMap &macros, const HideSet &expandedmacros, const std::vector<const Token*> &parametertokens) const {
             TokenList tokenListHash(files);
             tok = expandToken(&tokenListHash, loc, tok->next, macros, expandedmacros, parametertokens);
             std::ostringstream ostr;
@@ -1869,7 +2570,7 @@ namespace simplecpp {
          * @param parametertokens  parameters given when expanding this macro
          * @return token after B
          */
-        const Token *expandHashHash(TokenList *output, const Location &loc, const Token *tok, const std::map<TokenString, Macro> &macros, const std::set<TokenString> &expandedmacros, const std::vector<const Token*> &parametertokens) const {
+        const Token *expandHashHash(TokenList *output, const Location &loc, const Token *tok, const MacroMap &macros, const HideSet &expandedmacros, const std::vector<const Token*> &parametertokens) const {
             Token *A = output->back();
             if (!A)
                 throw invalidHashHash(tok->location, name());
@@ -1926,8 +2627,8 @@ namespace simplecpp {
                 tokens.push_back(new Token(strAB, tok->location));
                 // for function like macros, push the (...)
                 if (tokensB.empty() && sameline(B,B->next) && B->next->op=='(') {
-                    const std::map<TokenString,Macro>::const_iterator it = macros.find(strAB);
-                    if (it != macros.end() && expandedmacros.find(strAB) == expandedmacros.end() && it->second.functionLike()) {
+                    const MacroMap::const_iterator it = macros.find(strAB);
+                    if (it != macros.end() && !expandedmacros.contains(strAB) && it->second.functionLike()) {
                         const Token *tok2 = appendTokens(&tokens, loc, B->next, macros, expandedmacros, parametertokens);
                         if (tok2)
                             nextTok = tok2->next;
@@ -1942,13 +2643,8 @@ namespace simplecpp {
             return nextTok;
         }
 
-        static bool isReplaced(const std::set<std::string> &expandedmacros) {
-            // return true if size > 1
-            std::set<std::string>::const_iterator it = expandedmacros.begin();
-            if (it == expandedmacros.end())
-                return false;
-            ++it;
-            return (it != expandedmacros.end());
+        static bool isReplaced(const HideSet &expandedmacros) {
+            return expandedmacros.size() > 1U;
         }
 
         /** name token in definition */
@@ -1978,6 +2674,193 @@ namespace simplecpp {
         /** was the value of this macro actually defined in the code? */
         bool valueDefinedInCode_;
     };
+
+    /** Change of the macro state by an included file */
+    struct HeaderEvent {
+        enum Type { DEFINE, UNDEF, USAGE, PRAGMA_ONCE };
+
+        HeaderEvent(Type type_, const std::string &name_, const Token *defineToken_, const Location &location_) :
+            type(type_), name(name_), defineToken(defineToken_), location(location_) {}
+
+        Type type;
+        /** macro name, or file name of PRAGMA_ONCE */
+        std::string name;
+        /** DEFINE: the '#' of the #define */
+        const Token *defineToken;
+        /** USAGE: where the macro was expanded */
+        Location location;
+    };
+
+#if __cplusplus >= 201103L
+    typedef std::unordered_map<TokenString, MacroId> MacroIdMap;
+    typedef std::unordered_set<TokenString> MacroNameSet;
+#else
+    typedef std::map<TokenString, MacroId> MacroIdMap;
+    typedef std::set<TokenString> MacroNameSet;
+#endif
+
+    /** What preprocessing an included file depends on and what it produced */
+    struct HeaderResult {
+        explicit HeaderResult(std::vector<std::string> &files) : tokens(files), depth(0) {}
+
+        /** macros that were looked up, with the definition that was found */
+        MacroIdMap macros;
+        /** files that were included, and whether they had #pragma once */
+        std::map<std::string, bool> pragmaOnce;
+        std::list<HeaderEvent> events;
+        TokenList tokens;
+        OutputList outputs;
+        std::list<IfCond> ifConds;
+        /** nesting of the #includes below the file */
+        std::size_t depth;
+    };
+
+    /** Records an included file while it is preprocessed */
+    struct HeaderRecorder {
+        HeaderRecorder(std::vector<std::string> &files, HeaderRecorder *parent_, const std::string &header_, std::size_t includeDepth_) :
+            parent(parent_), header(header_), result(new HeaderResult(files)), includeDepth(includeDepth_), ifDepth(0), outputBack(NULL), outputsSize(0), ifCondsSize(0), cacheable(true) {}
+
+        ~HeaderRecorder() {
+            delete result;
+        }
+
+        void lookup(const TokenString &name, const Macro *macro) {
+            if (name == "__COUNTER__")
+                cacheable = false;
+            if (result->macros.find(name) == result->macros.end() && writtenMacros.find(name) == writtenMacros.end())
+                result->macros.insert(std::make_pair(name, macro ? macro->id() : MacroId()));
+        }
+
+        void lookupPragmaOnce(const std::string &file, bool once) {
+            if (writtenPragmaOnce.find(file) == writtenPragmaOnce.end())
+                result->pragmaOnce.insert(std::make_pair(file, once));
+        }
+
+        void event(const HeaderEvent &e) {
+            if (e.type == HeaderEvent::DEFINE || e.type == HeaderEvent::UNDEF)
+                writtenMacros.insert(e.name);
+            else if (e.type == HeaderEvent::PRAGMA_ONCE)
+                writtenPragmaOnce.insert(e.name);
+            result->events.push_back(e);
+        }
+
+        /** add the result of a file that was included at the given depth */
+        void merge(const HeaderResult &included, std::size_t depth) {
+            for (MacroIdMap::const_iterator it = included.macros.begin(); it != included.macros.end(); ++it) {
+                if (writtenMacros.find(it->first) == writtenMacros.end())
+                    result->macros.insert(*it);
+            }
+            for (std::map<std::string, bool>::const_iterator it = included.pragmaOnce.begin(); it != included.pragmaOnce.end(); ++it)
+                lookupPragmaOnce(it->first, it->second);
+            for (std::list<HeaderEvent>::const_iterator it = included.events.begin(); it != included.events.end(); ++it)
+                event(*it);
+            result->depth = std::max(result->depth, depth - includeDepth + included.depth);
+        }
+
+        HeaderRecorder *parent;
+        std::string header;
+        HeaderResult *result;
+        MacroNameSet writtenMacros;
+        std::set<std::string> writtenPragmaOnce;
+        /** size of the include stack before the file was included */
+        std::size_t includeDepth;
+        /** size of the #if stack when the file was included */
+        std::size_t ifDepth;
+        /** last output token before the file */
+        const Token *outputBack;
+        std::size_t outputsSize;
+        std::size_t ifCondsSize;
+        bool cacheable;
+    };
+
+    static void recordMacroLookup(HeaderRecorder *recorder, const TokenString &name, const Macro *macro)
+    {
+        recorder->lookup(name, macro);
+    }
+
+    static void recordMacroUsage(HeaderRecorder *recorder, const TokenString &name, const Location &location)
+    {
+        recorder->event(HeaderEvent(HeaderEvent::USAGE, name, NULL, location));
+    }
+
+    struct PreprocessCache::Data {
+        Data() : files(NULL), hits(0), misses(0) {}
+
+        ~Data() {
+            clear();
+        }
+
+        void clear() {
+            for (std::map<std::string, std::list<HeaderResult *> >::iterator it = headers.begin(); it != headers.end(); ++it) {
+                for (std::list<HeaderResult *>::iterator result = it->second.begin(); result != it->second.end(); ++result)
+                    delete *result;
+            }
+            headers.clear();
+        }
+
+        /** make sure that the cached results were created with the same settings */
+        void use(const std::vector<std::string> &files_, const DUI &dui, const std::map<std::string, std::size_t> &sizeOfType_) {
+            if (files == &files_ && std == dui.std && includePaths == dui.includePaths && undefined == dui.undefined && sizeOfType == sizeOfType_)
+                return;
+            clear();
+            files = &files_;
+            std = dui.std;
+            includePaths = dui.includePaths;
+            undefined = dui.undefined;
+            sizeOfType = sizeOfType_;
+        }
+
+        /** find a result that was created with the current macro state */
+        const HeaderResult *find(const std::string &header, const MacroMap &macros, const std::set<std::string> &pragmaOnce, std::size_t includeDepth) const {
+            const std::map<std::string, std::list<HeaderResult *> >::const_iterator it = headers.find(header);
+            if (it == headers.end())
+                return NULL;
+            for (std::list<HeaderResult *>::const_iterator result = it->second.begin(); result != it->second.end(); ++result) {
+                if (matches(**result, macros, pragmaOnce, includeDepth))
+                    return *result;
+            }
+            return NULL;
+        }
+
+        void add(const std::string &header, HeaderResult *result) {
+            std::list<HeaderResult *> &results = headers[header];
+            if (results.size() >= maxResults) {
+                delete result;
+                return;
+            }
+            results.push_back(result);
+        }
+
+        /** a file is stored for this many different macro states */
+        static const std::size_t maxResults = 8;
+
+        std::map<std::string, std::list<HeaderResult *> > headers;
+
+        const std::vector<std::string> *files;
+        std::string std;
+        std::list<std::string> includePaths;
+        std::set<std::string> undefined;
+        std::map<std::string, std::size_t> sizeOfType;
+
+        unsigned long long hits;
+        unsigned long long misses;
+
+    private:
+        static bool matches(const HeaderResult &result, const MacroMap &macros, const std::set<std::string> &pragmaOnce, std::size_t includeDepth) {
+            if (includeDepth + result.depth >= 400)
+                return false;
+            for (MacroIdMap::const_iterator it = result.macros.begin(); it != result.macros.end(); ++it) {
+                const MacroMap::const_iterator macro = macros.peek(it->first);
+                if (macro == macros.end() ? !(it->second == MacroId()) : !(macro->second.id() == it->second))
+                    return false;
+            }
+            for (std::map<std::string, bool>::const_iterator it = result.pragmaOnce.begin(); it != result.pragmaOnce.end(); ++it) {
+                if ((pragmaOnce.find(it->first) != pragmaOnce.end()) != it->second)
+                    return false;
+            }
+            return true;
+        }
+    };
 }
 
 namespace simplecpp {
@@ -2610,19 +3493,164 @@ public:
 
     void add(const std::string& path) {
         ScopedLock lock(m_criticalSection);
+        if (m_pathSet.size() >= MAX_PATHS)
+            m_pathSet.clear();
         m_pathSet.insert(path);
     }
 
+    void clear() {
+        ScopedLock lock(m_criticalSection);
+        m_pathSet.clear();
+    }
+
 private:
+    /** the cache is dropped when it grows beyond this */
+    static const std::size_t MAX_PATHS = 10000;
+
     std::set<std::string> m_pathSet;
     CRITICAL_SECTION m_criticalSection;
 };
 
 static NonExistingFilesCache nonExistingFilesCache;
 
+#else
+
+/**
+ * Snapshot of the directory listings that are used to resolve headers. With
+ * many include paths most attempts to open a header fail, the listings tell
+ * if the file exists without trying to open it. The paths that are known to
+ * be missing are cached too. The snapshot is dropped by
+ * simplecpp::clearFileLookupCache() and when it grows too large.
+ */
+class DirectoryIndex {
+public:
+    DirectoryIndex() : m_hits(0), m_misses(0) {
+        pthread_mutex_init(&m_mutex, NULL);
+    }
+
+    ~DirectoryIndex() {
+        pthread_mutex_destroy(&m_mutex);
+    }
+
+    /** Returns false if the file is known not to exist */
+    bool mayExist(const std::string &path) {
+        pthread_mutex_lock(&m_mutex);
+        bool cached = true;
+        const bool ret = mayExist(path, &cached);
+        if (cached)
+            ++m_hits;
+        else
+            ++m_misses;
+        pthread_mutex_unlock(&m_mutex);
+        return ret;
+    }
+
+    void clear() {
+        pthread_mutex_lock(&m_mutex);
+        m_entries.clear();
+        m_unlisted.clear();
+        m_missing.clear();
+        pthread_mutex_unlock(&m_mutex);
+    }
+
+    simplecpp::FileLookupStats stats() {
+        pthread_mutex_lock(&m_mutex);
+        simplecpp::FileLookupStats ret;
+        ret.hits = m_hits;
+        ret.misses = m_misses;
+        pthread_mutex_unlock(&m_mutex);
+        return ret;
+    }
+
+private:
+    bool mayExist(const std::string &path, bool *cached) {
+        if (m_missing.find(path) != m_missing.end())
+            return false;
+
+        const std::string::size_type pos = path.rfind('/');
+        const std::string name = (pos == std::string::npos) ? path : path.substr(pos + 1);
+        if (name.empty() || name == "." || name == "..")
+            return true;
+        const std::string dir = (pos == std::string::npos) ? std::string(".") : (pos == 0) ? std::string("/") : path.substr(0, pos);
+        if (dir != "." && dir != "/" && !mayExist(dir, cached)) {
+            addMissing(path);
+            return false;
+        }
+
+        const std::set<std::string> *entries = getEntries(dir, cached);
+        if (!entries)
+            return true; // unknown, the directory can't be listed
+        if (entries->find(name) != entries->end())
+            return true;
+        addMissing(path);
+        return false;
+    }
+
+    void addMissing(const std::string &path) {
+        if (m_missing.size() >= MAX_MISSING)
+            m_missing.clear();
+        m_missing.insert(path);
+    }
+
+    const std::set<std::string> *getEntries(const std::string &dir, bool *cached) {
+        std::map<std::string, std::set<std::string> >::const_iterator it = m_entries.find(dir);
+        if (it != m_entries.end())
+            return &it->second;
+        if (m_unlisted.find(dir) != m_unlisted.end()) {
+            *cached = false;
+            return NULL;
+        }
+
+        *cached = false;
+        if (m_entries.size() >= MAX_DIRECTORIES)
+            m_entries.clear();
+        DIR *d = opendir(dir.c_str());
+        if (!d) {
+            m_unlisted.insert(dir);
+            return NULL;
+        }
+        std::set<std::string> &entries = m_entries[dir];
+        while (const struct dirent *e = readdir(d))
+            entries.insert(e->d_name);
+        closedir(d);
+        return &entries;
+    }
+
+    /** the listings and the missing paths are dropped when they grow beyond these */
+    static const std::size_t MAX_DIRECTORIES = 1000;
+    static const std::size_t MAX_MISSING = 10000;
+
+    std::map<std::string, std::set<std::string> > m_entries;
+    std::set<std::string> m_unlisted;
+    std::set<std::string> m_missing;
+    unsigned long long m_hits;
+    unsigned long long m_misses;
+    pthread_mutex_t m_mutex;
+};
+
+static DirectoryIndex directoryIndex;
+
+#endif
+
+void simplecpp::clearFileLookupCache()
+{
+#ifdef SIMPLECPP_WINDOWS
+    nonExistingFilesCache.clear();
+#else
+    directoryIndex.clear();
 #endif
+}
 
-static std::string _openHeader(std::ifstream &f, const std::string &path)
+simplecpp::FileLookupStats simplecpp::getFileLookupStats()
+{
+#ifdef SIMPLECPP_WINDOWS
+    return FileLookupStats();
+#else
+    return directoryIndex.stats();
+#endif
+}
+
+static std::string _openHeader(FileData &f, const std::string &path)
 {
 #ifdef SIMPLECPP_WINDOWS
     std::string simplePath = simplecpp::simplifyPath(path);
@@ -2637,8 +3665,12 @@ static std::string _openHeader(std::ifstream &f, const std::string &path)
         return "";
     }
 #else
+    std::string simplePath = simplecpp::simplifyPath(path);
+    if (!directoryIndex.mayExist(simplePath))
+        return "";  // file is known not to exist, skip expensive file open call
+
     f.open(path.c_str());
-    return f.is_open() ? simplecpp::simplifyPath(path) : "";
+    return f.is_open() ? simplePath : "";
 #endif
 }
 
@@ -2649,7 +3681,7 @@ static std::string getRelativeFileName(const std::string &sourcefile, const std:
     return simplecpp::simplifyPath(header);
 }
 
-static std::string openHeaderRelative(std::ifstream &f, const std::string &sourcefile, const std::string &header)
+static std::string openHeaderRelative(FileData &f, const std::string &sourcefile, const std::string &header)
 {
     return _openHeader(f, getRelativeFileName(sourcefile, header));
 }
@@ -2662,7 +3694,7 @@ static std::string getIncludePathFileName(const std::string &includePath, const
     return path + header;
 }
 
-static std::string openHeaderIncludePath(std::ifstream &f, const simplecpp::DUI &dui, const std::string &header)
+static std::string openHeaderIncludePath(FileData &f, const simplecpp::DUI &dui, const std::string &header)
 {
     for (std::list<std::string>::const_iterator it = dui.includePaths.begin(); it != dui.includePaths.end(); ++it) {
         std::string simplePath = _openHeader(f, getIncludePathFileName(*it, header));
@@ -2672,7 +3704,7 @@ static std::string openHeaderIncludePath(std::ifstream &f, const simplecpp::DUI
     return "";
 }
 
-static std::string openHeader(std::ifstream &f, const simplecpp::DUI &dui, const std::string &sourcefile, const std::string &header, bool systemheader)
+static std::string openHeader(FileData &f, const simplecpp::DUI &dui, const std::string &sourcefile, const std::string &header, bool systemheader)
 {
     if (isAbsolutePath(header))
         return _openHeader(f, header);
@@ -2731,7 +3763,8 @@ std::map<std::string, simplecpp::TokenList*> simplecpp::load(const simplecpp::To
         if (ret.find(filename) != ret.end())
             continue;
 
-        std::ifstream fin(filename.c_str());
+        FileData fin;
+        fin.open(filename);
         if (!fin.is_open()) {
             if (outputList) {
                 simplecpp::Output err(fileNumbers);
@@ -2743,7 +3776,8 @@ std::map<std::string, simplecpp::TokenList*> simplecpp::load(const simplecpp::To
             continue;
         }
 
-        TokenList *tokenlist = new TokenList(fin, fileNumbers, filename, outputList);
+        TokenList *tokenlist = new TokenList(fin.data(), fin.size(), fileNumbers, filename, outputList);
+        tokenlist->fileStatus = fin.status();
         if (!tokenlist->front()) {
             delete tokenlist;
             continue;
@@ -2777,12 +3811,13 @@ std::map<std::string, simplecpp::TokenList*> simplecpp::load(const simplecpp::To
         if (hasFile(ret, sourcefile, header, dui, systemheader))
             continue;
 
-        std::ifstream f;
+        FileData f;
         const std::string header2 = openHeader(f,dui,sourcefile,header,systemheader);
         if (!f.is_open())
             continue;
 
-        TokenList *tokens = new TokenList(f, fileNumbers, header2, outputList);
+        TokenList *tokens = new TokenList(f.data(), f.size(), fileNumbers, header2, outputList);
+        tokens->fileStatus = f.status();
         ret[header2] = tokens;
         if (tokens->front())
             filelist.push_back(tokens->front());
@@ -2791,10 +3826,15 @@ std::map<std::string, simplecpp::TokenList*> simplecpp::load(const simplecpp::To
     return ret;
 }
 
-static bool preprocessToken(simplecpp::TokenList &output, const simplecpp::Token **tok1, std::map<std::string, simplecpp::Macro> &macros, std::vector<std::string> &files, simplecpp::OutputList *outputList)
+static bool compareMacroNames(const simplecpp::Macro *m1, const simplecpp::Macro *m2)
+{
+    return m1->name() < m2->name();
+}
+
+static bool preprocessToken(simplecpp::TokenList &output, const simplecpp::Token **tok1, simplecpp::MacroMap &macros, std::vector<std::string> &files, simplecpp::OutputList *outputList)
 {
     const simplecpp::Token *tok = *tok1;
-    const std::map<std::string,simplecpp::Macro>::const_iterator it = macros.find(tok->str());
+    const simplecpp::MacroMap::const_iterator it = macros.find(tok->str());
     if (it != macros.end()) {
         simplecpp::TokenList value(files);
         try {
@@ -2818,7 +3858,126 @@ static bool preprocessToken(simplecpp::TokenList &output, const simplecpp::Token
     return true;
 }
 
-void simplecpp::preprocess(simplecpp::TokenList &output, const simplecpp::TokenList &rawtokens, std::vector<std::string> &files, std::map<std::string, simplecpp::TokenList *> &filedata, const simplecpp::DUI &dui, simplecpp::OutputList *outputList, std::list<simplecpp::MacroUsage> *macroUsage, std::list<simplecpp::IfCond> *ifCond)
+simplecpp::PreprocessCache::PreprocessCache() : mData(new Data)
+{
+}
+
+simplecpp::PreprocessCache::~PreprocessCache()
+{
+    delete mData;
+}
+
+void simplecpp::PreprocessCache::clear()
+{
+    mData->clear();
+}
+
+unsigned long long simplecpp::PreprocessCache::hits() const
+{
+    return mData->hits;
+}
+
+unsigned long long simplecpp::PreprocessCache::misses() const
+{
+    return mData->misses;
+}
+
+namespace {
+    /** Deletes the recorders of the included files when preprocessing stops */
+    class HeaderRecordersCleanup {
+    public:
+        explicit HeaderRecordersCleanup(simplecpp::MacroMap &macros) : mMacros(macros) {}
+        ~HeaderRecordersCleanup() {
+            while (mMacros.recorder) {
+                simplecpp::HeaderRecorder * const recorder = mMacros.recorder;
+                mMacros.recorder = recorder->parent;
+                delete recorder;
+            }
+        }
+    private:
+        simplecpp::MacroMap &mMacros;
+    };
+}
+
+/** The included file that is recorded has been preprocessed, store its result */
+static void finishHeader(simplecpp::TokenList &output, simplecpp::MacroMap &macros, std::size_t ifDepth, simplecpp::OutputList *outputList, std::list<simplecpp::IfCond> *ifCond, simplecpp::PreprocessCache::Data *cacheData)
+{
+    simplecpp::HeaderRecorder * const recorder = macros.recorder;
+    macros.recorder = recorder->parent;
+
+    // #if/#endif is not balanced in the file
+    if (ifDepth != recorder->ifDepth)
+        recorder->cacheable = false;
+
+    if (recorder->parent) {
+        if (recorder->cacheable)
+            recorder->parent->merge(*recorder->result, recorder->includeDepth);
+        else
+            recorder->parent->cacheable = false;
+    }
+
+    if (recorder->cacheable) {
+        simplecpp::HeaderResult * const result = recorder->result;
+        for (const simplecpp::Token *tok = recorder->outputBack ? recorder->outputBack->next : output.cfront(); tok; tok = tok->next)
+            result->tokens.push_back(new simplecpp::Token(*tok));
+        if (outputList) {
+            simplecpp::OutputList::iterator it = outputList->begin();
+            std::advance(it, recorder->outputsSize);
+            result->outputs.insert(result->outputs.end(), it, outputList->end());
+        }
+        if (ifCond) {
+            std::list<simplecpp::IfCond>::iterator it = ifCond->begin();
+            std::advance(it, recorder->ifCondsSize);
+            result->ifConds.insert(result->ifConds.end(), it, ifCond->end());
+        }
+        cacheData->add(recorder->header, result);
+        recorder->result = NULL;
+    }
+
+    delete recorder;
+}
+
+/** Reuse the result of an included file instead of preprocessing it */
+static void replayHeader(const simplecpp::HeaderResult &result, std::size_t includeDepth, simplecpp::TokenList &output, simplecpp::MacroMap &macros, std::set<std::string> &pragmaOnce, std::vector<std::string> &files, simplecpp::OutputList *outputList, std::list<simplecpp::IfCond> *ifCond)
+{
+    if (macros.recorder)
+        macros.recorder->merge(result, includeDepth);
+
+    for (std::list<simplecpp::HeaderEvent>::const_iterator e = result.events.begin(); e != result.events.end(); ++e) {
+        switch (e->type) {
+        case simplecpp::HeaderEvent::DEFINE: {
+            const simplecpp::Macro macro(e->defineToken, files);
+            const simplecpp::MacroMap::iterator it = macros.peek(e->name);
+            if (it == macros.end())
+                macros.insert(std::pair<simplecpp::TokenString, simplecpp::Macro>(e->name, macro));
+            else
+                it->second = macro;
+            break;
+        }
+        case simplecpp::HeaderEvent::UNDEF:
+            macros.erase(e->name);
+            break;
+        case simplecpp::HeaderEvent::USAGE: {
+            const simplecpp::MacroMap::iterator it = macros.peek(e->name);
+            if (it != macros.end())
+                it->second.addUsage(e->location);
+            break;
+        }
+        case simplecpp::HeaderEvent::PRAGMA_ONCE:
+            pragmaOnce.insert(e->name);
+            break;
+        }
+    }
+
+    for (const simplecpp::Token *tok = result.tokens.cfront(); tok; tok = tok->next)
+        output.push_back(new simplecpp::Token(*tok));
+    if (outputList)
+        outputList->insert(outputList->end(), result.outputs.begin(), result.outputs.end());
+    if (ifCond)
+        ifCond->insert(ifCond->end(), result.ifConds.begin(), result.ifConds.end());
+}
+
+void simplecpp::preprocess(simplecpp::TokenList &output, const simplecpp::TokenList &rawtokens, std::vector<std::string> &files, std::map<std::string, simplecpp::TokenList *> &filedata, const simplecpp::DUI &dui, simplecpp::OutputList *outputList, std::list<simplecpp::MacroUsage> *macroUsage, std::list<simplecpp::IfCond> *ifCond, simplecpp::PreprocessCache *cache)
 {
     std::map<std::string, std::size_t> sizeOfType(rawtokens.sizeOfType);
     sizeOfType.insert(std::make_pair("char", sizeof(char)));
@@ -2842,8 +4001,13 @@ void simplecpp::preprocess(simplecpp::TokenList &output, const simplecpp::TokenL
     sizeOfType.insert(std::make_pair("double *", sizeof(double *)));
     sizeOfType.insert(std::make_pair("long double *", sizeof(long double *)));
 
+    PreprocessCache::Data * const cacheData = cache ? cache->data() : NULL;
+    if (cacheData)
+        cacheData->use(files, dui, sizeOfType);
+
     const bool hasInclude = (dui.std.size() == 5 && dui.std.compare(0,3,"c++") == 0 && dui.std >= "c++17");
-    std::map<TokenString, Macro> macros;
+    MacroMap macros;
+    const HeaderRecordersCleanup recordersCleanup(macros);
     for (std::list<std::string>::const_iterator it = dui.defines.begin(); it != dui.defines.end(); ++it) {
         const std::string &macrostr = *it;
         const std::string::size_type eq = macrostr.find('=');
@@ -2890,6 +4054,8 @@ void simplecpp::preprocess(simplecpp::TokenList &output, const simplecpp::TokenL
 
     for (const Token *rawtok = NULL; rawtok || !includetokenstack.empty();) {
         if (rawtok == NULL) {
+            if (macros.recorder && macros.recorder->includeDepth + 1U == includetokenstack.size())
+                finishHeader(output, macros, ifstates.size(), outputList, ifCond, cacheData);
             rawtok = includetokenstack.top();
             includetokenstack.pop();
             continue;
@@ -2943,11 +4109,13 @@ void simplecpp::preprocess(simplecpp::TokenList &output, const simplecpp::TokenL
                 try {
                     const Macro &macro = Macro(rawtok->previous, files);
                     if (dui.undefined.find(macro.name()) == dui.undefined.end()) {
-                        std::map<TokenString, Macro>::iterator it = macros.find(macro.name());
+                        MacroMap::iterator it = macros.peek(macro.name());
                         if (it == macros.end())
                             macros.insert(std::pair<TokenString, Macro>(macro.name(), macro));
                         else
                             it->second = macro;
+                        if (macros.recorder)
+                            macros.recorder->event(HeaderEvent(HeaderEvent::DEFINE, macro.name(), rawtok->previous, rawtok->location));
                     }
                 } catch (const std::runtime_error &) {
                     if (outputList) {
@@ -3008,10 +4176,11 @@ void simplecpp::preprocess(simplecpp::TokenList &output, const simplecpp::TokenL
                 std::string header2 = getFileName(filedata, rawtok->location.file(), header, dui, systemheader);
                 if (header2.empty()) {
                     // try to load file..
-                    std::ifstream f;
+                    FileData f;
                     header2 = openHeader(f, dui, rawtok->location.file(), header, systemheader);
                     if (f.is_open()) {
-                        TokenList *tokens = new TokenList(f, files, header2, outputList);
+                        TokenList *tokens = new TokenList(f.data(), f.size(), files, header2, outputList);
+                        tokens->fileStatus = f.status();
                         filedata[header2] = tokens;
                     }
                 }
@@ -3024,6 +4193,8 @@ void simplecpp::preprocess(simplecpp::TokenList &output, const simplecpp::TokenL
                         outputList->push_back(out);
                     }
                 } else if (includetokenstack.size() >= 400) {
+                    if (macros.recorder)
+                        macros.recorder->cacheable = false;
                     if (outputList) {
                         simplecpp::Output out(files);
                         out.type = Output::INCLUDE_NESTED_TOO_DEEPLY;
@@ -3031,11 +4202,34 @@ void simplecpp::preprocess(simplecpp::TokenList &output, const simplecpp::TokenL
                         out.msg = "#include nested too deeply";
                         outputList->push_back(out);
                     }
-                } else if (pragmaOnce.find(header2) == pragmaOnce.end()) {
-                    includetokenstack.push(gotoNextLine(rawtok));
-                    const TokenList *includetokens = filedata.find(header2)->second;
-                    rawtok = includetokens ? includetokens->cfront() : NULL;
-                    continue;
+                } else {
+                    const bool once = (pragmaOnce.find(header2) != pragmaOnce.end());
+                    HeaderRecorder * const recorder = macros.recorder;
+                    if (recorder) {
+                        recorder->lookupPragmaOnce(header2, once);
+                        recorder->result->depth = std::max(recorder->result->depth, includetokenstack.size() - recorder->includeDepth);
+                    }
+                    if (!once) {
+                        if (cacheData) {
+                            const HeaderResult *result = cacheData->find(header2, macros, pragmaOnce, includetokenstack.size());
+                            if (result) {
+                                ++cacheData->hits;
+                                replayHeader(*result, includetokenstack.size(), output, macros, pragmaOnce, files, outputList, ifCond);
+                                rawtok = gotoNextLine(rawtok);
+                                continue;
+                            }
+                            ++cacheData->misses;
+                            macros.recorder = new HeaderRecorder(files, recorder, header2, includetokenstack.size());
+                            macros.recorder->ifDepth = ifstates.size();
+                            macros.recorder->outputBack = output.cback();
+                            macros.recorder->outputsSize = outputList ? outputList->size() : 0U;
+                            macros.recorder->ifCondsSize = ifCond ? ifCond->size() : 0U;
+                        }
+                        includetokenstack.push(gotoNextLine(rawtok));
+                        const TokenList *includetokens = filedata.find(header2)->second;
+                        rawtok = includetokens ? includetokens->cfront() : NULL;
+                        continue;
+                    }
                 }
             } else if (rawtok->str() == IF || rawtok->str() == IFDEF || rawtok->str() == IFNDEF || rawtok->str() == ELIF) {
                 if (!sameline(rawtok,rawtok->next)) {
@@ -3103,7 +4297,7 @@ void simplecpp::preprocess(simplecpp::TokenList &output, const simplecpp::TokenL
                                 const std::string &sourcefile = rawtok->location.file();
                                 const bool systemheader = (tok->str()[0] == '<');
                                 const std::string header(realFilename(tok->str().substr(1U, tok->str().size() - 2U)));
-                                std::ifstream f;
+                                FileData f;
                                 const std::string header2 = openHeader(f,dui,sourcefile,header,systemheader);
                                 expr.push_back(new Token(header2.empty() ? "0" : "1", tok->location));
                             }
@@ -3179,11 +4373,16 @@ void simplecpp::preprocess(simplecpp::TokenList &output, const simplecpp::TokenL
                     const Token *tok = rawtok->next;
                     while (sameline(rawtok,tok) && tok->comment)
                         tok = tok->next;
-                    if (sameline(rawtok, tok))
+                    if (sameline(rawtok, tok)) {
                         macros.erase(tok->str());
+                        if (macros.recorder)
+                            macros.recorder->event(HeaderEvent(HeaderEvent::UNDEF, tok->str(), NULL, tok->location));
+                    }
                 }
             } else if (ifstates.top() == TRUE && rawtok->str() == PRAGMA && rawtok->next && rawtok->next->str() == ONCE && sameline(rawtok,rawtok->next)) {
                 pragmaOnce.insert(rawtok->location.file());
+                if (macros.recorder)
+                    macros.recorder->event(HeaderEvent(HeaderEvent::PRAGMA_ONCE, rawtok->location.file(), NULL, rawtok->location));
             }
             rawtok = gotoNextLine(rawtok);
             continue;
@@ -3220,8 +4419,12 @@ void simplecpp::preprocess(simplecpp::TokenList &output, const simplecpp::TokenL
                 s += hashtok->str();
             if (hash)
                 output.push_back(new Token('\"' + s + '\"', loc));
-            else if (output.back())
+            else if (output.back()) {
+                // the token before the included file is changed
+                for (HeaderRecorder *recorder = macros.recorder; recorder && recorder->outputBack == output.cback(); recorder = recorder->parent)
+                    recorder->cacheable = false;
                 output.back()->setstr(output.cback()->str() + s);
+            }
             else
                 output.push_back(new Token(s, loc));
         } else {
@@ -3230,8 +4433,14 @@ void simplecpp::preprocess(simplecpp::TokenList &output, const simplecpp::TokenL
     }
 
     if (macroUsage) {
-        for (std::map<TokenString, simplecpp::Macro>::const_iterator macroIt = macros.begin(); macroIt != macros.end(); ++macroIt) {
-            const Macro &macro = macroIt->second;
+        // report the macros in name order, the macro table is not ordered
+        std::vector<const Macro *> sortedMacros;
+        sortedMacros.reserve(macros.size());
+        for (MacroMap::const_iterator macroIt = macros.begin(); macroIt != macros.end(); ++macroIt)
+            sortedMacros.push_back(&macroIt->second);
+        std::sort(sortedMacros.begin(), sortedMacros.end(), compareMacroNames);
+        for (std::vector<const Macro *>::const_iterator macroIt = sortedMacros.begin(); macroIt != sortedMacros.end(); ++macroIt) {
+            const Macro &macro = **macroIt;
             const std::list<Location> &usage = macro.usage();
             for (std::list<Location>::const_iterator usageIt = usage.begin(); usageIt != usage.end(); ++usageIt) {
                 MacroUsage mu(usageIt->files, macro.valueDefinedInCode());
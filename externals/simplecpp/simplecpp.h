@@ -92,6 +92,7 @@ namespace simplecpp {
 
     /**
      * token class.
+     * In C++11 builds the tokens are allocated from a pool that holds many tokens per chunk.
      * @todo don't use std::string representation - for both memory and performance reasons
      */
     class SIMPLECPP_LIB Token {
@@ -121,6 +122,12 @@ namespace simplecpp {
             string = s;
             flags();
         }
+        /** move the string out of a token that is about to be deleted */
+        TokenString takestr() {
+            TokenString s;
+            s.swap(string);
+            return s;
+        }
 
         bool isOneOf(const char ops[]) const;
         bool startsWithOneOf(const char c[]) const;
@@ -151,18 +158,27 @@ namespace simplecpp {
 
         void setExpandedFrom(const Token *tok, const void* m) {
             mExpandedFrom = tok->mExpandedFrom;
-            mExpandedFrom.insert(m);
+            if (!isExpandedFrom(m))
+                mExpandedFrom.push_back(m);
         }
         bool isExpandedFrom(const void* m) const {
-            return mExpandedFrom.find(m) != mExpandedFrom.end();
+            for (std::vector<const void*>::const_iterator it = mExpandedFrom.begin(); it != mExpandedFrom.end(); ++it) {
+                if (*it == m)
+                    return true;
+            }
+            return false;
         }
 
         void printAll() const;
         void printOut() const;
+
+        static void *operator new(std::size_t size);
+        static void operator delete(void *p);
     private:
         TokenString string;
 
-        std::set<const void*> mExpandedFrom;
+        /** the macros this token was expanded from, there are only a few */
+        std::vector<const void*> mExpandedFrom;
 
         // Not implemented - prevent assignment
         Token &operator=(const Token &tok);
@@ -187,11 +203,22 @@ namespace simplecpp {
 
     typedef std::list<Output> OutputList;
 
+    /** Size, modification time and hash of the contents of a file, taken when the file was read */
+    struct SIMPLECPP_LIB FileStatus {
+        FileStatus() : size(-1), mtime(-1), hash(0) {}
+        long long size;
+        long long mtime;
+        unsigned long long hash;
+    };
+
     /** List of tokens. */
     class SIMPLECPP_LIB TokenList {
     public:
         explicit TokenList(std::vector<std::string> &filenames);
         TokenList(std::istream &istr, std::vector<std::string> &filenames, const std::string &filename=std::string(), OutputList *outputList = NULL);
+        TokenList(const unsigned char *data, std::size_t size, std::vector<std::string> &filenames, const std::string &filename=std::string(), OutputList *outputList = NULL);
+        /** Read a file, the contents are shared with other TokenLists of the process that read the same file */
+        TokenList(const std::string &filename, std::vector<std::string> &filenames, OutputList *outputList = NULL);
         TokenList(const TokenList &other);
 #if __cplusplus >= 201103L
         TokenList(TokenList &&other);
@@ -264,6 +291,9 @@ namespace simplecpp {
         /** sizeof(T) */
         std::map<std::string, std::size_t> sizeOfType;
 
+        /** status of the file the tokens were read from, the size is -1 if they were not read from a file */
+        FileStatus fileStatus;
+
     private:
         void combineOperators();
 
@@ -276,7 +306,9 @@ namespace simplecpp {
         void constFoldLogicalOp(Token *tok);
         void constFoldQuestionOp(Token **tok1);
 
-        std::string readUntil(std::istream &istr, const Location &location, char start, char end, OutputList *outputList, unsigned int bom);
+        class Stream;
+        void readfile(Stream &stream, const std::string &filename, OutputList *outputList);
+        std::string readUntil(Stream &stream, const Location &location, char start, char end, OutputList *outputList, unsigned int bom);
         void lineDirective(unsigned int fileIndex, unsigned int line, Location *location);
 
         std::string lastLine(int maxsize=100000) const;
@@ -322,6 +354,41 @@ namespace simplecpp {
 
     SIMPLECPP_LIB std::map<std::string, TokenList*> load(const TokenList &rawtokens, std::vector<std::string> &filenames, const DUI &dui, OutputList *outputList = NULL);
 
+    /**
+     * Results of preprocessing included files, shared by the preprocess()
+     * calls for the configurations of a source file. When a file is included
+     * again and the macros it looked at are defined the same way as when it
+     * was preprocessed, its output and macro definitions are reused instead
+     * of preprocessing it again.
+     * The cache refers to the tokens in filedata. It must be cleared when
+     * filedata changes.
+     */
+    class SIMPLECPP_LIB PreprocessCache {
+    public:
+        PreprocessCache();
+        ~PreprocessCache();
+
+        void clear();
+
+        /** number of included files that were reused */
+        unsigned long long hits() const;
+        /** number of included files that were preprocessed */
+        unsigned long long misses() const;
+
+        /** internal data of simplecpp */
+        struct Data;
+        Data *data() {
+            return mData;
+        }
+
+    private:
+        // Not implemented - prevent copying
+        PreprocessCache(const PreprocessCache &);
+        PreprocessCache &operator=(const PreprocessCache &);
+
+        Data *mData;
+    };
+
     /**
      * Preprocess
      * @todo simplify interface
@@ -333,8 +400,9 @@ namespace simplecpp {
      * @param outputList output: list that will receive output messages
      * @param macroUsage output: macro usage
      * @param ifCond output: #if/#elif expressions
+     * @param cache results of included files that are shared between calls
      */
-    SIMPLECPP_LIB void preprocess(TokenList &output, const TokenList &rawtokens, std::vector<std::string> &files, std::map<std::string, TokenList*> &filedata, const DUI &dui, OutputList *outputList = NULL, std::list<MacroUsage> *macroUsage = NULL, std::list<IfCond> *ifCond = NULL);
+    SIMPLECPP_LIB void preprocess(TokenList &output, const TokenList &rawtokens, std::vector<std::string> &files, std::map<std::string, TokenList*> &filedata, const DUI &dui, OutputList *outputList = NULL, std::list<MacroUsage> *macroUsage = NULL, std::list<IfCond> *ifCond = NULL, PreprocessCache *cache = NULL);
 
     /**
      * Deallocate data
@@ -346,6 +414,36 @@ namespace simplecpp {
 
     /** Convert Cygwin path to Windows path */
     SIMPLECPP_LIB std::string convertCygwinToWindowsPath(const std::string &cygwinPath);
+
+    /** Statistics of the header lookups */
+    struct SIMPLECPP_LIB FileLookupStats {
+        FileLookupStats() : hits(0), misses(0) {}
+        /** lookups that were answered by the cached directory index */
+        unsigned long long hits;
+        /** lookups that had to read the filesystem */
+        unsigned long long misses;
+    };
+
+    /** Get the statistics of the header lookups of this process */
+    SIMPLECPP_LIB FileLookupStats getFileLookupStats();
+
+    /** Forget the cached directory listings and missing headers, headers that were added since are found after this */
+    SIMPLECPP_LIB void clearFileLookupCache();
+
+    /** Statistics of the file buffer cache */
+    struct SIMPLECPP_LIB FileBufferStats {
+        FileBufferStats() : hits(0), misses(0) {}
+        /** files that were already in memory */
+        unsigned long long hits;
+        /** files that were read from disk */
+        unsigned long long misses;
+    };
+
+    /** Get the statistics of the file buffer cache of this process */
+    SIMPLECPP_LIB FileBufferStats getFileBufferStats();
+
+    /** Read the current status of a file, the file buffer cache is not used. Returns false if the file can't be read */
+    SIMPLECPP_LIB bool getFileStatus(const std::string &path, FileStatus &status);
 }
 
 #endif
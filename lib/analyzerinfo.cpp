@@ -22,8 +22,12 @@
 #include "path.h"
 #include "utils.h"
 
+#include <simplecpp.h>
 #include <tinyxml2.h>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
+#include <ctime>
 #include <map>
 #include <sstream>
 
@@ -147,6 +151,181 @@ bool AnalyzerInformation::analyzeFile(const std::string &buildDir, const std::st
     return true;
 }
 
+static std::string hashString(const std::string &s)
+{
+    Hash64 h;
+    h.add(s);
+    return std::to_string(h.get());
+}
+
+static bool isUnchangedFile(const tinyxml2::XMLElement *e, long long manifestTime)
+{
+    const char *name = e->Attribute("name");
+    const char *hash = e->Attribute("hash");
+    if (!name || !hash)
+        return false;
+    long long size, mtime;
+    if (!Path::getFileStatus(name, size, mtime))
+        return false;
+    if (size != e->Int64Attribute("size", -1))
+        return false;
+    // The mtime has a coarse resolution, files that were written in the same
+    // second as they were read could be changed without changing the mtime
+    if (mtime == e->Int64Attribute("mtime", -1) && mtime < manifestTime)
+        return true;
+    simplecpp::FileStatus status;
+    return simplecpp::getFileStatus(name, status) && std::to_string(status.hash) == hash;
+}
+
+static bool isUnchangedDirectory(const tinyxml2::XMLElement *e, long long manifestTime)
+{
+    const char *name = e->Attribute("name");
+    if (!name)
+        return false;
+    // A header that is added or removed changes the mtime of the directory.
+    // -1 is stored for a directory that did not exist.
+    long long size, mtime;
+    if (!Path::getFileStatus(name, size, mtime))
+        mtime = -1;
+    if (mtime != e->Int64Attribute("mtime", -2))
+        return false;
+    return mtime < manifestTime;
+}
+
+static std::string getAttribute(const tinyxml2::XMLElement *e, const char name[])
+{
+    const char *attr = e->Attribute(name);
+    return attr ? attr : "";
+}
+
+bool AnalyzerInformation::isUnchanged(const std::string &buildDir, const std::string &sourcefile, const std::string &cfg, const std::string &toolinfo, std::list<ErrorMessage> *errors, std::list<Suppressions::Suppression> *suppressions)
+{
+    if (buildDir.empty() || sourcefile.empty())
+        return false;
+
+    tinyxml2::XMLDocument doc;
+    const tinyxml2::XMLError error = doc.LoadFile(getAnalyzerInfoFile(buildDir, sourcefile, cfg).c_str());
+    if (error != tinyxml2::XML_SUCCESS)
+        return false;
+
+    const tinyxml2::XMLElement * const rootNode = doc.FirstChildElement();
+    if (rootNode == nullptr)
+        return false;
+
+    const tinyxml2::XMLElement * const manifest = rootNode->FirstChildElement("manifest");
+    if (manifest == nullptr)
+        return false;
+
+    const char *attr = manifest->Attribute("toolinfo");
+    if (!attr || attr != hashString(toolinfo))
+        return false;
+
+    const long long manifestTime = manifest->Int64Attribute("time", 0);
+    bool hasFiles = false;
+    for (const tinyxml2::XMLElement *e = manifest->FirstChildElement("file"); e; e = e->NextSiblingElement("file")) {
+        if (!isUnchangedFile(e, manifestTime))
+            return false;
+        hasFiles = true;
+    }
+    if (!hasFiles)
+        return false;
+    for (const tinyxml2::XMLElement *e = manifest->FirstChildElement("dir"); e; e = e->NextSiblingElement("dir")) {
+        if (!isUnchangedDirectory(e, manifestTime))
+            return false;
+    }
+
+    for (const tinyxml2::XMLElement *e = manifest->FirstChildElement("suppression"); e; e = e->NextSiblingElement("suppression")) {
+        Suppressions::Suppression suppression;
+        suppression.errorId = getAttribute(e, "errorId");
+        suppression.fileName = getAttribute(e, "fileName");
+        suppression.lineNumber = e->IntAttribute("lineNumber", Suppressions::Suppression::NO_LINE);
+        suppression.symbolName = getAttribute(e, "symbolName");
+        const std::string hash = getAttribute(e, "hash");
+        if (!hash.empty())
+            suppression.hash = std::strtoull(hash.c_str(), nullptr, 10);
+        suppression.thisAndNextLine = e->BoolAttribute("thisAndNextLine", false);
+        suppressions->push_back(suppression);
+    }
+
+    for (const tinyxml2::XMLElement *e = rootNode->FirstChildElement(); e; e = e->NextSiblingElement()) {
+        if (std::strcmp(e->Name(), "error") == 0)
+            errors->emplace_back(e);
+    }
+
+    return true;
+}
+
+static void writeManifestElement(tinyxml2::XMLPrinter &printer, const std::string &toolinfo, std::time_t readTime, const std::map<std::string, simplecpp::FileStatus> &files, const std::set<std::string> &directories, const std::list<Suppressions::Suppression> &suppressions)
+{
+    printer.OpenElement("manifest", false);
+    printer.PushAttribute("toolinfo", hashString(toolinfo).c_str());
+    printer.PushAttribute("time", static_cast<int64_t>(readTime));
+    for (const std::pair<const std::string, simplecpp::FileStatus> &f : files) {
+        printer.OpenElement("file", false);
+        printer.PushAttribute("name", f.first.c_str());
+        printer.PushAttribute("size", static_cast<int64_t>(f.second.size));
+        printer.PushAttribute("mtime", static_cast<int64_t>(f.second.mtime));
+        printer.PushAttribute("hash", std::to_string(f.second.hash).c_str());
+        printer.CloseElement(false);
+    }
+    for (const std::string &dir : directories) {
+        long long size, mtime;
+        if (!Path::getFileStatus(dir, size, mtime))
+            mtime = -1;
+        printer.OpenElement("dir", false);
+        printer.PushAttribute("name", dir.c_str());
+        printer.PushAttribute("mtime", static_cast<int64_t>(mtime));
+        printer.CloseElement(false);
+    }
+    for (const Suppressions::Suppression &suppression : suppressions) {
+        printer.OpenElement("suppression", false);
+        printer.PushAttribute("errorId", suppression.errorId.c_str());
+        if (!suppression.fileName.empty())
+            printer.PushAttribute("fileName", suppression.fileName.c_str());
+        if (suppression.lineNumber != Suppressions::Suppression::NO_LINE)
+            printer.PushAttribute("lineNumber", suppression.lineNumber);
+        if (!suppression.symbolName.empty())
+            printer.PushAttribute("symbolName", suppression.symbolName.c_str());
+        if (suppression.hash > 0)
+            printer.PushAttribute("hash", std::to_string(suppression.hash).c_str());
+        if (suppression.thisAndNextLine)
+            printer.PushAttribute("thisAndNextLine", true);
+        printer.CloseElement(false);
+    }
+    printer.CloseElement(false);
+}
+
+void AnalyzerInformation::writeManifest(const std::string &toolinfo, std::time_t readTime, const std::map<std::string, simplecpp::FileStatus> &files, const std::set<std::string> &directories, const std::list<Suppressions::Suppression> &suppressions)
+{
+    if (mAnalyzerInfoFile.empty())
+        return;
+
+    if (mOutputStream.is_open()) {
+        tinyxml2::XMLPrinter printer(nullptr, false, 1);
+        writeManifestElement(printer, toolinfo, readTime, files, directories, suppressions);
+        mOutputStream << printer.CStr() << '\n';
+        return;
+    }
+
+    // The previous results were reused, replace the manifest in the existing file
+    tinyxml2::XMLDocument doc;
+    if (doc.LoadFile(mAnalyzerInfoFile.c_str()) != tinyxml2::XML_SUCCESS)
+        return;
+    tinyxml2::XMLElement * const rootNode = doc.FirstChildElement();
+    if (rootNode == nullptr)
+        return;
+    tinyxml2::XMLElement *manifest = rootNode->FirstChildElement("manifest");
+    if (manifest)
+        rootNode->DeleteChild(manifest);
+    tinyxml2::XMLPrinter printer(nullptr, false, 1);
+    writeManifestElement(printer, toolinfo, readTime, files, directories, suppressions);
+    tinyxml2::XMLDocument manifestDoc;
+    if (manifestDoc.Parse(printer.CStr()) != tinyxml2::XML_SUCCESS || !manifestDoc.FirstChildElement())
+        return;
+    rootNode->InsertFirstChild(manifestDoc.FirstChildElement()->DeepClone(&doc));
+    doc.SaveFile(mAnalyzerInfoFile.c_str());
+}
+
 void AnalyzerInformation::reportErr(const ErrorMessage &msg, bool /*verbose*/)
 {
     if (mOutputStream.is_open())
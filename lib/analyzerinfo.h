@@ -23,13 +23,22 @@
 
 #include "config.h"
 #include "importproject.h"
+#include "suppressions.h"
 
+#include <ctime>
 #include <fstream>
 #include <list>
+#include <map>
+#include <set>
 #include <string>
+#include <vector>
 
 class ErrorMessage;
 
+namespace simplecpp {
+    struct FileStatus;
+}
+
 /// @addtogroup Core
 /// @{
 
@@ -40,6 +49,8 @@ class ErrorMessage;
  * - checksum
  * - error messages
  * - whole program analysis data
+ * - manifest of the source file and its includes (size, mtime, content hash)
+ *   and of the include directories (mtime)
  *
  * The information can be used for various purposes. It allows:
  * - 'make' - only analyze TUs that are changed and generate full report
@@ -55,6 +66,37 @@ public:
     /** Close current TU.analyzerinfo file */
     void close();
     bool analyzeFile(const std::string &buildDir, const std::string &sourcefile, const std::string &cfg, unsigned long long checksum, std::list<ErrorMessage> *errors);
+
+    /**
+     * Fast check if the results of the previous analysis can be reused without
+     * tokenizing anything. The manifest of the previous run is compared against
+     * the files on disk. If size and mtime match the file is unchanged, if
+     * only the mtime differs the content hash is compared. The include
+     * directories must have the same mtime, otherwise a header could have
+     * been added that changes how an include is resolved.
+     * @param buildDir     build dir
+     * @param sourcefile   source file
+     * @param cfg          configuration (project import)
+     * @param toolinfo     settings that influence the results
+     * @param errors       the cached errors are appended
+     * @param suppressions the cached inline suppressions are appended
+     * @return true if the cached results are valid
+     */
+    static bool isUnchanged(const std::string &buildDir, const std::string &sourcefile, const std::string &cfg, const std::string &toolinfo, std::list<ErrorMessage> *errors, std::list<Suppressions::Suppression> *suppressions);
+
+    /**
+     * Write the manifest for the current TU. Call after analyzeFile(). If the
+     * previous results were reused then the manifest in the existing file is
+     * updated. The file status must be taken when the files are read, so a
+     * file that is changed after it was read is not recorded as unchanged.
+     * @param toolinfo     settings that influence the results
+     * @param readTime     time before the first file of the TU was read
+     * @param files        status of the source file and all included files
+     * @param directories  directories that are searched for the includes
+     * @param suppressions inline suppressions found in the files
+     */
+    void writeManifest(const std::string &toolinfo, std::time_t readTime, const std::map<std::string, simplecpp::FileStatus> &files, const std::set<std::string> &directories, const std::list<Suppressions::Suppression> &suppressions);
+
     void reportErr(const ErrorMessage &msg, bool verbose);
     void setFileInfo(const std::string &check, const std::string &fileInfo);
     static std::string getAnalyzerInfoFile(const std::string &buildDir, const std::string &sourcefile, const std::string &cfg);
@@ -0,0 +1,668 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2021 Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "binarydump.h"
+
+#include <algorithm>
+#include <cstring>
+
+static const char magic[8] = { 'C', 'P', 'P', 'C', 'D', 'U', 'M', 'P' };
+
+// Optional token fields, only written when the bit is set in the presence mask
+enum : unsigned int {
+    hasStrlen       = (1 << 0),
+    hasLink         = (1 << 1),
+    hasVarId        = (1 << 2),
+    hasVariable     = (1 << 3),
+    hasFunction     = (1 << 4),
+    hasValues       = (1 << 5),
+    hasTypeScope    = (1 << 6),
+    hasAstParent    = (1 << 7),
+    hasAstOperand1  = (1 << 8),
+    hasAstOperand2  = (1 << 9),
+    hasOriginalName = (1 << 10),
+    hasValueType    = (1 << 11)
+};
+
+// Token links are usually close to the token itself so they are stored as zigzag encoded deltas
+static std::uint64_t zigzag(std::uint64_t from, std::uint64_t to)
+{
+    const std::int64_t delta = static_cast<std::int64_t>(to - from);
+    return (static_cast<std::uint64_t>(delta) << 1) ^ static_cast<std::uint64_t>(delta >> 63);
+}
+
+static std::uint64_t unzigzag(std::uint64_t from, std::uint64_t value)
+{
+    const std::uint64_t delta = (value >> 1) ^ (~(value & 1) + 1);
+    return from + delta;
+}
+
+BinaryDump::Writer::Writer(std::ostream &out)
+    : mOut(out)
+{
+    mOut.write(magic, sizeof(magic));
+    mPayload.clear();
+    putVarint(version);
+    mOut.write(mPayload.data(), mPayload.size());
+    mPayload.clear();
+}
+
+void BinaryDump::Writer::putVarint(std::uint64_t value)
+{
+    while (value >= 0x80) {
+        mPayload.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    mPayload.push_back(static_cast<char>(value));
+}
+
+void BinaryDump::Writer::putSigned(std::int64_t value)
+{
+    putVarint((static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+}
+
+void BinaryDump::Writer::putString(const std::string &s)
+{
+    putVarint(s.size());
+    mPayload.append(s);
+}
+
+void BinaryDump::Writer::writeRecord(Record record)
+{
+    // header: tag + payload length
+    mHeader.clear();
+    mHeader.push_back(static_cast<char>(record));
+    std::uint64_t len = mPayload.size();
+    while (len >= 0x80) {
+        mHeader.push_back(static_cast<char>((len & 0x7f) | 0x80));
+        len >>= 7;
+    }
+    mHeader.push_back(static_cast<char>(len));
+    mOut.write(mHeader.data(), mHeader.size());
+    mOut.write(mPayload.data(), mPayload.size());
+    mPayload.clear();
+}
+
+unsigned int BinaryDump::Writer::stringId(const std::string &s)
+{
+    const std::unordered_map<std::string, unsigned int>::const_iterator it = mStrings.find(s);
+    if (it != mStrings.end())
+        return it->second;
+    const unsigned int id = mStrings.size();
+    mStrings.emplace(s, id);
+
+    // the payload of the current record is being built, write the string record in between
+    std::string payload;
+    payload.swap(mPayload);
+    putString(s);
+    writeRecord(Record::String);
+    mPayload.swap(payload);
+    return id;
+}
+
+void BinaryDump::Writer::platform(const Platform &platform)
+{
+    const unsigned int name = stringId(platform.name);
+    putVarint(name);
+    putVarint(platform.char_bit);
+    putVarint(platform.short_bit);
+    putVarint(platform.int_bit);
+    putVarint(platform.long_bit);
+    putVarint(platform.long_long_bit);
+    putVarint(platform.pointer_bit);
+    writeRecord(Record::Platform);
+}
+
+void BinaryDump::Writer::rawToken(const std::string &file, unsigned int linenr, unsigned int column, const std::string &str)
+{
+    const unsigned int fileId = stringId(file);
+    const unsigned int strId = stringId(str);
+    putVarint(fileId);
+    putVarint(linenr);
+    putVarint(column);
+    putVarint(strId);
+    writeRecord(Record::RawToken);
+}
+
+void BinaryDump::Writer::beginConfiguration(const std::string &cfg)
+{
+    const unsigned int name = stringId(cfg);
+    putVarint(name);
+    writeRecord(Record::ConfigBegin);
+}
+
+void BinaryDump::Writer::token(const Token &tok)
+{
+    unsigned int presence = 0;
+    if (tok.type == Token::String)
+        presence |= hasStrlen;
+    if (tok.link)
+        presence |= hasLink;
+    if (tok.varId)
+        presence |= hasVarId;
+    if (tok.variable)
+        presence |= hasVariable;
+    if (tok.function)
+        presence |= hasFunction;
+    if (tok.values)
+        presence |= hasValues;
+    if (tok.typeScope)
+        presence |= hasTypeScope;
+    if (tok.astParent)
+        presence |= hasAstParent;
+    if (tok.astOperand1)
+        presence |= hasAstOperand1;
+    if (tok.astOperand2)
+        presence |= hasAstOperand2;
+    if (!tok.originalName.empty())
+        presence |= hasOriginalName;
+    if (!tok.valueType.empty())
+        presence |= hasValueType;
+
+    // intern the strings before the token payload is started
+    const unsigned int file = stringId(tok.file);
+    const unsigned int str = stringId(tok.str);
+    const unsigned int originalName = (presence & hasOriginalName) ? stringId(tok.originalName) : 0;
+    const unsigned int valueType = (presence & hasValueType) ? stringId(tok.valueType) : 0;
+
+    putVarint(tok.id);
+    putVarint(file);
+    putVarint(tok.linenr);
+    putVarint(tok.column);
+    putVarint(str);
+    putVarint(tok.scope);
+    putVarint(tok.type);
+    putVarint(tok.flags);
+    putVarint(presence);
+    if (presence & hasStrlen)
+        putVarint(tok.strlen);
+    if (presence & hasLink)
+        putVarint(zigzag(tok.id, tok.link));
+    if (presence & hasVarId)
+        putVarint(tok.varId);
+    if (presence & hasVariable)
+        putVarint(tok.variable);
+    if (presence & hasFunction)
+        putVarint(tok.function);
+    if (presence & hasValues)
+        putVarint(tok.values);
+    if (presence & hasTypeScope)
+        putVarint(tok.typeScope);
+    if (presence & hasAstParent)
+        putVarint(zigzag(tok.id, tok.astParent));
+    if (presence & hasAstOperand1)
+        putVarint(zigzag(tok.id, tok.astOperand1));
+    if (presence & hasAstOperand2)
+        putVarint(zigzag(tok.id, tok.astOperand2));
+    if (presence & hasOriginalName)
+        putVarint(originalName);
+    if (presence & hasValueType)
+        putVarint(valueType);
+    writeRecord(Record::Token);
+}
+
+void BinaryDump::Writer::scope(const Scope &scope)
+{
+    putVarint(scope.id);
+    putVarint(scope.type);
+    putVarint(stringId(scope.className));
+    putVarint(scope.bodyStart);
+    putVarint(scope.bodyEnd);
+    putVarint(scope.nestedIn);
+    putVarint(scope.function);
+    putVarint(scope.valueflowSteps);
+    putVarint(scope.valueflowTimeMs);
+    putVarint(scope.valueflowBailout ? 1 : 0);
+    putVarint(scope.functions.size());
+    for (const Function &function : scope.functions) {
+        putVarint(function.id);
+        putVarint(function.token);
+        putVarint(function.tokenDef);
+        putVarint(stringId(function.name));
+        putVarint(stringId(function.type));
+        putVarint(function.flags);
+        putVarint(function.args.size());
+        for (std::uint64_t arg : function.args)
+            putVarint(arg);
+    }
+    putVarint(scope.varlist.size());
+    for (std::uint64_t var : scope.varlist)
+        putVarint(var);
+    writeRecord(Record::Scope);
+}
+
+void BinaryDump::Writer::variable(const Variable &var)
+{
+    putVarint(var.id);
+    putVarint(var.nameToken);
+    putVarint(var.typeStartToken);
+    putVarint(var.typeEndToken);
+    putVarint(stringId(var.access));
+    putVarint(var.scope);
+    putVarint(var.constness);
+    putVarint(var.flags);
+    writeRecord(Record::Variable);
+}
+
+void BinaryDump::Writer::values(const Values &values)
+{
+    putVarint(values.id);
+    putVarint(values.values.size());
+    for (const Value &value : values.values) {
+        putVarint(value.type);
+        putVarint(value.kind);
+        switch (value.type) {
+        case Value::Tok:
+            putVarint(value.tokvalue);
+            break;
+        case Value::Float: {
+            std::uint64_t bits;
+            std::memcpy(&bits, &value.floatValue, sizeof(bits));
+            putVarint(bits);
+            break;
+        }
+        case Value::Moved:
+            putVarint(stringId(value.moveKind));
+            break;
+        case Value::Uninit:
+            break;
+        case Value::Lifetime:
+            putVarint(value.tokvalue);
+            putVarint(stringId(value.lifetimeScope));
+            putVarint(stringId(value.lifetimeKind));
+            break;
+        case Value::Symbolic:
+            putVarint(value.tokvalue);
+            putSigned(value.intvalue);
+            break;
+        default:
+            putSigned(value.intvalue);
+            break;
+        }
+        putVarint(stringId(value.bound));
+        putVarint(value.conditionLine);
+        putSigned(value.path);
+    }
+    writeRecord(Record::Values);
+}
+
+void BinaryDump::Writer::typedefInfo(const TypedefInfo &info)
+{
+    putVarint(stringId(info.name));
+    putVarint(stringId(info.file));
+    putVarint(info.line);
+    putVarint(info.column);
+    putVarint(info.used ? 1 : 0);
+    writeRecord(Record::TypedefInfo);
+}
+
+void BinaryDump::Writer::xml(const std::string &text)
+{
+    putString(text);
+    writeRecord(Record::Xml);
+}
+
+void BinaryDump::Writer::endConfiguration()
+{
+    writeRecord(Record::ConfigEnd);
+}
+
+void BinaryDump::Writer::finish()
+{
+    writeRecord(Record::End);
+    mOut.flush();
+}
+
+bool BinaryDump::isBinaryDump(std::istream &in)
+{
+    const std::istream::pos_type pos = in.tellg();
+    char buf[sizeof(magic)] = {0};
+    in.read(buf, sizeof(buf));
+    const bool ret = in.gcount() == sizeof(buf) && std::memcmp(buf, magic, sizeof(magic)) == 0;
+    in.clear();
+    in.seekg(pos);
+    return ret;
+}
+
+namespace {
+    class Cursor {
+    public:
+        Cursor(const char *data, std::size_t size) : mData(data), mEnd(data + size), mError(false) {}
+
+        std::uint64_t varint() {
+            std::uint64_t value = 0;
+            int shift = 0;
+            while (mData < mEnd && shift < 64) {
+                const unsigned char c = static_cast<unsigned char>(*mData++);
+                value |= static_cast<std::uint64_t>(c & 0x7f) << shift;
+                if ((c & 0x80) == 0)
+                    return value;
+                shift += 7;
+            }
+            mError = true;
+            return 0;
+        }
+
+        std::int64_t signedVarint() {
+            const std::uint64_t value = varint();
+            return static_cast<std::int64_t>((value >> 1) ^ (~(value & 1) + 1));
+        }
+
+        /** Number of elements of a list, each element needs at least one byte */
+        std::size_t count() {
+            const std::uint64_t n = varint();
+            if (n > static_cast<std::uint64_t>(mEnd - mData)) {
+                mError = true;
+                return 0;
+            }
+            return n;
+        }
+
+        std::string string() {
+            const std::uint64_t len = varint();
+            if (len > static_cast<std::uint64_t>(mEnd - mData)) {
+                mError = true;
+                return std::string();
+            }
+            const std::string ret(mData, len);
+            mData += len;
+            return ret;
+        }
+
+        bool error() const {
+            return mError;
+        }
+
+    private:
+        const char *mData;
+        const char *mEnd;
+        bool mError;
+    };
+}
+
+static bool readVarint(std::istream &in, std::uint64_t &value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        const int c = in.get();
+        if (c == EOF)
+            return false;
+        value |= static_cast<std::uint64_t>(c & 0x7f) << shift;
+        if ((c & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
+bool BinaryDump::read(std::istream &in, Data &data, std::string &errmsg)
+{
+    char buf[sizeof(magic)] = {0};
+    in.read(buf, sizeof(buf));
+    if (in.gcount() != sizeof(buf) || std::memcmp(buf, magic, sizeof(magic)) != 0) {
+        errmsg = "not a binary dump file";
+        return false;
+    }
+    std::uint64_t fileVersion;
+    if (!readVarint(in, fileVersion) || fileVersion != version) {
+        errmsg = "unsupported binary dump version";
+        return false;
+    }
+
+    std::vector<std::string> strings;
+    std::string payload;
+    Configuration *cfg = nullptr;
+
+    for (;;) {
+        const int tag = in.get();
+        std::uint64_t len;
+        if (tag == EOF || !readVarint(in, len)) {
+            errmsg = "unexpected end of binary dump";
+            return false;
+        }
+        if (len > payload.max_size()) {
+            errmsg = "invalid record length in binary dump";
+            return false;
+        }
+        // the length is not trusted, the payload grows as it is read
+        payload.clear();
+        while (payload.size() < len) {
+            const std::size_t chunk = static_cast<std::size_t>(std::min<std::uint64_t>(len - payload.size(), 64 * 1024));
+            const std::size_t pos = payload.size();
+            payload.resize(pos + chunk);
+            in.read(&payload[pos], chunk);
+            if (static_cast<std::size_t>(in.gcount()) != chunk) {
+                errmsg = "unexpected end of binary dump";
+                return false;
+            }
+        }
+
+        Cursor cur(payload.data(), payload.size());
+        bool validString = true;
+        auto str = [&](std::uint64_t id) -> const std::string& {
+            static const std::string emptyString;
+            if (id >= strings.size()) {
+                validString = false;
+                return emptyString;
+            }
+            return strings[id];
+        };
+
+        switch (static_cast<Record>(tag)) {
+        case Record::String:
+            strings.push_back(cur.string());
+            break;
+        case Record::Platform:
+            data.platform.name = str(cur.varint());
+            data.platform.char_bit = cur.varint();
+            data.platform.short_bit = cur.varint();
+            data.platform.int_bit = cur.varint();
+            data.platform.long_bit = cur.varint();
+            data.platform.long_long_bit = cur.varint();
+            data.platform.pointer_bit = cur.varint();
+            break;
+        case Record::RawToken: {
+            RawToken rawToken;
+            rawToken.file = str(cur.varint());
+            rawToken.linenr = cur.varint();
+            rawToken.column = cur.varint();
+            rawToken.str = str(cur.varint());
+            data.rawTokens.push_back(std::move(rawToken));
+            break;
+        }
+        case Record::ConfigBegin:
+            data.configurations.emplace_back();
+            cfg = &data.configurations.back();
+            cfg->name = str(cur.varint());
+            break;
+        case Record::Token: {
+            if (!cfg) {
+                errmsg = "token outside configuration in binary dump";
+                return false;
+            }
+            Token tok;
+            tok.id = cur.varint();
+            tok.file = str(cur.varint());
+            tok.linenr = cur.varint();
+            tok.column = cur.varint();
+            tok.str = str(cur.varint());
+            tok.scope = cur.varint();
+            tok.type = static_cast<Token::Type>(cur.varint());
+            tok.flags = cur.varint();
+            const std::uint64_t presence = cur.varint();
+            if (presence & hasStrlen)
+                tok.strlen = cur.varint();
+            if (presence & hasLink)
+                tok.link = unzigzag(tok.id, cur.varint());
+            if (presence & hasVarId)
+                tok.varId = cur.varint();
+            if (presence & hasVariable)
+                tok.variable = cur.varint();
+            if (presence & hasFunction)
+                tok.function = cur.varint();
+            if (presence & hasValues)
+                tok.values = cur.varint();
+            if (presence & hasTypeScope)
+                tok.typeScope = cur.varint();
+            if (presence & hasAstParent)
+                tok.astParent = unzigzag(tok.id, cur.varint());
+            if (presence & hasAstOperand1)
+                tok.astOperand1 = unzigzag(tok.id, cur.varint());
+            if (presence & hasAstOperand2)
+                tok.astOperand2 = unzigzag(tok.id, cur.varint());
+            if (presence & hasOriginalName)
+                tok.originalName = str(cur.varint());
+            if (presence & hasValueType)
+                tok.valueType = str(cur.varint());
+            cfg->tokens.push_back(std::move(tok));
+            break;
+        }
+        case Record::Scope: {
+            if (!cfg) {
+                errmsg = "scope outside configuration in binary dump";
+                return false;
+            }
+            Scope scope;
+            scope.id = cur.varint();
+            scope.type = cur.varint();
+            scope.className = str(cur.varint());
+            scope.bodyStart = cur.varint();
+            scope.bodyEnd = cur.varint();
+            scope.nestedIn = cur.varint();
+            scope.function = cur.varint();
+            scope.valueflowSteps = cur.varint();
+            scope.valueflowTimeMs = cur.varint();
+            scope.valueflowBailout = cur.varint() != 0;
+            scope.functions.resize(cur.count());
+            for (Function &function : scope.functions) {
+                function.id = cur.varint();
+                function.token = cur.varint();
+                function.tokenDef = cur.varint();
+                function.name = str(cur.varint());
+                function.type = str(cur.varint());
+                function.flags = cur.varint();
+                function.args.resize(cur.count());
+                for (std::uint64_t &arg : function.args)
+                    arg = cur.varint();
+            }
+            scope.varlist.resize(cur.count());
+            for (std::uint64_t &var : scope.varlist)
+                var = cur.varint();
+            cfg->scopes.push_back(std::move(scope));
+            break;
+        }
+        case Record::Variable: {
+            if (!cfg) {
+                errmsg = "variable outside configuration in binary dump";
+                return false;
+            }
+            Variable var;
+            var.id = cur.varint();
+            var.nameToken = cur.varint();
+            var.typeStartToken = cur.varint();
+            var.typeEndToken = cur.varint();
+            var.access = str(cur.varint());
+            var.scope = cur.varint();
+            var.constness = cur.varint();
+            var.flags = cur.varint();
+            cfg->variables.push_back(std::move(var));
+            break;
+        }
+        case Record::Values: {
+            if (!cfg) {
+                errmsg = "values outside configuration in binary dump";
+                return false;
+            }
+            Values values;
+            values.id = cur.varint();
+            values.values.resize(cur.count());
+            for (Value &value : values.values) {
+                const std::uint64_t type = cur.varint();
+                const std::uint64_t kind = cur.varint();
+                if (type > Value::Symbolic || kind > Value::Inconclusive) {
+                    errmsg = "invalid record in binary dump";
+                    return false;
+                }
+                value.type = static_cast<Value::Type>(type);
+                value.kind = static_cast<Value::Kind>(kind);
+                switch (value.type) {
+                case Value::Tok:
+                    value.tokvalue = cur.varint();
+                    break;
+                case Value::Float: {
+                    const std::uint64_t bits = cur.varint();
+                    std::memcpy(&value.floatValue, &bits, sizeof(bits));
+                    break;
+                }
+                case Value::Moved:
+                    value.moveKind = str(cur.varint());
+                    break;
+                case Value::Uninit:
+                    break;
+                case Value::Lifetime:
+                    value.tokvalue = cur.varint();
+                    value.lifetimeScope = str(cur.varint());
+                    value.lifetimeKind = str(cur.varint());
+                    break;
+                case Value::Symbolic:
+                    value.tokvalue = cur.varint();
+                    value.intvalue = cur.signedVarint();
+                    break;
+                default:
+                    value.intvalue = cur.signedVarint();
+                    break;
+                }
+                value.bound = str(cur.varint());
+                value.conditionLine = cur.varint();
+                value.path = cur.signedVarint();
+            }
+            cfg->values.push_back(std::move(values));
+            break;
+        }
+        case Record::TypedefInfo: {
+            if (!cfg) {
+                errmsg = "typedef info outside configuration in binary dump";
+                return false;
+            }
+            TypedefInfo info;
+            info.name = str(cur.varint());
+            info.file = str(cur.varint());
+            info.line = cur.varint();
+            info.column = cur.varint();
+            info.used = cur.varint() != 0;
+            cfg->typedefInfo.push_back(std::move(info));
+            break;
+        }
+        case Record::Xml:
+            (cfg ? cfg->xml : data.xml) += cur.string();
+            break;
+        case Record::ConfigEnd:
+            cfg = nullptr;
+            break;
+        case Record::End:
+            return true;
+        default:
+            errmsg = "unknown record in binary dump";
+            return false;
+        }
+
+        if (cur.error() || !validString) {
+            errmsg = "invalid record in binary dump";
+            return false;
+        }
+    }
+}
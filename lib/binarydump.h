@@ -0,0 +1,310 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2021 Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef binarydumpH
+#define binarydumpH
+//---------------------------------------------------------------------------
+
+#include "config.h"
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief Compact binary encoding of the --dump data.
+ *
+ * The file is a sequence of records. Every record starts with a one byte
+ * tag followed by a varint payload length. Strings (token strings, file
+ * names, value types, ...) are interned: the first time a string is used
+ * a String record is emitted and later records refer to it by index. That
+ * way the file can be written in a single pass without seeking.
+ *
+ * The token list, the raw tokens, the symbol database, the valueflow
+ * values and the typedef info are stored as binary records. The remaining
+ * sections (directives, standards, suppressions) are comparatively small
+ * and are stored as xml fragments.
+ */
+namespace BinaryDump {
+    /** Version of the binary format, bump when the layout changes */
+    static const unsigned int version = 2;
+
+    enum class Record : unsigned char {
+        String = 1, Platform, RawToken, ConfigBegin, Token, Xml, ConfigEnd, End,
+        Scope, Variable, Values, TypedefInfo
+    };
+
+    struct Platform {
+        std::string name;
+        int char_bit;
+        int short_bit;
+        int int_bit;
+        int long_bit;
+        int long_long_bit;
+        int pointer_bit;
+    };
+
+    struct RawToken {
+        std::string file;
+        unsigned int linenr;
+        unsigned int column;
+        std::string str;
+    };
+
+    struct Token {
+        enum Type { Other, Name, Number, String, Char, Boolean, Op };
+
+        /** flags */
+        enum Flag : unsigned int {
+            fIsUnsigned             = (1 << 0),
+            fIsSigned               = (1 << 1),
+            fIsInt                  = (1 << 2),
+            fIsFloat                = (1 << 3),
+            fIsArithmeticalOp       = (1 << 4),
+            fIsAssignmentOp         = (1 << 5),
+            fIsComparisonOp         = (1 << 6),
+            fIsLogicalOp            = (1 << 7),
+            fIsExpandedMacro        = (1 << 8),
+            fIsSplittedVarDeclComma = (1 << 9),
+            fIsSplittedVarDeclEq    = (1 << 10),
+            fIsImplicitInt          = (1 << 11),
+            fNoreturn               = (1 << 12)
+        };
+
+        Token()
+            : id(0), linenr(0), column(0), scope(0), type(Other), flags(0), strlen(0), link(0), varId(0),
+            variable(0), function(0), values(0), typeScope(0), astParent(0), astOperand1(0), astOperand2(0) {}
+
+        bool isSet(Flag flag) const {
+            return (flags & flag) != 0;
+        }
+
+        /** The ids are the same as the addresses written in the xml dump */
+        std::uint64_t id;
+        std::string file;
+        unsigned int linenr;
+        unsigned int column;
+        std::string str;
+        std::uint64_t scope;
+        Type type;
+        unsigned int flags;
+        unsigned int strlen;
+        std::uint64_t link;
+        unsigned int varId;
+        std::uint64_t variable;
+        std::uint64_t function;
+        std::uint64_t values;
+        std::uint64_t typeScope;
+        std::uint64_t astParent;
+        std::uint64_t astOperand1;
+        std::uint64_t astOperand2;
+        std::string originalName;
+        /** ValueType::dump() output */
+        std::string valueType;
+    };
+
+    struct Function {
+        /** flags */
+        enum Flag : unsigned int {
+            fHasVirtualSpecifier = (1 << 0),
+            fIsImplicitlyVirtual = (1 << 1),
+            fIsInlineKeyword     = (1 << 2),
+            fIsStatic            = (1 << 3)
+        };
+
+        Function() : id(0), token(0), tokenDef(0), flags(0) {}
+
+        bool isSet(Flag flag) const {
+            return (flags & flag) != 0;
+        }
+
+        std::uint64_t id;
+        std::uint64_t token;
+        std::uint64_t tokenDef;
+        std::string name;
+        /** "Constructor", "Function", ... same as in the xml dump */
+        std::string type;
+        unsigned int flags;
+        /** ids of the argument variables */
+        std::vector<std::uint64_t> args;
+    };
+
+    struct Scope {
+        Scope()
+            : id(0), type(0), bodyStart(0), bodyEnd(0), nestedIn(0), function(0),
+            valueflowSteps(0), valueflowTimeMs(0), valueflowBailout(false) {}
+
+        std::uint64_t id;
+        /** Scope::ScopeType */
+        unsigned int type;
+        std::string className;
+        std::uint64_t bodyStart;
+        std::uint64_t bodyEnd;
+        std::uint64_t nestedIn;
+        std::uint64_t function;
+        std::uint64_t valueflowSteps;
+        std::uint64_t valueflowTimeMs;
+        bool valueflowBailout;
+        std::vector<Function> functions;
+        /** ids of the variables in the scope */
+        std::vector<std::uint64_t> varlist;
+    };
+
+    struct Variable {
+        /** flags */
+        enum Flag : unsigned int {
+            fIsArray     = (1 << 0),
+            fIsClass     = (1 << 1),
+            fIsConst     = (1 << 2),
+            fIsExtern    = (1 << 3),
+            fIsPointer   = (1 << 4),
+            fIsReference = (1 << 5),
+            fIsStatic    = (1 << 6),
+            fIsVolatile  = (1 << 7),
+            fHasConstness = (1 << 8)
+        };
+
+        Variable() : id(0), nameToken(0), typeStartToken(0), typeEndToken(0), scope(0), constness(0), flags(0) {}
+
+        bool isSet(Flag flag) const {
+            return (flags & flag) != 0;
+        }
+
+        std::uint64_t id;
+        std::uint64_t nameToken;
+        std::uint64_t typeStartToken;
+        std::uint64_t typeEndToken;
+        std::string access;
+        std::uint64_t scope;
+        /** ValueType::constness, only valid if fHasConstness is set */
+        unsigned int constness;
+        unsigned int flags;
+    };
+
+    struct Value {
+        enum Type { Int, Tok, Float, Moved, Uninit, BufferSize, ContainerSize, IteratorStart, IteratorEnd, Lifetime, Symbolic };
+        enum Kind { Known, Possible, Impossible, Inconclusive };
+
+        Value() : type(Int), kind(Possible), intvalue(0), tokvalue(0), floatValue(0), conditionLine(0), path(0) {}
+
+        Type type;
+        Kind kind;
+        std::int64_t intvalue;
+        std::uint64_t tokvalue;
+        double floatValue;
+        /** move kind of a Moved value */
+        std::string moveKind;
+        /** lifetime scope and kind of a Lifetime value */
+        std::string lifetimeScope;
+        std::string lifetimeKind;
+        std::string bound;
+        /** line of the condition, 0 if there is no condition */
+        unsigned int conditionLine;
+        std::int64_t path;
+    };
+
+    /** The values of a token, the id is the values id of the token */
+    struct Values {
+        Values() : id(0) {}
+
+        std::uint64_t id;
+        std::vector<Value> values;
+    };
+
+    struct TypedefInfo {
+        TypedefInfo() : line(0), column(0), used(false) {}
+
+        std::string name;
+        std::string file;
+        unsigned int line;
+        unsigned int column;
+        bool used;
+    };
+
+    struct Configuration {
+        std::string name;
+        std::vector<Token> tokens;
+        std::vector<Scope> scopes;
+        std::vector<Variable> variables;
+        std::vector<Values> values;
+        std::vector<TypedefInfo> typedefInfo;
+        std::string xml;
+    };
+
+    struct Data {
+        Platform platform;
+        std::vector<RawToken> rawTokens;
+        /** xml fragments that are not bound to a configuration (suppressions) */
+        std::string xml;
+        std::vector<Configuration> configurations;
+    };
+
+    /** Write dump records to a stream that is opened in binary mode */
+    class CPPCHECKLIB Writer {
+    public:
+        explicit Writer(std::ostream &out);
+
+        void platform(const Platform &platform);
+        void rawToken(const std::string &file, unsigned int linenr, unsigned int column, const std::string &str);
+        void beginConfiguration(const std::string &cfg);
+        void token(const Token &tok);
+        void scope(const Scope &scope);
+        void variable(const Variable &var);
+        void values(const Values &values);
+        void typedefInfo(const TypedefInfo &info);
+        void xml(const std::string &text);
+        void endConfiguration();
+        void finish();
+
+    private:
+        unsigned int stringId(const std::string &s);
+        void writeRecord(Record record);
+        void putVarint(std::uint64_t value);
+        void putSigned(std::int64_t value);
+        void putString(const std::string &s);
+
+        std::ostream &mOut;
+        std::unordered_map<std::string, unsigned int> mStrings;
+        /** payload of the record that is currently written, reused between records */
+        std::string mPayload;
+        std::string mHeader;
+    };
+
+    /** Does the stream start with the binary dump magic? The stream position is restored. */
+    CPPCHECKLIB bool isBinaryDump(std::istream &in);
+
+    /**
+     * Read a binary dump.
+     * @param in     stream opened in binary mode
+     * @param data   the loaded data
+     * @param errmsg error message if the dump can't be read
+     * @return true on success
+     */
+    CPPCHECKLIB bool read(std::istream &in, Data &data, std::string &errmsg);
+}
+
+/// @}
+//---------------------------------------------------------------------------
+#endif // binarydumpH
@@ -22,10 +22,14 @@
 
 #include "errorlogger.h"
 #include "settings.h"
+#include "symboldatabase.h"
 #include "tokenize.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <iostream>
+#include <thread>
 
 //---------------------------------------------------------------------------
 
@@ -85,6 +89,100 @@ std::list<Check *> &Check::instances()
 #endif
 }
 
+namespace {
+    /**
+     * Threads that are started by whole program tasks. Nested task runs
+     * (the checks split their own work into tasks) get the jobs that are
+     * left over, so no more than jobs threads are busy at the same time.
+     */
+    std::atomic<int> wholeProgramThreads(0);
+
+    int reserveThreads(int jobs, std::size_t wanted)
+    {
+        int running = wholeProgramThreads.load();
+        for (;;) {
+            const int count = std::min<int>(std::max(jobs - 1 - running, 0), static_cast<int>(wanted));
+            if (count == 0 || wholeProgramThreads.compare_exchange_weak(running, running + count))
+                return count;
+        }
+    }
+}
+
+bool Check::runWholeProgramTasks(const std::vector<WholeProgramTask> &tasks, int jobs, ErrorLogger &errorLogger)
+{
+    bool foundErrors = false;
+    const int threadCount = (tasks.size() <= 1) ? 0 : reserveThreads(jobs, tasks.size() - 1);
+    if (threadCount == 0) {
+        for (const WholeProgramTask &task : tasks)
+            foundErrors |= task(errorLogger);
+        return foundErrors;
+    }
+
+    std::vector<ErrorBuffer> buffers(tasks.size());
+    std::vector<char> results(tasks.size(), 0);
+    std::atomic<std::size_t> next(0);
+    auto worker = [&]() {
+        for (std::size_t i = next++; i < tasks.size(); i = next++)
+            results[i] = tasks[i](buffers[i]);
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back([&worker]() {
+            worker();
+            // the thread is idle, nested runs may use it
+            --wholeProgramThreads;
+        });
+    }
+    worker();
+    for (std::thread &t : threads)
+        t.join();
+
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        foundErrors |= (results[i] != 0);
+        for (const ErrorMessage &errmsg : buffers[i].errors)
+            errorLogger.reportErr(errmsg);
+    }
+    return foundErrors;
+}
+
+bool Check::runWholeProgramItems(const std::vector<std::string> &keys, const std::function<bool(std::size_t, ErrorLogger &)> &analyse, int jobs, ErrorLogger &errorLogger)
+{
+    bool foundErrors = false;
+    if (jobs <= 1 || keys.size() <= 1) {
+        for (std::size_t i = 0; i < keys.size(); ++i)
+            foundErrors |= analyse(i, errorLogger);
+        return foundErrors;
+    }
+
+    // partition the items by key, each item gets its own error buffer
+    const std::size_t partitions = std::min<std::size_t>(jobs, keys.size());
+    std::vector<std::vector<std::size_t>> items(partitions);
+    const std::hash<std::string> hash;
+    for (std::size_t i = 0; i < keys.size(); ++i)
+        items[hash(keys[i]) % partitions].push_back(i);
+
+    std::vector<ErrorBuffer> buffers(keys.size());
+    std::vector<WholeProgramTask> tasks;
+    for (const std::vector<std::size_t> &part : items) {
+        if (part.empty())
+            continue;
+        tasks.emplace_back([&analyse, &buffers, &part](ErrorLogger & /*logger*/) {
+            bool found = false;
+            for (std::size_t i : part)
+                found |= analyse(i, buffers[i]);
+            return found;
+        });
+    }
+    foundErrors = runWholeProgramTasks(tasks, jobs, errorLogger);
+
+    for (const ErrorBuffer &buffer : buffers) {
+        for (const ErrorMessage &errmsg : buffer.errors)
+            errorLogger.reportErr(errmsg);
+    }
+    return foundErrors;
+}
+
 std::string Check::getMessageId(const ValueFlow::Value &value, const char id[])
 {
     if (value.condition != nullptr)
@@ -111,3 +209,100 @@ ErrorPath Check::getErrorPath(const Token* errtok, const ValueFlow::Value* value
     }
     return errorPath;
 }
+
+//---------------------------------------------------------------------------
+
+CheckVisitor::CheckVisitor()
+    : mTokenTypeHandlers(Token::eNone + 1)
+{}
+
+void CheckVisitor::onFunctionScope(const ScopeHandler &handler)
+{
+    mScopeHandlers.push_back(handler);
+}
+
+void CheckVisitor::onToken(const TokenHandler &handler)
+{
+    mTokenHandlers.push_back(handler);
+}
+
+void CheckVisitor::onTokenType(Token::Type type, const TokenHandler &handler)
+{
+    mTokenTypeHandlers[type].push_back(handler);
+}
+
+void CheckVisitor::onOperator(const std::string &op, const TokenHandler &handler)
+{
+    mOperatorHandlers[op].push_back(handler);
+}
+
+void CheckVisitor::onFunctionCall(const TokenHandler &handler)
+{
+    mFunctionCallHandlers.push_back(handler);
+}
+
+bool CheckVisitor::empty() const
+{
+    for (const std::vector<TokenHandler> &handlers : mTokenTypeHandlers) {
+        if (!handlers.empty())
+            return false;
+    }
+    return mScopeHandlers.empty() && mTokenHandlers.empty() && mOperatorHandlers.empty() && mFunctionCallHandlers.empty();
+}
+
+static bool isFunctionCall(const Token *tok)
+{
+    return tok->isName() &&
+           tok->next() &&
+           tok->next()->str() == "(" &&
+           !Token::Match(tok, "if|for|while|switch|return|sizeof|catch|throw|decltype|typeof|alignof");
+}
+
+void CheckVisitor::run(const Tokenizer *tokenizer)
+{
+    mFunctionScopes.clear();
+    if (empty())
+        return;
+
+    for (const Token *tok = tokenizer->tokens(); tok; tok = tok->next()) {
+        if (tok->str() == "{" && tok->scope() && tok->scope()->bodyStart == tok && tok->scope()->type == Scope::eFunction) {
+            mFunctionScopes.push_back(tok->scope());
+            for (const ScopeHandler &handler : mScopeHandlers)
+                handler(tok->scope());
+        } else if (!mFunctionScopes.empty() && tok == mFunctionScopes.back()->bodyEnd) {
+            mFunctionScopes.pop_back();
+        }
+
+        for (const TokenHandler &handler : mTokenHandlers)
+            handler(tok);
+        for (const TokenHandler &handler : mTokenTypeHandlers[tok->tokType()])
+            handler(tok);
+        if (tok->isOp() && !mOperatorHandlers.empty()) {
+            const std::unordered_map<std::string, std::vector<TokenHandler>>::const_iterator it = mOperatorHandlers.find(tok->str());
+            if (it != mOperatorHandlers.end()) {
+                for (const TokenHandler &handler : it->second)
+                    handler(tok);
+            }
+        }
+        if (!mFunctionCallHandlers.empty() && isFunctionCall(tok)) {
+            for (const TokenHandler &handler : mFunctionCallHandlers)
+                handler(tok);
+        }
+    }
+    mFunctionScopes.clear();
+}
+
+ErrorLogger *CheckVisitor::errorLogger(const std::string &name)
+{
+    return &mErrorBuffers[name];
+}
+
+void CheckVisitor::reportErrors(const std::string &name, ErrorLogger *errorLogger)
+{
+    const std::map<std::string, ErrorBuffer>::iterator it = mErrorBuffers.find(name);
+    if (it == mErrorBuffers.end())
+        return;
+    for (const ErrorMessage &errmsg : it->second.errors)
+        errorLogger->reportErr(errmsg);
+    it->second.errors.clear();
+}
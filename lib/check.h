@@ -22,10 +22,16 @@
 //---------------------------------------------------------------------------
 
 #include "config.h"
+#include "errorlogger.h"
 #include "errortypes.h"
+#include "token.h"
 
+#include <functional>
 #include <list>
+#include <map>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace tinyxml2 {
     class XMLElement;
@@ -39,10 +45,9 @@ namespace ValueFlow {
     class Value;
 }
 
+class CheckVisitor;
 class Settings;
-class Token;
-class ErrorLogger;
-class ErrorMessage;
+class Scope;
 class Tokenizer;
 
 /** Use WRONG_DATA in checkers to mark conditions that check that data is correct */
@@ -75,6 +80,29 @@ public:
     /** run checks, the token list is not simplified */
     virtual void runChecks(const Tokenizer *, const Settings *, ErrorLogger *) = 0;
 
+    /**
+     * @brief Register handlers for the single pass traversal of the token
+     * list, see CheckVisitor. The traversal is done before
+     * runChecksAfterVisit() is called.
+     */
+    virtual void addVisitorHandlers(CheckVisitor &visitor, const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger) {
+        (void)visitor;
+        (void)tokenizer;
+        (void)settings;
+        (void)errorLogger;
+    }
+
+    /**
+     * @brief run checks after the single pass traversal. Checks that are
+     * ported to the visitor report the buffered errors with
+     * CheckVisitor::reportErrors() where runChecks() used to execute them,
+     * so the order of the errors does not change.
+     */
+    virtual void runChecksAfterVisit(const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger, CheckVisitor &visitor) {
+        (void)visitor;
+        runChecks(tokenizer, settings, errorLogger);
+    }
+
     /** get error messages */
     virtual void getErrorMessages(ErrorLogger *errorLogger, const Settings *settings) const = 0;
 
@@ -109,6 +137,20 @@ public:
         return nullptr;
     }
 
+    /**
+     * Is the whole program analysis of this check enabled with the given
+     * settings? If not then getFileInfo() is not called.
+     */
+    virtual bool isWholeProgramEnabled(const Settings *settings) const {
+        (void)settings;
+        return true;
+    }
+
+    /** Does analyseWholeProgram() use the CTU::FileInfo? */
+    virtual bool usesCtuFileInfo() const {
+        return false;
+    }
+
     virtual FileInfo * loadFileInfoFromXml(const tinyxml2::XMLElement *xmlElement) const {
         (void)xmlElement;
         return nullptr;
@@ -123,6 +165,33 @@ public:
         return false;
     }
 
+    /** A part of the whole program analysis, reports errors to the given logger */
+    using WholeProgramTask = std::function<bool(ErrorLogger &)>;
+
+    /**
+     * Run whole program analysis tasks on up to jobs threads. Each task
+     * reports to its own buffer and the buffered errors are reported in
+     * task order afterwards, so the output is the same as when the tasks
+     * are executed sequentially. Nested runs only use the jobs that are
+     * left over by the enclosing run. Without spare jobs the tasks are
+     * executed sequentially without buffering.
+     * @return true if any task returned true
+     */
+    static bool runWholeProgramTasks(const std::vector<WholeProgramTask> &tasks, int jobs, ErrorLogger &errorLogger);
+
+    /**
+     * Run a whole program analysis step for each item. The items are
+     * partitioned by key, all items with the same key are analysed by the
+     * same task. The errors are reported in item order, so the output is
+     * the same as a sequential run.
+     * @param keys      partition key of each item, e.g. the function id
+     * @param analyse   analyse the item with the given index
+     * @param jobs      number of jobs
+     * @param errorLogger where the errors are reported
+     * @return true if analyse returned true for any item
+     */
+    static bool runWholeProgramItems(const std::vector<std::string> &keys, const std::function<bool(std::size_t, ErrorLogger &)> &analyse, int jobs, ErrorLogger &errorLogger);
+
     static std::string getMessageId(const ValueFlow::Value &value, const char id[]);
 
 protected:
@@ -166,6 +235,87 @@ private:
     const std::string mName;
 };
 
+/**
+ * @brief Error logger that keeps the reported errors.
+ *
+ * Used where the errors are produced out of order, e.g. by worker threads
+ * or by the visitor handlers, and must be reported later in a fixed order.
+ */
+class CPPCHECKLIB ErrorBuffer : public ErrorLogger {
+public:
+    void reportOut(const std::string &outmsg, Color /*c*/ = Color::Reset) OVERRIDE {
+        (void)outmsg;
+    }
+    void reportErr(const ErrorMessage &msg) OVERRIDE {
+        errors.push_back(msg);
+    }
+    void bughuntingReport(const std::string & /*str*/) OVERRIDE {}
+
+    /** the reported errors */
+    std::vector<ErrorMessage> errors;
+};
+
+/**
+ * @brief Single pass traversal of the token list for many checks.
+ *
+ * Checks that loop over the whole token list or over the function bodies
+ * can register handlers instead, in Check::addVisitorHandlers(). Then the
+ * token list is traversed once and each token is dispatched to the
+ * handlers that are interested in it.
+ *
+ * The handlers report to errorLogger(name). The errors are kept until the
+ * check reports them with reportErrors(name) in runChecksAfterVisit().
+ */
+class CPPCHECKLIB CheckVisitor {
+public:
+    using TokenHandler = std::function<void(const Token *)>;
+    using ScopeHandler = std::function<void(const Scope *)>;
+
+    CheckVisitor();
+
+    /** Handler is called when a function body is entered */
+    void onFunctionScope(const ScopeHandler &handler);
+
+    /** Handler is called for every token */
+    void onToken(const TokenHandler &handler);
+
+    /** Handler is called for tokens with the given type */
+    void onTokenType(Token::Type type, const TokenHandler &handler);
+
+    /** Handler is called for operator tokens with the given string, e.g. "<<" */
+    void onOperator(const std::string &op, const TokenHandler &handler);
+
+    /** Handler is called for the name token of function calls ("%name% (" that is not a keyword) */
+    void onFunctionCall(const TokenHandler &handler);
+
+    /** Is there any handler? */
+    bool empty() const;
+
+    /** Innermost function scope of the visited token, nullptr outside of function bodies */
+    const Scope *functionScope() const {
+        return mFunctionScopes.empty() ? nullptr : mFunctionScopes.back();
+    }
+
+    /** Traverse the token list and call the handlers */
+    void run(const Tokenizer *tokenizer);
+
+    /** Error logger that buffers the errors of the given ported check */
+    ErrorLogger *errorLogger(const std::string &name);
+
+    /** Report the buffered errors of the given ported check */
+    void reportErrors(const std::string &name, ErrorLogger *errorLogger);
+
+private:
+    std::map<std::string, ErrorBuffer> mErrorBuffers;
+
+    std::vector<ScopeHandler> mScopeHandlers;
+    std::vector<TokenHandler> mTokenHandlers;
+    std::vector<std::vector<TokenHandler>> mTokenTypeHandlers;
+    std::unordered_map<std::string, std::vector<TokenHandler>> mOperatorHandlers;
+    std::vector<TokenHandler> mFunctionCallHandlers;
+    std::vector<const Scope *> mFunctionScopes;
+};
+
 /// @}
 //---------------------------------------------------------------------------
 #endif //  checkH
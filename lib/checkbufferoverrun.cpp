@@ -877,6 +877,11 @@ bool CheckBufferOverrun::isCtuUnsafePointerArith(const Check *check, const Token
     return CheckBufferOverrun::isCtuUnsafeBufferUsage(check, argtok, offset, 2);
 }
 
+bool CheckBufferOverrun::isWholeProgramEnabled(const Settings *settings) const
+{
+    return settings->maxCtuDepth > 0;
+}
+
 /** @brief Parse current TU and extract file info */
 Check::FileInfo *CheckBufferOverrun::getFileInfo(const Tokenizer *tokenizer, const Settings *settings) const
 {
@@ -917,21 +922,29 @@ bool CheckBufferOverrun::analyseWholeProgram(const CTU::FileInfo *ctu, const std
 {
     if (!ctu)
         return false;
-    bool foundErrors = false;
-    (void)settings; // This argument is unused
 
     const std::map<std::string, std::list<const CTU::FileInfo::CallBase *>> callsMap = ctu->getCallsMap();
 
+    // the unsafe usages are partitioned by the function they are in
+    std::vector<std::pair<const CTU::FileInfo::UnsafeUsage *, int>> usages;
+    std::vector<std::string> keys;
     for (Check::FileInfo *fi1 : fileInfo) {
         const MyFileInfo *fi = dynamic_cast<MyFileInfo*>(fi1);
         if (!fi)
             continue;
-        for (const CTU::FileInfo::UnsafeUsage &unsafeUsage : fi->unsafeArrayIndex)
-            foundErrors |= analyseWholeProgram1(callsMap, unsafeUsage, 1, errorLogger);
-        for (const CTU::FileInfo::UnsafeUsage &unsafeUsage : fi->unsafePointerArith)
-            foundErrors |= analyseWholeProgram1(callsMap, unsafeUsage, 2, errorLogger);
+        for (const CTU::FileInfo::UnsafeUsage &unsafeUsage : fi->unsafeArrayIndex) {
+            usages.emplace_back(&unsafeUsage, 1);
+            keys.push_back(unsafeUsage.myId);
+        }
+        for (const CTU::FileInfo::UnsafeUsage &unsafeUsage : fi->unsafePointerArith) {
+            usages.emplace_back(&unsafeUsage, 2);
+            keys.push_back(unsafeUsage.myId);
+        }
     }
-    return foundErrors;
+
+    return runWholeProgramItems(keys, [&](std::size_t i, ErrorLogger &logger) {
+        return analyseWholeProgram1(callsMap, *usages[i].first, usages[i].second, logger);
+    }, settings.jobs, errorLogger);
 }
 
 bool CheckBufferOverrun::analyseWholeProgram1(const std::map<std::string, std::list<const CTU::FileInfo::CallBase *>> &callsMap, const CTU::FileInfo::UnsafeUsage &unsafeUsage, int type, ErrorLogger &errorLogger)
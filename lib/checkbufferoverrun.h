@@ -91,6 +91,13 @@ public:
     /** @brief Parse current TU and extract file info */
     Check::FileInfo *getFileInfo(const Tokenizer *tokenizer, const Settings *settings) const OVERRIDE;
 
+    /** @brief The CTU analysis is disabled when max-ctu-depth is 0 */
+    bool isWholeProgramEnabled(const Settings *settings) const OVERRIDE;
+
+    bool usesCtuFileInfo() const OVERRIDE {
+        return true;
+    }
+
     /** @brief Analyse all file infos for all TU */
     bool analyseWholeProgram(const CTU::FileInfo *ctu, const std::list<Check::FileInfo*> &fileInfo, const Settings& settings, ErrorLogger &errorLogger) OVERRIDE;
 
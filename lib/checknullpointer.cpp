@@ -539,6 +539,11 @@ static bool isUnsafeUsage(const Check *check, const Token *vartok, MathLib::bigi
     return checkNullPointer && checkNullPointer->isPointerDeRef(vartok, unknown);
 }
 
+bool CheckNullPointer::isWholeProgramEnabled(const Settings *settings) const
+{
+    return settings->maxCtuDepth > 0;
+}
+
 Check::FileInfo *CheckNullPointer::getFileInfo(const Tokenizer *tokenizer, const Settings *settings) const
 {
     CheckNullPointer check(tokenizer, settings, nullptr);
@@ -566,43 +571,47 @@ bool CheckNullPointer::analyseWholeProgram(const CTU::FileInfo *ctu, const std::
 {
     if (!ctu)
         return false;
-    bool foundErrors = false;
-    (void)settings; // This argument is unused
 
     const std::map<std::string, std::list<const CTU::FileInfo::CallBase *>> callsMap = ctu->getCallsMap();
 
+    // the unsafe usages are partitioned by the function they are in
+    std::vector<const CTU::FileInfo::UnsafeUsage *> usages;
+    std::vector<std::string> keys;
     for (Check::FileInfo *fi1 : fileInfo) {
         const MyFileInfo *fi = dynamic_cast<MyFileInfo*>(fi1);
         if (!fi)
             continue;
         for (const CTU::FileInfo::UnsafeUsage &unsafeUsage : fi->unsafeUsage) {
-            for (int warning = 0; warning <= 1; warning++) {
-                if (warning == 1 && !settings.severity.isEnabled(Severity::warning))
-                    break;
+            usages.push_back(&unsafeUsage);
+            keys.push_back(unsafeUsage.myId);
+        }
+    }
 
-                const std::list<ErrorMessage::FileLocation> &locationList =
-                    CTU::FileInfo::getErrorPath(CTU::FileInfo::InvalidValueType::null,
-                                                unsafeUsage,
-                                                callsMap,
-                                                "Dereferencing argument ARG that is null",
-                                                nullptr,
-                                                warning);
-                if (locationList.empty())
-                    continue;
+    return runWholeProgramItems(keys, [&](std::size_t i, ErrorLogger &logger) {
+        const CTU::FileInfo::UnsafeUsage &unsafeUsage = *usages[i];
+        for (int warning = 0; warning <= 1; warning++) {
+            if (warning == 1 && !settings.severity.isEnabled(Severity::warning))
+                break;
 
-                const ErrorMessage errmsg(locationList,
-                                          emptyString,
-                                          warning ? Severity::warning : Severity::error,
-                                          "Null pointer dereference: " + unsafeUsage.myArgumentName,
-                                          "ctunullpointer",
-                                          CWE_NULL_POINTER_DEREFERENCE, Certainty::normal);
-                errorLogger.reportErr(errmsg);
+            const std::list<ErrorMessage::FileLocation> &locationList =
+                CTU::FileInfo::getErrorPath(CTU::FileInfo::InvalidValueType::null,
+                                            unsafeUsage,
+                                            callsMap,
+                                            "Dereferencing argument ARG that is null",
+                                            nullptr,
+                                            warning);
+            if (locationList.empty())
+                continue;
 
-                foundErrors = true;
-                break;
-            }
+            const ErrorMessage errmsg(locationList,
+                                      emptyString,
+                                      warning ? Severity::warning : Severity::error,
+                                      "Null pointer dereference: " + unsafeUsage.myArgumentName,
+                                      "ctunullpointer",
+                                      CWE_NULL_POINTER_DEREFERENCE, Certainty::normal);
+            logger.reportErr(errmsg);
+            return true;
         }
-    }
-
-    return foundErrors;
+        return false;
+    }, settings.jobs, errorLogger);
 }
@@ -109,6 +109,13 @@ public:
     /** @brief Parse current TU and extract file info */
     Check::FileInfo *getFileInfo(const Tokenizer *tokenizer, const Settings *settings) const OVERRIDE;
 
+    /** @brief The CTU analysis is disabled when max-ctu-depth is 0 */
+    bool isWholeProgramEnabled(const Settings *settings) const OVERRIDE;
+
+    bool usesCtuFileInfo() const OVERRIDE {
+        return true;
+    }
+
     Check::FileInfo * loadFileInfoFromXml(const tinyxml2::XMLElement *xmlElement) const OVERRIDE;
 
     /** @brief Analyse all file infos for all TU */
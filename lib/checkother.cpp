@@ -36,6 +36,7 @@
 #include <algorithm> // find_if()
 #include <list>
 #include <map>
+#include <memory>
 #include <utility>
 #include <cctype>
 //---------------------------------------------------------------------------
@@ -66,6 +67,49 @@ static const struct CWE CWE758(758U);   // Reliance on Undefined, Unspecified, o
 static const struct CWE CWE768(768U);   // Incorrect Short Circuit Evaluation
 static const struct CWE CWE783(783U);   // Operator Precedence Logic Error
 
+void CheckOther::addVisitorHandlers(CheckVisitor &visitor, const Tokenizer *tokenizer, const Settings *settings, ErrorLogger * /*errorLogger*/)
+{
+    // Each ported check reports into its own buffer, runChecksAfterVisit()
+    // reports the errors where the check used to be executed
+    const auto check = [&](const char name[]) {
+        return std::make_shared<CheckOther>(tokenizer, settings, visitor.errorLogger(name));
+    };
+
+    const std::shared_ptr<CheckOther> zeroDivision = check("CheckOther::checkZeroDivision");
+    for (const char *op : { "/", "%", "/=", "%=" }) {
+        visitor.onOperator(op, [zeroDivision](const Token *tok) {
+            zeroDivision->checkZeroDivision(tok);
+        });
+    }
+
+    const std::shared_ptr<CheckOther> negativeBitwiseShift = check("CheckOther::checkNegativeBitwiseShift");
+    const bool portability = settings->severity.isEnabled(Severity::portability);
+    for (const char *op : { "<<", ">>", "<<=", ">>=" }) {
+        visitor.onOperator(op, [negativeBitwiseShift, portability](const Token *tok) {
+            negativeBitwiseShift->checkNegativeBitwiseShift(tok, portability);
+        });
+    }
+
+    if (settings->severity.isEnabled(Severity::style)) {
+        const std::shared_ptr<CheckOther> nanInArithmeticExpression = check("CheckOther::checkNanInArithmeticExpression");
+        visitor.onOperator("/", [nanInArithmeticExpression](const Token *tok) {
+            nanInArithmeticExpression->checkNanInArithmeticExpression(tok);
+        });
+        const std::shared_ptr<CheckOther> moduloOfOne = check("CheckOther::checkModuloOfOne");
+        visitor.onOperator("%", [moduloOfOne](const Token *tok) {
+            moduloOfOne->checkModuloOfOne(tok);
+        });
+    }
+
+    if (settings->severity.isEnabled(Severity::warning)) {
+        const std::shared_ptr<CheckOther> comparisonFunction = check("CheckOther::checkComparisonFunctionIsAlwaysTrueOrFalse");
+        visitor.onFunctionCall([comparisonFunction, &visitor](const Token *tok) {
+            if (visitor.functionScope())
+                comparisonFunction->checkComparisonFunctionIsAlwaysTrueOrFalse(tok);
+        });
+    }
+}
+
 //----------------------------------------------------------------------------------
 // The return value of fgetc(), getc(), ungetc(), getchar() etc. is an integer value.
 // If this return value is stored in a character variable and then compared
@@ -1819,21 +1863,17 @@ void CheckOther::constStatementError(const Token *tok, const std::string &type,
 //---------------------------------------------------------------------------
 // Detect division by zero.
 //---------------------------------------------------------------------------
-void CheckOther::checkZeroDivision()
+void CheckOther::checkZeroDivision(const Token *tok)
 {
-    for (const Token *tok = mTokenizer->tokens(); tok; tok = tok->next()) {
-        if (!tok->astOperand2() || !tok->astOperand1())
-            continue;
-        if (tok->str() != "%" && tok->str() != "/" && tok->str() != "%=" && tok->str() != "/=")
-            continue;
-        if (!tok->valueType() || !tok->valueType()->isIntegral())
-            continue;
+    if (!tok->astOperand2() || !tok->astOperand1())
+        return;
+    if (!tok->valueType() || !tok->valueType()->isIntegral())
+        return;
 
-        // Value flow..
-        const ValueFlow::Value *value = tok->astOperand2()->getValue(0LL);
-        if (value && mSettings->isEnabled(value, false))
-            zerodivError(tok, value);
-    }
+    // Value flow..
+    const ValueFlow::Value *value = tok->astOperand2()->getValue(0LL);
+    if (value && mSettings->isEnabled(value, false))
+        zerodivError(tok, value);
 }
 
 void CheckOther::zerodivError(const Token *tok, const ValueFlow::Value *value)
@@ -1865,18 +1905,12 @@ void CheckOther::zerodivError(const Token *tok, const ValueFlow::Value *value)
 // double d = 1.0 / 0.0 + 100.0;
 //---------------------------------------------------------------------------
 
-void CheckOther::checkNanInArithmeticExpression()
+void CheckOther::checkNanInArithmeticExpression(const Token *tok)
 {
-    if (!mSettings->severity.isEnabled(Severity::style))
+    if (!Token::Match(tok->astParent(), "[+-]"))
         return;
-    for (const Token *tok = mTokenizer->tokens(); tok; tok = tok->next()) {
-        if (tok->str() != "/")
-            continue;
-        if (!Token::Match(tok->astParent(), "[+-]"))
-            continue;
-        if (Token::simpleMatch(tok->astOperand2(), "0.0"))
-            nanInArithmeticExpressionError(tok);
-    }
+    if (Token::simpleMatch(tok->astOperand2(), "0.0"))
+        nanInArithmeticExpressionError(tok);
 }
 
 void CheckOther::nanInArithmeticExpressionError(const Token *tok)
@@ -2387,30 +2421,22 @@ void CheckOther::selfAssignmentError(const Token *tok, const std::string &varnam
 // Reference:
 // - http://www.cplusplus.com/reference/cmath/
 //-----------------------------------------------------------------------------
-void CheckOther::checkComparisonFunctionIsAlwaysTrueOrFalse()
-{
-    if (!mSettings->severity.isEnabled(Severity::warning))
-        return;
-
-    const SymbolDatabase *symbolDatabase = mTokenizer->getSymbolDatabase();
-    for (const Scope * scope : symbolDatabase->functionScopes) {
-        for (const Token* tok = scope->bodyStart->next(); tok != scope->bodyEnd; tok = tok->next()) {
-            if (tok->isName() && Token::Match(tok, "isgreater|isless|islessgreater|isgreaterequal|islessequal ( %var% , %var% )")) {
-                const int varidLeft = tok->tokAt(2)->varId();// get the left varid
-                const int varidRight = tok->tokAt(4)->varId();// get the right varid
-                // compare varids: if they are not zero but equal
-                // --> the comparison function is called with the same variables
-                if (varidLeft == varidRight) {
-                    const std::string& functionName = tok->str(); // store function name
-                    const std::string& varNameLeft = tok->strAt(2); // get the left variable name
-                    if (functionName == "isgreater" || functionName == "isless" || functionName == "islessgreater") {
-                        // e.g.: isgreater(x,x) --> (x)>(x) --> false
-                        checkComparisonFunctionIsAlwaysTrueOrFalseError(tok, functionName, varNameLeft, false);
-                    } else { // functionName == "isgreaterequal" || functionName == "islessequal"
-                        // e.g.: isgreaterequal(x,x) --> (x)>=(x) --> true
-                        checkComparisonFunctionIsAlwaysTrueOrFalseError(tok, functionName, varNameLeft, true);
-                    }
-                }
+void CheckOther::checkComparisonFunctionIsAlwaysTrueOrFalse(const Token *tok)
+{
+    if (Token::Match(tok, "isgreater|isless|islessgreater|isgreaterequal|islessequal ( %var% , %var% )")) {
+        const int varidLeft = tok->tokAt(2)->varId();// get the left varid
+        const int varidRight = tok->tokAt(4)->varId();// get the right varid
+        // compare varids: if they are not zero but equal
+        // --> the comparison function is called with the same variables
+        if (varidLeft == varidRight) {
+            const std::string& functionName = tok->str(); // store function name
+            const std::string& varNameLeft = tok->strAt(2); // get the left variable name
+            if (functionName == "isgreater" || functionName == "isless" || functionName == "islessgreater") {
+                // e.g.: isgreater(x,x) --> (x)>(x) --> false
+                checkComparisonFunctionIsAlwaysTrueOrFalseError(tok, functionName, varNameLeft, false);
+            } else { // functionName == "isgreaterequal" || functionName == "islessequal"
+                // e.g.: isgreaterequal(x,x) --> (x)>=(x) --> true
+                checkComparisonFunctionIsAlwaysTrueOrFalseError(tok, functionName, varNameLeft, true);
             }
         }
     }
@@ -2606,41 +2632,29 @@ static bool isNegative(const Token *tok, const Settings *settings)
     return tok->valueType() && tok->valueType()->sign == ValueType::SIGNED && tok->getValueLE(-1LL, settings);
 }
 
-void CheckOther::checkNegativeBitwiseShift()
+void CheckOther::checkNegativeBitwiseShift(const Token *tok, bool portability)
 {
-    const bool portability = mSettings->severity.isEnabled(Severity::portability);
-
-    for (const Token* tok = mTokenizer->tokens(); tok; tok = tok->next()) {
-        if (!tok->astOperand1() || !tok->astOperand2())
-            continue;
-
-        if (!Token::Match(tok, "<<|>>|<<=|>>="))
-            continue;
-
-        // don't warn if lhs is a class. this is an overloaded operator then
-        if (mTokenizer->isCPP()) {
-            const ValueType * lhsType = tok->astOperand1()->valueType();
-            if (!lhsType || !lhsType->isIntegral())
-                continue;
-        }
+    if (!tok->astOperand1() || !tok->astOperand2())
+        return;
 
-        // bailout if operation is protected by ?:
-        bool ternary = false;
-        for (const Token *parent = tok; parent; parent = parent->astParent()) {
-            if (Token::Match(parent, "?|:")) {
-                ternary = true;
-                break;
-            }
-        }
-        if (ternary)
-            continue;
+    // don't warn if lhs is a class. this is an overloaded operator then
+    if (mTokenizer->isCPP()) {
+        const ValueType * lhsType = tok->astOperand1()->valueType();
+        if (!lhsType || !lhsType->isIntegral())
+            return;
+    }
 
-        // Get negative rhs value. preferably a value which doesn't have 'condition'.
-        if (portability && isNegative(tok->astOperand1(), mSettings))
-            negativeBitwiseShiftError(tok, 1);
-        else if (isNegative(tok->astOperand2(), mSettings))
-            negativeBitwiseShiftError(tok, 2);
+    // bailout if operation is protected by ?:
+    for (const Token *parent = tok; parent; parent = parent->astParent()) {
+        if (Token::Match(parent, "?|:"))
+            return;
     }
+
+    // Get negative rhs value. preferably a value which doesn't have 'condition'.
+    if (portability && isNegative(tok->astOperand1(), mSettings))
+        negativeBitwiseShiftError(tok, 1);
+    else if (isNegative(tok->astOperand2(), mSettings))
+        negativeBitwiseShiftError(tok, 2);
 }
 
 
@@ -3430,24 +3444,17 @@ void CheckOther::comparePointersError(const Token *tok, const ValueFlow::Value *
         errorPath, Severity::error, "comparePointers", verb + " pointers that point to different objects", CWE570, Certainty::normal);
 }
 
-void CheckOther::checkModuloOfOne()
+void CheckOther::checkModuloOfOne(const Token *tok)
 {
-    if (!mSettings->severity.isEnabled(Severity::style))
+    if (!tok->astOperand2() || !tok->astOperand1())
+        return;
+    if (!tok->valueType() || !tok->valueType()->isIntegral())
         return;
 
-    for (const Token *tok = mTokenizer->tokens(); tok; tok = tok->next()) {
-        if (!tok->astOperand2() || !tok->astOperand1())
-            continue;
-        if (tok->str() != "%")
-            continue;
-        if (!tok->valueType() || !tok->valueType()->isIntegral())
-            continue;
-
-        // Value flow..
-        const ValueFlow::Value *value = tok->astOperand2()->getValue(1LL);
-        if (value && value->isKnown())
-            checkModuloOfOneError(tok);
-    }
+    // Value flow..
+    const ValueFlow::Value *value = tok->astOperand2()->getValue(1LL);
+    if (value && value->isKnown())
+        checkModuloOfOneError(tok);
 }
 
 void CheckOther::checkModuloOfOneError(const Token *tok)
@@ -58,6 +58,13 @@ public:
 
     /** @brief Run checks against the normal token list */
     void runChecks(const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger) OVERRIDE {
+        CheckVisitor visitor;
+        addVisitorHandlers(visitor, tokenizer, settings, errorLogger);
+        visitor.run(tokenizer);
+        runChecksAfterVisit(tokenizer, settings, errorLogger, visitor);
+    }
+
+    void runChecksAfterVisit(const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger, CheckVisitor &visitor) OVERRIDE {
         CheckOther checkOther(tokenizer, settings, errorLogger);
 
         // Checks
@@ -75,11 +82,11 @@ public:
         checkOther.checkSignOfUnsignedVariable();  // don't ignore casts (#3574)
         checkOther.checkIncompleteArrayFill();
         checkOther.checkVarFuncNullUB();
-        checkOther.checkNanInArithmeticExpression();
+        visitor.reportErrors("CheckOther::checkNanInArithmeticExpression", errorLogger);
         checkOther.checkCommaSeparatedReturn();
         checkOther.checkRedundantPointerOp();
-        checkOther.checkZeroDivision();
-        checkOther.checkNegativeBitwiseShift();
+        visitor.reportErrors("CheckOther::checkZeroDivision", errorLogger);
+        visitor.reportErrors("CheckOther::checkNegativeBitwiseShift", errorLogger);
         checkOther.checkInterlockedDecrement();
         checkOther.checkUnusedLabel();
         checkOther.checkEvaluationOrder();
@@ -94,16 +101,18 @@ public:
         checkOther.checkPassByReference();
         checkOther.checkConstVariable();
         checkOther.checkConstPointer();
-        checkOther.checkComparisonFunctionIsAlwaysTrueOrFalse();
+        visitor.reportErrors("CheckOther::checkComparisonFunctionIsAlwaysTrueOrFalse", errorLogger);
         checkOther.checkInvalidFree();
         checkOther.clarifyStatement();
         checkOther.checkCastIntToCharAndBack();
         checkOther.checkMisusedScopedObject();
         checkOther.checkAccessOfMovedVariable();
-        checkOther.checkModuloOfOne();
+        visitor.reportErrors("CheckOther::checkModuloOfOne", errorLogger);
         checkOther.checkOverlappingWrite();
     }
 
+    void addVisitorHandlers(CheckVisitor &visitor, const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger) OVERRIDE;
+
     /** Is expression a comparison that checks if a nonzero (unsigned/pointer) expression is less than zero? */
     static bool comparisonNonZeroExpressionLessThanZero(const Token *tok, const ValueFlow::Value **zeroValue, const Token **nonZeroExpr);
 
@@ -143,10 +152,10 @@ public:
     void checkIncompleteStatement();
 
     /** @brief %Check zero division*/
-    void checkZeroDivision();
+    void checkZeroDivision(const Token *tok);
 
     /** @brief Check for NaN (not-a-number) in an arithmetic expression */
-    void checkNanInArithmeticExpression();
+    void checkNanInArithmeticExpression(const Token *tok);
 
     /** @brief copying to memory or assigning to a variable twice */
     void checkRedundantAssignment();
@@ -183,7 +192,7 @@ public:
     void checkRedundantCopy();
 
     /** @brief %Check for bitwise shift with negative right operand */
-    void checkNegativeBitwiseShift();
+    void checkNegativeBitwiseShift(const Token *tok, bool portability);
 
     /** @brief %Check for buffers that are filled incompletely with memset and similar functions */
     void checkIncompleteArrayFill();
@@ -198,7 +207,7 @@ public:
     void checkCastIntToCharAndBack();
 
     /** @brief %Check for using of comparison functions evaluating always to true or false. */
-    void checkComparisonFunctionIsAlwaysTrueOrFalse();
+    void checkComparisonFunctionIsAlwaysTrueOrFalse(const Token *tok);
 
     /** @brief %Check for redundant pointer operations */
     void checkRedundantPointerOp();
@@ -225,7 +234,7 @@ public:
 
     void checkComparePointers();
 
-    void checkModuloOfOne();
+    void checkModuloOfOne(const Token *tok);
 
     void checkOverlappingWrite();
     void overlappingWriteUnion(const Token *tok);
@@ -1647,6 +1647,11 @@ std::string CheckUninitVar::MyFileInfo::toString() const
     return CTU::toString(unsafeUsage);
 }
 
+bool CheckUninitVar::isWholeProgramEnabled(const Settings *settings) const
+{
+    return settings->maxCtuDepth > 0;
+}
+
 Check::FileInfo *CheckUninitVar::getFileInfo(const Tokenizer *tokenizer, const Settings *settings) const
 {
     const CheckUninitVar checker(tokenizer, settings, nullptr);
@@ -1686,39 +1691,44 @@ bool CheckUninitVar::analyseWholeProgram(const CTU::FileInfo *ctu, const std::li
 {
     if (!ctu)
         return false;
-    bool foundErrors = false;
-    (void)settings; // This argument is unused
 
     const std::map<std::string, std::list<const CTU::FileInfo::CallBase *>> callsMap = ctu->getCallsMap();
 
+    // the unsafe usages are partitioned by the function they are in
+    std::vector<const CTU::FileInfo::UnsafeUsage *> usages;
+    std::vector<std::string> keys;
     for (Check::FileInfo *fi1 : fileInfo) {
         const MyFileInfo *fi = dynamic_cast<MyFileInfo*>(fi1);
         if (!fi)
             continue;
         for (const CTU::FileInfo::UnsafeUsage &unsafeUsage : fi->unsafeUsage) {
-            const CTU::FileInfo::FunctionCall *functionCall = nullptr;
-
-            const std::list<ErrorMessage::FileLocation> &locationList =
-                CTU::FileInfo::getErrorPath(CTU::FileInfo::InvalidValueType::uninit,
-                                            unsafeUsage,
-                                            callsMap,
-                                            "Using argument ARG",
-                                            &functionCall,
-                                            false);
-            if (locationList.empty())
-                continue;
-
-            const ErrorMessage errmsg(locationList,
-                                      emptyString,
-                                      Severity::error,
-                                      "Using argument " + unsafeUsage.myArgumentName + " that points at uninitialized variable " + functionCall->callArgumentExpression,
-                                      "ctuuninitvar",
-                                      CWE_USE_OF_UNINITIALIZED_VARIABLE,
-                                      Certainty::normal);
-            errorLogger.reportErr(errmsg);
-
-            foundErrors = true;
+            usages.push_back(&unsafeUsage);
+            keys.push_back(unsafeUsage.myId);
         }
     }
-    return foundErrors;
+
+    return runWholeProgramItems(keys, [&](std::size_t i, ErrorLogger &logger) {
+        const CTU::FileInfo::UnsafeUsage &unsafeUsage = *usages[i];
+        const CTU::FileInfo::FunctionCall *functionCall = nullptr;
+
+        const std::list<ErrorMessage::FileLocation> &locationList =
+            CTU::FileInfo::getErrorPath(CTU::FileInfo::InvalidValueType::uninit,
+                                        unsafeUsage,
+                                        callsMap,
+                                        "Using argument ARG",
+                                        &functionCall,
+                                        false);
+        if (locationList.empty())
+            return false;
+
+        const ErrorMessage errmsg(locationList,
+                                  emptyString,
+                                  Severity::error,
+                                  "Using argument " + unsafeUsage.myArgumentName + " that points at uninitialized variable " + functionCall->callArgumentExpression,
+                                  "ctuuninitvar",
+                                  CWE_USE_OF_UNINITIALIZED_VARIABLE,
+                                  Certainty::normal);
+        logger.reportErr(errmsg);
+        return true;
+    }, settings.jobs, errorLogger);
 }
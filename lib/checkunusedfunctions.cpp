@@ -341,6 +341,11 @@ void CheckUnusedFunctions::unusedFunctionError(ErrorLogger * const errorLogger,
         reportError(errmsg);
 }
 
+bool CheckUnusedFunctions::isWholeProgramEnabled(const Settings *settings) const
+{
+    return settings->checks.isEnabled(Checks::unusedFunction);
+}
+
 Check::FileInfo *CheckUnusedFunctions::getFileInfo(const Tokenizer *tokenizer, const Settings *settings) const
 {
     if (!settings->checks.isEnabled(Checks::unusedFunction))
@@ -17,6 +17,7 @@
  */
 #include "cppcheck.h"
 
+#include "binarydump.h"
 #include "check.h"
 #include "checkunusedfunctions.h"
 #include "clangimport.h"
@@ -31,6 +32,7 @@
 #include "timer.h"
 #include "tokenize.h" // Tokenizer
 #include "tokenlist.h"
+#include "valueflow.h"
 #include "version.h"
 
 #include "exprengine.h"
@@ -42,6 +44,8 @@
 #include <tinyxml2.h>
 #include <algorithm>
 #include <cstring>
+#include <ctime>
+#include <iterator>
 #include <new>
 #include <set>
 #include <stdexcept>
@@ -64,6 +68,26 @@ static const char FILELIST[] = "cppcheck-addon-ctu-file-list";
 
 static TimerResults s_timerResults;
 
+/** Count the header lookups that were made after the "before" statistics */
+static void countFileLookups(const simplecpp::FileLookupStats &before, SHOWTIME_MODES showtime)
+{
+    if (showtime == SHOWTIME_MODES::SHOWTIME_NONE)
+        return;
+    const simplecpp::FileLookupStats after = simplecpp::getFileLookupStats();
+    Timer::count("simplecpp::fileLookupHits", after.hits - before.hits, showtime, &s_timerResults);
+    Timer::count("simplecpp::fileLookupMisses", after.misses - before.misses, showtime, &s_timerResults);
+}
+
+/** Count the file buffer cache hits and misses after the "before" statistics */
+static void countFileBuffers(const simplecpp::FileBufferStats &before, SHOWTIME_MODES showtime)
+{
+    if (showtime == SHOWTIME_MODES::SHOWTIME_NONE)
+        return;
+    const simplecpp::FileBufferStats after = simplecpp::getFileBufferStats();
+    Timer::count("simplecpp::fileBufferHits", after.hits - before.hits, showtime, &s_timerResults);
+    Timer::count("simplecpp::fileBufferMisses", after.misses - before.misses, showtime, &s_timerResults);
+}
+
 // CWE ids used
 static const CWE CWE398(398U);  // Indicator of Poor Code Quality
 
@@ -228,18 +252,34 @@ static std::string getCtuInfoFileName(const std::string &dumpFile)
     return dumpFile.substr(0, dumpFile.size()-4) + "ctu-info";
 }
 
+static void dumpStandards(std::ostream& out, const Settings& settings)
+{
+    out << "  <standards>" << std::endl;
+    out << "    <c version=\"" << settings.standards.getC() << "\"/>" << std::endl;
+    out << "    <cpp version=\"" << settings.standards.getCPP() << "\"/>" << std::endl;
+    out << "  </standards>" << std::endl;
+}
+
+static bool useBinaryDump(const Settings& settings)
+{
+    // addons parse the xml dump
+    return settings.dumpFormat == Settings::DumpFormat::Binary && settings.addons.empty();
+}
+
 static void createDumpFile(const Settings& settings,
                            const std::string& filename,
                            const std::vector<std::string>& files,
                            const simplecpp::Token* rawtokens,
                            std::ofstream& fdump,
-                           std::string& dumpFile)
+                           std::string& dumpFile,
+                           std::unique_ptr<BinaryDump::Writer>& binaryDump)
 {
     if (!settings.dump && settings.addons.empty())
         return;
     dumpFile = getDumpFileName(settings, filename);
 
-    fdump.open(dumpFile);
+    const bool binary = useBinaryDump(settings);
+    fdump.open(dumpFile, binary ? (std::ios_base::out | std::ios_base::binary) : std::ios_base::out);
     if (!fdump.is_open())
         return;
 
@@ -247,6 +287,22 @@ static void createDumpFile(const Settings& settings,
         std::ofstream fout(getCtuInfoFileName(dumpFile));
     }
 
+    if (binary) {
+        binaryDump.reset(new BinaryDump::Writer(fdump));
+        BinaryDump::Platform platform;
+        platform.name = settings.platformString();
+        platform.char_bit = settings.char_bit;
+        platform.short_bit = settings.short_bit;
+        platform.int_bit = settings.int_bit;
+        platform.long_bit = settings.long_bit;
+        platform.long_long_bit = settings.long_long_bit;
+        platform.pointer_bit = settings.sizeof_pointer * settings.char_bit;
+        binaryDump->platform(platform);
+        for (const simplecpp::Token *tok = rawtokens; tok; tok = tok->next)
+            binaryDump->rawToken(files[tok->location.fileIndex], tok->location.line, tok->location.col, tok->str());
+        return;
+    }
+
     fdump << "<?xml version=\"1.0\"?>" << std::endl;
     fdump << "<dumps>" << std::endl;
     fdump << "  <platform"
@@ -361,6 +417,11 @@ CppCheck::~CppCheck()
     s_timerResults.showResults(mSettings.showtime);
 }
 
+TimerResults &CppCheck::timerResults()
+{
+    return s_timerResults;
+}
+
 const char * CppCheck::version()
 {
     return Version;
@@ -502,15 +563,24 @@ unsigned int CppCheck::check(const std::string &path)
             // create dumpfile
             std::ofstream fdump;
             std::string dumpFile;
-            createDumpFile(mSettings, path, tokenizer.list.getFiles(), nullptr, fdump, dumpFile);
-            if (fdump.is_open()) {
+            std::unique_ptr<BinaryDump::Writer> binaryDump;
+            createDumpFile(mSettings, path, tokenizer.list.getFiles(), nullptr, fdump, dumpFile, binaryDump);
+            if (binaryDump) {
+                std::ostringstream out;
+                for (const ErrorMessage& errmsg: compilerWarnings)
+                    out << "  <clang-warning file=\"" << toxml(errmsg.callStack.front().getfile()) << "\" line=\"" << errmsg.callStack.front().line << "\" column=\"" << errmsg.callStack.front().column << "\" message=\"" << toxml(errmsg.shortMessage()) << "\"/>\n";
+                dumpStandards(out, mSettings);
+                binaryDump->beginConfiguration(emptyString);
+                binaryDump->xml(out.str());
+                tokenizer.dump(*binaryDump);
+                binaryDump->endConfiguration();
+                binaryDump->finish();
+                fdump.close();
+            } else if (fdump.is_open()) {
                 fdump << "<dump cfg=\"\">" << std::endl;
                 for (const ErrorMessage& errmsg: compilerWarnings)
                     fdump << "  <clang-warning file=\"" << toxml(errmsg.callStack.front().getfile()) << "\" line=\"" << errmsg.callStack.front().line << "\" column=\"" << errmsg.callStack.front().column << "\" message=\"" << toxml(errmsg.shortMessage()) << "\"/>\n";
-                fdump << "  <standards>" << std::endl;
-                fdump << "    <c version=\"" << mSettings.standards.getC() << "\"/>" << std::endl;
-                fdump << "    <cpp version=\"" << mSettings.standards.getCPP() << "\"/>" << std::endl;
-                fdump << "  </standards>" << std::endl;
+                dumpStandards(fdump, mSettings);
                 tokenizer.dump(fdump);
                 fdump << "</dump>" << std::endl;
                 fdump << "</dumps>" << std::endl;
@@ -530,14 +600,13 @@ unsigned int CppCheck::check(const std::string &path)
         return mExitCode;
     }
 
-    std::ifstream fin(path);
-    return checkFile(Path::simplifyPath(path), emptyString, fin);
+    return checkFile(Path::simplifyPath(path), emptyString, nullptr);
 }
 
 unsigned int CppCheck::check(const std::string &path, const std::string &content)
 {
     std::istringstream iss(content);
-    return checkFile(Path::simplifyPath(path), emptyString, iss);
+    return checkFile(Path::simplifyPath(path), emptyString, &iss);
 }
 
 unsigned int CppCheck::check(const ImportProject::FileSettings &fs)
@@ -562,13 +631,26 @@ unsigned int CppCheck::check(const ImportProject::FileSettings &fs)
         temp.mSettings.includePaths.insert(temp.mSettings.includePaths.end(), fs.systemIncludePaths.cbegin(), fs.systemIncludePaths.cend());
         return temp.check(Path::simplifyPath(fs.filename));
     }
-    std::ifstream fin(fs.filename);
-    unsigned int returnValue = temp.checkFile(Path::simplifyPath(fs.filename), fs.cfg, fin);
+    unsigned int returnValue = temp.checkFile(Path::simplifyPath(fs.filename), fs.cfg, nullptr);
     mSettings.nomsg.addSuppressions(temp.mSettings.nomsg.getSuppressions());
     return returnValue;
 }
 
-unsigned int CppCheck::checkFile(const std::string& filename, const std::string &cfgname, std::istream& fileStream)
+std::string CppCheck::getToolInfo() const
+{
+    std::ostringstream toolinfo;
+    toolinfo << CPPCHECK_VERSION_STRING;
+    toolinfo << (mSettings.severity.isEnabled(Severity::warning) ? 'w' : ' ');
+    toolinfo << (mSettings.severity.isEnabled(Severity::style) ? 's' : ' ');
+    toolinfo << (mSettings.severity.isEnabled(Severity::performance) ? 'p' : ' ');
+    toolinfo << (mSettings.severity.isEnabled(Severity::portability) ? 'p' : ' ');
+    toolinfo << (mSettings.severity.isEnabled(Severity::information) ? 'i' : ' ');
+    toolinfo << mSettings.userDefines;
+    mSettings.nomsg.dump(toolinfo);
+    return toolinfo.str();
+}
+
+unsigned int CppCheck::checkFile(const std::string& filename, const std::string &cfgname, std::istream* fileStream)
 {
     mExitCode = 0;
     mSuppressInternalErrorFound = false;
@@ -580,6 +662,9 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
     if (Settings::terminated())
         return mExitCode;
 
+    if (mSettings.showtime != SHOWTIME_MODES::SHOWTIME_NONE)
+        s_timerResults.setTrace(!mSettings.showtimeOutput.empty());
+
     if (!mSettings.quiet) {
         std::string fixedpath = Path::simplifyPath(filename);
         fixedpath = Path::toNativeSeparators(fixedpath);
@@ -609,13 +694,41 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
 
     CheckUnusedFunctions checkUnusedFunctions(nullptr, nullptr, nullptr);
 
+    // The manifest is not used when the tokens are needed anyway (dump, addons, plist)
+    const bool useManifest = !fileStream && !mSettings.buildDir.empty() && !mSettings.dump && mSettings.addons.empty() && mSettings.plistOutput.empty();
+    std::string manifestToolInfo;
+    if (useManifest) {
+        manifestToolInfo = getToolInfo();
+        for (const std::string &I : mSettings.includePaths)
+            manifestToolInfo += " -I" + I;
+
+        // Fast path, nothing is tokenized if the source and its includes are unchanged
+        std::list<ErrorMessage> errors;
+        std::list<Suppressions::Suppression> suppressions;
+        if (AnalyzerInformation::isUnchanged(mSettings.buildDir, filename, cfgname, manifestToolInfo, &errors, &suppressions)) {
+            mSettings.nomsg.addSuppressions(suppressions);
+            while (!errors.empty()) {
+                reportErr(errors.front());
+                errors.pop_front();
+            }
+            return mExitCode;  // known results => no need to reanalyze file
+        }
+    }
+
+    // headers may have been added since the previous file was checked
+    simplecpp::clearFileLookupCache();
+
     try {
         Preprocessor preprocessor(mSettings, this);
         std::set<std::string> configurations;
 
         simplecpp::OutputList outputList;
         std::vector<std::string> files;
-        simplecpp::TokenList tokens1(fileStream, files, filename, &outputList);
+        // files that are changed after this time have a newer mtime than the manifest
+        const std::time_t readTime = std::time(nullptr);
+        Timer timerTokenize("Preprocessor::tokenize", mSettings.showtime, &s_timerResults);
+        simplecpp::TokenList tokens1 = fileStream ? simplecpp::TokenList(*fileStream, files, filename, &outputList) : simplecpp::TokenList(filename, files, &outputList);
+        timerTokenize.stop();
 
         // If there is a syntax error, report it and stop
         for (const simplecpp::Output &output : outputList) {
@@ -654,7 +767,14 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
             }
         }
 
-        if (!preprocessor.loadFiles(tokens1, files))
+        Timer timerLoadFiles("Preprocessor::loadFiles", mSettings.showtime, &s_timerResults);
+        const simplecpp::FileLookupStats fileLookups = simplecpp::getFileLookupStats();
+        const simplecpp::FileBufferStats fileBuffers = simplecpp::getFileBufferStats();
+        const bool loaded = preprocessor.loadFiles(tokens1, files);
+        countFileLookups(fileLookups, mSettings.showtime);
+        countFileBuffers(fileBuffers, mSettings.showtime);
+        timerLoadFiles.stop();
+        if (!loaded)
             return mExitCode;
 
         if (!mSettings.plistOutput.empty()) {
@@ -672,32 +792,36 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
         // write dump file xml prolog
         std::ofstream fdump;
         std::string dumpFile;
-        createDumpFile(mSettings, filename, files, tokens1.cfront(), fdump, dumpFile);
+        std::unique_ptr<BinaryDump::Writer> binaryDump;
+        createDumpFile(mSettings, filename, files, tokens1.cfront(), fdump, dumpFile, binaryDump);
 
         // Parse comments and then remove them
+        const std::size_t suppressionCount = mSettings.nomsg.getSuppressions().size();
         preprocessor.inlineSuppressions(tokens1);
-        if ((mSettings.dump || !mSettings.addons.empty()) && fdump.is_open()) {
+        if (binaryDump) {
+            std::ostringstream out;
+            mSettings.nomsg.dump(out);
+            binaryDump->xml(out.str());
+        } else if ((mSettings.dump || !mSettings.addons.empty()) && fdump.is_open()) {
             mSettings.nomsg.dump(fdump);
         }
         tokens1.removeComments();
         preprocessor.removeComments();
 
         if (!mSettings.buildDir.empty()) {
-            // Get toolinfo
-            std::ostringstream toolinfo;
-            toolinfo << CPPCHECK_VERSION_STRING;
-            toolinfo << (mSettings.severity.isEnabled(Severity::warning) ? 'w' : ' ');
-            toolinfo << (mSettings.severity.isEnabled(Severity::style) ? 's' : ' ');
-            toolinfo << (mSettings.severity.isEnabled(Severity::performance) ? 'p' : ' ');
-            toolinfo << (mSettings.severity.isEnabled(Severity::portability) ? 'p' : ' ');
-            toolinfo << (mSettings.severity.isEnabled(Severity::information) ? 'i' : ' ');
-            toolinfo << mSettings.userDefines;
-            mSettings.nomsg.dump(toolinfo);
-
             // Calculate checksum so it can be compared with old checksum / future checksums
-            const unsigned int checksum = preprocessor.calculateChecksum(tokens1, toolinfo.str());
+            const unsigned long long checksum = preprocessor.calculateChecksum(tokens1, getToolInfo());
             std::list<ErrorMessage> errors;
-            if (!mAnalyzerInformation.analyzeFile(mSettings.buildDir, filename, cfgname, checksum, &errors)) {
+            const bool analyze = mAnalyzerInformation.analyzeFile(mSettings.buildDir, filename, cfgname, checksum, &errors);
+            if (useManifest) {
+                // inline suppressions of this TU are appended to the list
+                const std::list<Suppressions::Suppression> &allSuppressions = mSettings.nomsg.getSuppressions();
+                std::list<Suppressions::Suppression> inlineSuppressions;
+                if (allSuppressions.size() > suppressionCount)
+                    inlineSuppressions.assign(std::next(allSuppressions.cbegin(), suppressionCount), allSuppressions.cend());
+                mAnalyzerInformation.writeManifest(manifestToolInfo, readTime, preprocessor.getFileStatus(filename, tokens1), preprocessor.getIncludeDirectories(tokens1), inlineSuppressions);
+            }
+            if (!analyze) {
                 while (!errors.empty()) {
                     reportErr(errors.front());
                     errors.pop_front();
@@ -757,6 +881,9 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
         int checkCount = 0;
         bool hasValidConfig = false;
         std::list<std::string> configurationError;
+        // included files that are preprocessed the same way in several configurations are reused
+        simplecpp::PreprocessCache preprocessCache;
+        simplecpp::PreprocessCache * const cache = (configurations.size() > 1) ? &preprocessCache : nullptr;
         for (const std::string &currCfg : configurations) {
             // bail out if terminated
             if (Settings::terminated())
@@ -781,7 +908,7 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
 
             if (mSettings.preprocessOnly) {
                 Timer t("Preprocessor::getcode", mSettings.showtime, &s_timerResults);
-                std::string codeWithoutCfg = preprocessor.getcode(tokens1, mCurrentConfig, files, true);
+                std::string codeWithoutCfg = preprocessor.getcode(tokens1, mCurrentConfig, files, true, cache);
                 t.stop();
 
                 if (codeWithoutCfg.compare(0,5,"#file") == 0)
@@ -808,7 +935,11 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
                 // Create tokens, skip rest of iteration if failed
                 {
                     Timer timer("Tokenizer::createTokens", mSettings.showtime, &s_timerResults);
-                    simplecpp::TokenList tokensP = preprocessor.preprocess(tokens1, mCurrentConfig, files, true);
+                    const simplecpp::FileLookupStats fileLookups = simplecpp::getFileLookupStats();
+                    const simplecpp::FileBufferStats fileBuffers = simplecpp::getFileBufferStats();
+                    simplecpp::TokenList tokensP = preprocessor.preprocess(tokens1, mCurrentConfig, files, true, cache);
+                    countFileLookups(fileLookups, mSettings.showtime);
+                    countFileBuffers(fileBuffers, mSettings.showtime);
                     tokenizer.createTokens(std::move(tokensP));
                 }
                 hasValidConfig = true;
@@ -838,12 +969,17 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
                     continue;
 
                 // dump xml if --dump
-                if ((mSettings.dump || !mSettings.addons.empty()) && fdump.is_open()) {
+                if (binaryDump) {
+                    std::ostringstream out;
+                    dumpStandards(out, mSettings);
+                    preprocessor.dump(out);
+                    binaryDump->beginConfiguration(mCurrentConfig);
+                    binaryDump->xml(out.str());
+                    tokenizer.dump(*binaryDump);
+                    binaryDump->endConfiguration();
+                } else if ((mSettings.dump || !mSettings.addons.empty()) && fdump.is_open()) {
                     fdump << "<dump cfg=\"" << ErrorLogger::toxml(mCurrentConfig) << "\">" << std::endl;
-                    fdump << "  <standards>" << std::endl;
-                    fdump << "    <c version=\"" << mSettings.standards.getC() << "\"/>" << std::endl;
-                    fdump << "    <cpp version=\"" << mSettings.standards.getCPP() << "\"/>" << std::endl;
-                    fdump << "  </standards>" << std::endl;
+                    dumpStandards(fdump, mSettings);
                     preprocessor.dump(fdump);
                     tokenizer.dump(fdump);
                     fdump << "</dump>" << std::endl;
@@ -912,6 +1048,11 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
             }
         }
 
+        if (mSettings.showtime != SHOWTIME_MODES::SHOWTIME_NONE) {
+            Timer::count("simplecpp::headerCacheHits", preprocessCache.hits(), mSettings.showtime, &s_timerResults);
+            Timer::count("simplecpp::headerCacheMisses", preprocessCache.misses(), mSettings.showtime, &s_timerResults);
+        }
+
         if (!hasValidConfig && configurations.size() > 1 && mSettings.severity.isEnabled(Severity::information)) {
             std::string msg;
             msg = "This file is not analyzed. Cppcheck failed to extract a valid configuration. Use -v for more details.";
@@ -933,7 +1074,10 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
         }
 
         // dumped all configs, close root </dumps> element now
-        if (fdump.is_open()) {
+        if (binaryDump) {
+            binaryDump->finish();
+            fdump.close();
+        } else if (fdump.is_open()) {
             fdump << "</dumps>" << std::endl;
             fdump.close();
         }
@@ -1005,6 +1149,16 @@ void CppCheck::checkNormalTokens(const Tokenizer &tokenizer)
     if (mSettings.bugHunting)
         ExprEngine::runChecks(this, &tokenizer, &mSettings);
     else {
+        // checks that are ported to the single pass traversal, the errors
+        // are reported by runChecksAfterVisit()
+        CheckVisitor visitor;
+        for (Check *check : Check::instances())
+            check->addVisitorHandlers(visitor, &tokenizer, &mSettings, this);
+        {
+            Timer timerVisitor("CheckVisitor::run", mSettings.showtime, &s_timerResults);
+            visitor.run(&tokenizer);
+        }
+
         // call all "runChecks" in all registered Check classes
         for (Check *check : Check::instances()) {
             if (Settings::terminated())
@@ -1014,7 +1168,7 @@ void CppCheck::checkNormalTokens(const Tokenizer &tokenizer)
                 return;
 
             Timer timerRunChecks(check->name() + "::runChecks", mSettings.showtime, &s_timerResults);
-            check->runChecks(&tokenizer, &mSettings, this);
+            check->runChecksAfterVisit(&tokenizer, &mSettings, this, visitor);
         }
 
         if (mSettings.clang)
@@ -1022,22 +1176,54 @@ void CppCheck::checkNormalTokens(const Tokenizer &tokenizer)
             return;
 
         // Analyse the tokens..
+        getFileInfo(tokenizer);
 
-        CTU::FileInfo *fi1 = CTU::getFileInfo(&tokenizer);
-        if (fi1) {
-            mFileInfo.push_back(fi1);
-            mAnalyzerInformation.setFileInfo("ctu", fi1->toString());
-        }
+        executeRules("normal", tokenizer);
+    }
+}
 
-        for (const Check *check : Check::instances()) {
-            Check::FileInfo *fi = check->getFileInfo(&tokenizer, &mSettings);
-            if (fi != nullptr) {
-                mFileInfo.push_back(fi);
-                mAnalyzerInformation.setFileInfo(check->name(), fi->toString());
-            }
-        }
+//---------------------------------------------------------------------------
 
-        executeRules("normal", tokenizer);
+void CppCheck::getFileInfo(const Tokenizer &tokenizer)
+{
+    // The collected file info is used by analyseWholeProgram() when there
+    // is a single job. With a build dir it is written to the analyzer
+    // info file instead. Otherwise nobody will look at it.
+    const bool keep = mSettings.jobs == 1;
+    const bool write = !mSettings.buildDir.empty();
+    if (!keep && !write)
+        return;
+
+    Timer timer("CppCheck::getFileInfo", mSettings.showtime, &s_timerResults);
+
+    std::vector<const Check *> checks;
+    bool ctu = false;
+    for (const Check *check : Check::instances()) {
+        if (!check->isWholeProgramEnabled(&mSettings))
+            continue;
+        checks.push_back(check);
+        ctu |= check->usesCtuFileInfo();
+    }
+
+    const auto addFileInfo = [&](const std::string &name, Check::FileInfo *fi) {
+        if (write)
+            mAnalyzerInformation.setFileInfo(name, fi->toString());
+        if (keep)
+            mFileInfo.push_back(fi);
+        else
+            delete fi;
+    };
+
+    if (ctu) {
+        CTU::FileInfo *fi1 = CTU::getFileInfo(&tokenizer);
+        if (fi1)
+            addFileInfo("ctu", fi1);
+    }
+
+    for (const Check *check : checks) {
+        Check::FileInfo *fi = check->getFileInfo(&tokenizer, &mSettings);
+        if (fi != nullptr)
+            addFileInfo(check->name(), fi);
     }
 }
 
@@ -1586,6 +1772,7 @@ void CppCheck::getErrorMessages()
         (*it)->getErrorMessages(this, &s);
 
     Preprocessor::getErrorMessages(this, &s);
+    ValueFlow::getErrorMessages(this);
 }
 
 void CppCheck::analyseClangTidy(const ImportProject::FileSettings &fileSettings)
@@ -1668,7 +1855,6 @@ void CppCheck::analyseClangTidy(const ImportProject::FileSettings &fileSettings)
 
 bool CppCheck::analyseWholeProgram()
 {
-    bool errors = false;
     // Init CTU
     CTU::maxCtuDepth = mSettings.maxCtuDepth;
     // Analyse the tokens
@@ -1680,11 +1866,22 @@ bool CppCheck::analyseWholeProgram()
             ctu.nestedCalls.insert(ctu.nestedCalls.end(), fi2->nestedCalls.begin(), fi2->nestedCalls.end());
         }
     }
-    for (Check *check : Check::instances())
-        errors |= check->analyseWholeProgram(&ctu, mFileInfo, mSettings, *this);  // TODO: ctu
+    const bool errors = analyseWholeProgram(ctu, mFileInfo);
     return errors && (mExitCode > 0);
 }
 
+bool CppCheck::analyseWholeProgram(const CTU::FileInfo &ctu, const std::list<Check::FileInfo*> &fileInfo)
+{
+    // The checks are independent, run them concurrently
+    std::vector<Check::WholeProgramTask> tasks;
+    for (Check *check : Check::instances()) {
+        tasks.emplace_back([&, check](ErrorLogger &errorLogger) {
+            return check->analyseWholeProgram(&ctu, fileInfo, mSettings, errorLogger);  // TODO: ctu
+        });
+    }
+    return Check::runWholeProgramTasks(tasks, mSettings.jobs, *this);
+}
+
 void CppCheck::analyseWholeProgram(const std::string &buildDir, const std::map<std::string, std::size_t> &files)
 {
     executeAddonsWholeProgram(files);
@@ -1739,8 +1936,7 @@ void CppCheck::analyseWholeProgram(const std::string &buildDir, const std::map<s
     CTU::maxCtuDepth = mSettings.maxCtuDepth;
 
     // Analyse the tokens
-    for (Check *check : Check::instances())
-        check->analyseWholeProgram(&ctuFileInfo, fileInfoList, mSettings, *this);
+    analyseWholeProgram(ctuFileInfo, fileInfoList);
 
     for (Check::FileInfo *fi : fileInfoList)
         delete fi;
@@ -35,6 +35,7 @@
 #include <map>
 #include <string>
 
+class TimerResults;
 class Tokenizer;
 
 /// @addtogroup Core
@@ -110,6 +111,12 @@ public:
      */
     static const char * extraVersion();
 
+    /**
+     * @brief The --showtime results of this process. The results of the
+     * worker processes are merged into these.
+     */
+    static TimerResults &timerResults();
+
     virtual void reportStatus(unsigned int fileindex, unsigned int filecount, std::size_t sizedone, std::size_t sizetotal);
 
     /**
@@ -153,10 +160,20 @@ private:
      * @brief Check a file using stream
      * @param filename file name
      * @param cfgname  cfg name
-     * @param fileStream stream the file content can be read from
+     * @param fileStream stream the file content can be read from, nullptr => the file on disk is read. Then the build dir manifest is used.
      * @return number of errors found
      */
-    unsigned int checkFile(const std::string& filename, const std::string &cfgname, std::istream& fileStream);
+    unsigned int checkFile(const std::string& filename, const std::string &cfgname, std::istream* fileStream);
+
+    /**
+     * @brief Run the whole program analysis of all checks. The checks run
+     * concurrently when there are several jobs, errors are reported in
+     * check order.
+     */
+    bool analyseWholeProgram(const CTU::FileInfo &ctu, const std::list<Check::FileInfo*> &fileInfo);
+
+    /** @brief Settings that influence the cached results in the build dir */
+    std::string getToolInfo() const;
 
     /**
      * @brief Check raw tokens
@@ -170,6 +187,13 @@ private:
      */
     void checkNormalTokens(const Tokenizer &tokenizer);
 
+    /**
+     * @brief Collect the whole program analysis data of the enabled checks.
+     * Nothing is collected when no whole program analysis will be done.
+     * @param tokenizer tokenizer instance
+     */
+    void getFileInfo(const Tokenizer &tokenizer);
+
     /**
      * Execute addons
      */
@@ -138,11 +138,18 @@
 #include "symboldatabase.h"
 #include "tokenize.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <chrono>
 #include <limits>
 #include <memory>
 #include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
 #include <tuple>
+#include <unordered_map>
 #ifdef USE_Z3
 #include <z3++.h>
 #include <z3_version.h>
@@ -256,7 +263,41 @@ std::string ExprEngine::str(int128_t value)
 
 static ExprEngine::ValuePtr getValueRangeFromValueType(const std::string &name, const ValueType *vt, const cppcheck::Platform &platform);
 
+class PathSolver;
+
 namespace {
+    /** Results of the solver queries of a run, identical queries are solved once */
+    class SolverCache {
+    public:
+        bool find(const std::string &query, int *result) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            const std::unordered_map<std::string, int>::const_iterator it = mResults.find(query);
+            if (it == mResults.end())
+                return false;
+            *result = it->second;
+            return true;
+        }
+
+        void add(const std::string &query, int result) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mResults[query] = result;
+        }
+
+    private:
+        std::mutex mMutex;
+        std::unordered_map<std::string, int> mResults;
+    };
+
+    /** Time the solver spent on a function */
+    struct SolverStats {
+        SolverStats() : seconds(0), queries(0), cacheHits(0), reusedConstraints(0) {}
+        double seconds;
+        int queries;
+        int cacheHits;
+        /** constraints that were already asserted in the incremental solver */
+        std::size_t reusedConstraints;
+    };
+
     class TrackExecution {
     public:
         TrackExecution() : mDataIndexCounter(0), mAbortLine(-1) {}
@@ -365,7 +406,7 @@ namespace {
 
     class Data : public ExprEngine::DataBase {
     public:
-        Data(int *symbolValueIndex, ErrorLogger *errorLogger, const Tokenizer *tokenizer, const Settings *settings, const std::string &currentFunction, const std::vector<ExprEngine::Callback> &callbacks, TrackExecution *trackExecution)
+        Data(int *symbolValueIndex, ErrorLogger *errorLogger, const Tokenizer *tokenizer, const Settings *settings, const std::string &currentFunction, const std::vector<ExprEngine::Callback> &callbacks, TrackExecution *trackExecution, SolverCache *solverCache, SolverStats *solverStats, PathSolver *pathSolver)
             : DataBase(currentFunction, settings)
             , symbolValueIndex(symbolValueIndex)
             , errorLogger(errorLogger)
@@ -373,6 +414,9 @@ namespace {
             , callbacks(callbacks)
             , recursion(0)
             , startTime(std::time(nullptr))
+            , solverCache(solverCache)
+            , solverStats(solverStats)
+            , pathSolver(pathSolver)
             , mTrackExecution(trackExecution)
             , mDataIndex(trackExecution->getNewDataIndex()) {}
 
@@ -386,6 +430,9 @@ namespace {
             , constraints(old.constraints)
             , recursion(old.recursion)
             , startTime(old.startTime)
+            , solverCache(old.solverCache)
+            , solverStats(old.solverStats)
+            , pathSolver(old.pathSolver)
             , mTrackExecution(old.mTrackExecution)
             , mDataIndex(mTrackExecution->getNewDataIndex()) {
             for (auto &it: memory) {
@@ -405,6 +452,9 @@ namespace {
         std::vector<ExprEngine::ValuePtr> constraints;
         int recursion;
         std::time_t startTime;
+        SolverCache * const solverCache;
+        SolverStats * const solverStats;
+        PathSolver * const pathSolver;
 
         bool isC() const OVERRIDE {
             return tokenizer->isC();
@@ -418,6 +468,9 @@ namespace {
             const auto it = settings->functionContracts.find(function->fullName());
             if (it == settings->functionContracts.end())
                 return ExprEngine::ValuePtr();
+            // The value types are set through the shared symbol database
+            static std::recursive_mutex contractMutex;
+            std::lock_guard<std::recursive_mutex> lock(contractMutex);
             const std::string &expects = it->second;
             TokenList tokenList(settings);
             std::istringstream istr(expects);
@@ -1120,6 +1173,66 @@ public:
     z3::context context;
     ValueExpr valueExpr;
     AssertionList assertionList;
+    /** names of the valueExpr items in the order they are added */
+    std::vector<std::string> valueNames;
+
+    /** Add the declarations of the constants in the expression, "name:sort" */
+    static void getConstants(const z3::expr &e, std::set<unsigned int> &visited, std::set<std::string> &constants) {
+        if (!visited.insert(e.id()).second)
+            return;
+        if (e.is_const() && e.decl().decl_kind() == Z3_OP_UNINTERPRETED) {
+            constants.insert(e.decl().name().str() + ':' + e.get_sort().to_string());
+            return;
+        }
+        if (!e.is_app())
+            return;
+        for (unsigned int i = 0; i < e.num_args(); ++i)
+            getConstants(e.arg(i), visited, constants);
+    }
+
+    /**
+     * The assertions of the solver in a canonical form. The order of the
+     * assertions and duplicates do not matter. The cache is shared by the
+     * functions and the symbol names are reused in each function, so the
+     * constants are declared with their sorts.
+     */
+    static std::string canonicalQuery(z3::solver &solver) {
+        const z3::expr_vector assertions = solver.assertions();
+        std::vector<std::string> strs;
+        strs.reserve(assertions.size());
+        std::set<unsigned int> visited;
+        std::set<std::string> constants;
+        for (unsigned int i = 0; i < assertions.size(); ++i) {
+            strs.push_back(assertions[i].to_string());
+            getConstants(assertions[i], visited, constants);
+        }
+        std::sort(strs.begin(), strs.end());
+        strs.erase(std::unique(strs.begin(), strs.end()), strs.end());
+        std::string ret;
+        for (const std::string &constant: constants)
+            ret += "(declare " + constant + ")\n";
+        for (const std::string &str: strs)
+            ret += str + '\n';
+        return ret;
+    }
+
+    /** Check the solver, the result of an equivalent query is reused */
+    static z3::check_result check(z3::solver &solver, const Data *data) {
+        if (!data || !data->solverCache)
+            return solver.check();
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const std::string query = canonicalQuery(solver);
+        int result = 0;
+        if (data->solverCache->find(query, &result)) {
+            ++data->solverStats->cacheHits;
+        } else {
+            result = solver.check();
+            data->solverCache->add(query, result);
+        }
+        ++data->solverStats->queries;
+        data->solverStats->seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return static_cast<z3::check_result>(result);
+    }
 
     void addAssertions(z3::solver &solver) const {
         for (auto assertExpr : assertionList)
@@ -1136,7 +1249,8 @@ public:
 
     z3::expr addInt(const std::string &name, int128_t minValue, int128_t maxValue) {
         z3::expr e = context.int_const(name.c_str());
-        valueExpr.emplace(name, e);
+        if (valueExpr.emplace(name, e).second)
+            valueNames.push_back(name);
         if (minValue >= INT_MIN && maxValue <= INT_MAX)
             assertionList.push_back(e >= int(minValue) && e <= int(maxValue));
         else if (maxValue <= INT_MAX)
@@ -1148,7 +1262,8 @@ public:
 
     z3::expr addFloat(const std::string &name) {
         z3::expr e = z3_fp_const(name);
-        valueExpr.emplace(name, e);
+        if (valueExpr.emplace(name, e).second)
+            valueNames.push_back(name);
         return e;
     }
 
@@ -1308,6 +1423,103 @@ public:
 #endif
     }
 };
+
+/**
+ * Incremental solver for the constraints of an execution path. The
+ * constraints are asserted in solver scopes, one scope per constraint.
+ * When a query is made for another path the scopes after the common
+ * prefix of the constraints are popped, so the constraints along the
+ * same path are only translated once.
+ */
+class PathSolver {
+public:
+    PathSolver() : solver(exprData.context) {}
+
+    /** Check the query against the path constraints of data */
+    template<class Query>
+    z3::check_result check(const Data *data, const Query &query) {
+        sync(data);
+        const Level level = push(nullptr);
+        try {
+            const z3::expr e = query(exprData);
+            addAssertions(level);
+            solver.add(e);
+            const z3::check_result result = ExprData::check(solver, data);
+            pop();
+            return result;
+        } catch (...) {
+            pop();
+            throw;
+        }
+    }
+
+private:
+    struct Level {
+        ExprEngine::ValuePtr constraint;
+        std::size_t valueNames;
+        std::size_t assertions;
+    };
+
+    void sync(const Data *data) {
+        const std::vector<ExprEngine::ValuePtr> &constraints = data->constraints;
+        std::size_t common = 0;
+        while (common < levels.size() && common < constraints.size() && levels[common].constraint == constraints[common])
+            ++common;
+        if (data->solverStats)
+            data->solverStats->reusedConstraints += common;
+        try {
+            while (levels.size() > common)
+                pop();
+            for (std::size_t i = common; i < constraints.size(); ++i) {
+                const Level level = push(constraints[i]);
+                try {
+                    solver.add(exprData.getConstraintExpr(constraints[i]));
+                } catch (const ExprData::BailoutValueException &) {}
+                addAssertions(level);
+            }
+        } catch (...) {
+            reset();
+            throw;
+        }
+    }
+
+    Level push(const ExprEngine::ValuePtr &constraint) {
+        Level level{constraint, exprData.valueNames.size(), exprData.assertionList.size()};
+        levels.push_back(level);
+        solver.push();
+        return level;
+    }
+
+    void pop() {
+        const Level &level = levels.back();
+        solver.pop();
+        for (std::size_t i = level.valueNames; i < exprData.valueNames.size(); ++i)
+            exprData.valueExpr.erase(exprData.valueNames[i]);
+        exprData.valueNames.resize(level.valueNames);
+        exprData.assertionList.erase(exprData.assertionList.begin() + level.assertions, exprData.assertionList.end());
+        levels.pop_back();
+    }
+
+    /** Add the assertions of the values that are created in the level */
+    void addAssertions(const Level &level) {
+        for (std::size_t i = level.assertions; i < exprData.assertionList.size(); ++i)
+            solver.add(exprData.assertionList[i]);
+    }
+
+    void reset() {
+        solver.reset();
+        levels.clear();
+        exprData.valueExpr.clear();
+        exprData.valueNames.clear();
+        exprData.assertionList.clear();
+    }
+
+    ExprData exprData;
+    z3::solver solver;
+    std::vector<Level> levels;
+};
+#else
+class PathSolver {};
 #endif
 
 bool ExprEngine::UninitValue::isUninit(const DataBase *dataBase) const {
@@ -1316,12 +1528,10 @@ bool ExprEngine::UninitValue::isUninit(const DataBase *dataBase) const {
         return true;
 #ifdef USE_Z3
     // Check the value against the constraints
-    ExprData exprData;
-    z3::solver solver(exprData.context);
     try {
-        exprData.addConstraints(solver, data);
-        exprData.addAssertions(solver);
-        return solver.check() == z3::sat;
+        return data->pathSolver->check(data, [](ExprData &exprData) {
+            return exprData.context.bool_val(true);
+        }) == z3::sat;
     } catch (const z3::exception &exception) {
         std::cerr << "z3: " << exception << std::endl;
         return true;  // Safe option is to return true
@@ -1346,14 +1556,10 @@ bool ExprEngine::IntRange::isEqual(const DataBase *dataBase, int value) const
         return true;
 #ifdef USE_Z3
     // Check the value against the constraints
-    ExprData exprData;
-    z3::solver solver(exprData.context);
     try {
-        z3::expr e = exprData.addInt(name, minValue, maxValue);
-        exprData.addConstraints(solver, data);
-        exprData.addAssertions(solver);
-        solver.add(e == value);
-        return solver.check() == z3::sat;
+        return data->pathSolver->check(data, [&](ExprData &exprData) {
+            return exprData.addInt(name, minValue, maxValue) == value;
+        }) == z3::sat;
     } catch (const z3::exception &exception) {
         std::cerr << "z3: " << exception << std::endl;
         return true;  // Safe option is to return true
@@ -1378,14 +1584,10 @@ bool ExprEngine::IntRange::isGreaterThan(const DataBase *dataBase, int value) co
         return true;
 #ifdef USE_Z3
     // Check the value against the constraints
-    ExprData exprData;
-    z3::solver solver(exprData.context);
     try {
-        z3::expr e = exprData.addInt(name, minValue, maxValue);
-        exprData.addConstraints(solver, data);
-        exprData.addAssertions(solver);
-        solver.add(e > value);
-        return solver.check() == z3::sat;
+        return data->pathSolver->check(data, [&](ExprData &exprData) {
+            return exprData.addInt(name, minValue, maxValue) > value;
+        }) == z3::sat;
     } catch (const z3::exception &exception) {
         std::cerr << "z3: " << exception << std::endl;
         return true;  // Safe option is to return true
@@ -1410,14 +1612,10 @@ bool ExprEngine::IntRange::isLessThan(const DataBase *dataBase, int value) const
         return true;
 #ifdef USE_Z3
     // Check the value against the constraints
-    ExprData exprData;
-    z3::solver solver(exprData.context);
     try {
-        z3::expr e = exprData.addInt(name, minValue, maxValue);
-        exprData.addConstraints(solver, data);
-        exprData.addAssertions(solver);
-        solver.add(e < value);
-        return solver.check() == z3::sat;
+        return data->pathSolver->check(data, [&](ExprData &exprData) {
+            return exprData.addInt(name, minValue, maxValue) < value;
+        }) == z3::sat;
     } catch (const z3::exception &exception) {
         std::cerr << "z3: " << exception << std::endl;
         return true;  // Safe option is to return true
@@ -1443,20 +1641,17 @@ bool ExprEngine::FloatRange::isEqual(const DataBase *dataBase, int value) const
         return true;
 #ifdef USE_Z3
     // Check the value against the constraints
-    ExprData exprData;
-    z3::solver solver(exprData.context);
     try {
-        z3::expr e = exprData.addFloat(name);
-        exprData.addConstraints(solver, data);
-        exprData.addAssertions(solver);
-        // Workaround for z3 bug: https://github.com/Z3Prover/z3/issues/4905
+        return data->pathSolver->check(data, [&](ExprData &exprData) {
+            z3::expr e = exprData.addFloat(name);
+            // Workaround for z3 bug: https://github.com/Z3Prover/z3/issues/4905
 #if Z3_VERSION_INT >= GET_VERSION_INT(4,8,0)
-        z3::expr val_e = exprData.context.fpa_val(static_cast<double>(value));
+            z3::expr val_e = exprData.context.fpa_val(static_cast<double>(value));
 #else
-        z3::expr val_e = exprData.context.real_val(value);
+            z3::expr val_e = exprData.context.real_val(value);
 #endif // Z3_VERSION_INT
-        solver.add(e == val_e);
-        return solver.check() != z3::unsat;
+            return e == val_e;
+        }) != z3::unsat;
     } catch (const z3::exception &exception) {
         std::cerr << "z3: " << exception << std::endl;
         return true;  // Safe option is to return true
@@ -1483,14 +1678,10 @@ bool ExprEngine::FloatRange::isGreaterThan(const DataBase *dataBase, int value)
         return value > MathLib::toDoubleNumber(name);
 #ifdef USE_Z3
     // Check the value against the constraints
-    ExprData exprData;
-    z3::solver solver(exprData.context);
     try {
-        z3::expr e = exprData.addFloat(name);
-        exprData.addConstraints(solver, data);
-        exprData.addAssertions(solver);
-        solver.add(e > value);
-        return solver.check() == z3::sat;
+        return data->pathSolver->check(data, [&](ExprData &exprData) {
+            return exprData.addFloat(name) > value;
+        }) == z3::sat;
     } catch (const z3::exception &exception) {
         std::cerr << "z3: " << exception << std::endl;
         return true;  // Safe option is to return true
@@ -1517,14 +1708,10 @@ bool ExprEngine::FloatRange::isLessThan(const DataBase *dataBase, int value) con
         return value < MathLib::toDoubleNumber(name);
 #ifdef USE_Z3
     // Check the value against the constraints
-    ExprData exprData;
-    z3::solver solver(exprData.context);
     try {
-        z3::expr e = exprData.addFloat(name);
-        exprData.addConstraints(solver, data);
-        exprData.addAssertions(solver);
-        solver.add(e < value);
-        return solver.check() == z3::sat;
+        return data->pathSolver->check(data, [&](ExprData &exprData) {
+            return exprData.addFloat(name) < value;
+        }) == z3::sat;
     } catch (const z3::exception &exception) {
         std::cerr << "z3: " << exception << std::endl;
         return true;  // Safe option is to return true
@@ -1544,13 +1731,11 @@ bool ExprEngine::BinOpResult::isEqual(const ExprEngine::DataBase *dataBase, int
 {
 #ifdef USE_Z3
     try {
-        ExprData exprData;
-        z3::solver solver(exprData.context);
-        z3::expr e = exprData.getExpr(this);
-        exprData.addConstraints(solver, dynamic_cast<const Data *>(dataBase));
-        exprData.addAssertions(solver);
-        solver.add(exprData.int_expr(e) == value);
-        return solver.check() == z3::sat;
+        const Data *data = dynamic_cast<const Data *>(dataBase);
+        return data->pathSolver->check(data, [&](ExprData &exprData) {
+            z3::expr e = exprData.getExpr(this);
+            return exprData.int_expr(e) == value;
+        }) == z3::sat;
     } catch (const z3::exception &exception) {
         std::cerr << "z3:" << exception << std::endl;
         return true;  // Safe option is to return true
@@ -1570,13 +1755,11 @@ bool ExprEngine::BinOpResult::isGreaterThan(const ExprEngine::DataBase *dataBase
 {
 #ifdef USE_Z3
     try {
-        ExprData exprData;
-        z3::solver solver(exprData.context);
-        z3::expr e = exprData.getExpr(this);
-        exprData.addConstraints(solver, dynamic_cast<const Data *>(dataBase));
-        exprData.addAssertions(solver);
-        solver.add(e > value);
-        return solver.check() == z3::sat;
+        const Data *data = dynamic_cast<const Data *>(dataBase);
+        return data->pathSolver->check(data, [&](ExprData &exprData) {
+            z3::expr e = exprData.getExpr(this);
+            return e > value;
+        }) == z3::sat;
     } catch (const z3::exception &exception) {
         std::cerr << "z3:" << exception << std::endl;
         return true;  // Safe option is to return true
@@ -1596,13 +1779,11 @@ bool ExprEngine::BinOpResult::isLessThan(const ExprEngine::DataBase *dataBase, i
 {
 #ifdef USE_Z3
     try {
-        ExprData exprData;
-        z3::solver solver(exprData.context);
-        z3::expr e = exprData.getExpr(this);
-        exprData.addConstraints(solver, dynamic_cast<const Data *>(dataBase));
-        exprData.addAssertions(solver);
-        solver.add(e < value);
-        return solver.check() == z3::sat;
+        const Data *data = dynamic_cast<const Data *>(dataBase);
+        return data->pathSolver->check(data, [&](ExprData &exprData) {
+            z3::expr e = exprData.getExpr(this);
+            return e < value;
+        }) == z3::sat;
     } catch (const z3::exception &exception) {
         std::cerr << "z3:" << exception << std::endl;
         return true;  // Safe option is to return true
@@ -1622,13 +1803,11 @@ bool ExprEngine::BinOpResult::isTrue(const ExprEngine::DataBase *dataBase) const
 {
 #ifdef USE_Z3
     try {
-        ExprData exprData;
-        z3::solver solver(exprData.context);
-        z3::expr e = exprData.getExpr(this);
-        exprData.addConstraints(solver, dynamic_cast<const Data *>(dataBase));
-        exprData.addAssertions(solver);
-        solver.add(exprData.int_expr(e) != 0);
-        return solver.check() == z3::sat;
+        const Data *data = dynamic_cast<const Data *>(dataBase);
+        return data->pathSolver->check(data, [&](ExprData &exprData) {
+            z3::expr e = exprData.getExpr(this);
+            return exprData.int_expr(e) != 0;
+        }) == z3::sat;
     } catch (const z3::exception &exception) {
         std::cerr << "z3:" << exception << std::endl;
         return true;  // Safe option is to return true
@@ -2013,7 +2192,7 @@ static void checkContract(Data &data, const Token *tok, const Function *function
             data.trackCheckContract(tok, os.str());
         }
 
-        if (bailoutValue || solver.check() == z3::sat) {
+        if (bailoutValue || exprData.check(solver, &data) == z3::sat) {
             const char id[] = "bughuntingFunctionCall";
             const auto contractIt = data.settings->functionContracts.find(function->fullName());
             const std::string functionName = contractIt->first;
@@ -2878,23 +3057,98 @@ static std::string execute(const Token *start, const Token *end, Data &data)
     return data.str();
 }
 
+namespace {
+    /** Buffer the output of a function that is executed in a worker thread */
+    class FunctionErrorBuffer : public ErrorLogger {
+    public:
+        void reportOut(const std::string &outmsg, Color c = Color::Reset) OVERRIDE {
+            out.emplace_back(outmsg, c);
+        }
+        void reportErr(const ErrorMessage &msg) OVERRIDE {
+            errors.push_back(msg);
+        }
+        void bughuntingReport(const std::string &str) OVERRIDE {
+            bughunting.push_back(str);
+        }
+        std::vector<std::pair<std::string, Color>> out;
+        std::vector<ErrorMessage> errors;
+        std::vector<std::string> bughunting;
+    };
+}
+
+static void executeFunction(const Scope *functionScope, ErrorLogger *errorLogger, const Tokenizer *tokenizer, const Settings *settings, const std::vector<ExprEngine::Callback> &callbacks, std::ostream &report, SolverCache *solverCache);
+
+/** Execute a function, returns false if the analysis is terminated */
+static bool tryExecuteFunction(const Scope *functionScope, ErrorLogger *errorLogger, const Tokenizer *tokenizer, const Settings *settings, const std::vector<ExprEngine::Callback> &callbacks, std::ostream &report, std::ostream &out, SolverCache *solverCache)
+{
+    try {
+        executeFunction(functionScope, errorLogger, tokenizer, settings, callbacks, report, solverCache);
+    } catch (const ExprEngineException &e) {
+        // FIXME.. there should not be exceptions
+        std::string functionName = functionScope->function->name();
+        out << "Verify: Aborted analysis of function '" << functionName << "':" << e.tok->linenr() << ": " << e.what << std::endl;
+    } catch (const std::exception &e) {
+        // FIXME.. there should not be exceptions
+        std::string functionName = functionScope->function->name();
+        out << "Verify: Aborted analysis of function '" << functionName << "': " << e.what() << std::endl;
+    } catch (const TerminateExpression &) {
+        return false;
+    }
+    return true;
+}
+
 void ExprEngine::executeAllFunctions(ErrorLogger *errorLogger, const Tokenizer *tokenizer, const Settings *settings, const std::vector<ExprEngine::Callback> &callbacks, std::ostream &report)
 {
     const SymbolDatabase *symbolDatabase = tokenizer->getSymbolDatabase();
-    for (const Scope *functionScope : symbolDatabase->functionScopes) {
-        try {
-            executeFunction(functionScope, errorLogger, tokenizer, settings, callbacks, report);
-        } catch (const ExprEngineException &e) {
-            // FIXME.. there should not be exceptions
-            std::string functionName = functionScope->function->name();
-            std::cout << "Verify: Aborted analysis of function '" << functionName << "':" << e.tok->linenr() << ": " << e.what << std::endl;
-        } catch (const std::exception &e) {
-            // FIXME.. there should not be exceptions
-            std::string functionName = functionScope->function->name();
-            std::cout << "Verify: Aborted analysis of function '" << functionName << "': " << e.what() << std::endl;
-        } catch (const TerminateExpression &) {
-            break;
+    const std::vector<const Scope *> &functionScopes = symbolDatabase->functionScopes;
+    SolverCache solverCache;
+
+    if (settings->bugHuntingJobs <= 1 || functionScopes.size() <= 1) {
+        for (const Scope *functionScope : functionScopes) {
+            if (!tryExecuteFunction(functionScope, errorLogger, tokenizer, settings, callbacks, report, std::cout, &solverCache))
+                break;
         }
+        return;
+    }
+
+    // The functions are executed in parallel, the output is replayed in the
+    // function order so the result does not depend on the scheduling
+    std::vector<FunctionErrorBuffer> buffers(functionScopes.size());
+    std::vector<std::ostringstream> reports(functionScopes.size());
+    std::vector<std::ostringstream> outs(functionScopes.size());
+    std::vector<char> terminated(functionScopes.size(), 0);
+    std::atomic<bool> stop(false);
+    std::atomic<std::size_t> next(0);
+    auto worker = [&]() {
+        for (std::size_t i = next++; i < functionScopes.size() && !stop; i = next++) {
+            if (!tryExecuteFunction(functionScopes[i], errorLogger ? &buffers[i] : nullptr, tokenizer, settings, callbacks, reports[i], outs[i], &solverCache)) {
+                terminated[i] = 1;
+                stop = true;
+            }
+        }
+    };
+
+    const std::size_t threadCount = std::min<std::size_t>(settings->bugHuntingJobs, functionScopes.size());
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < threadCount; ++i)
+        threads.emplace_back(worker);
+    worker();
+    for (std::thread &t : threads)
+        t.join();
+
+    for (std::size_t i = 0; i < functionScopes.size(); ++i) {
+        if (errorLogger) {
+            for (const std::pair<std::string, Color> &outmsg : buffers[i].out)
+                errorLogger->reportOut(outmsg.first, outmsg.second);
+            for (const ErrorMessage &errmsg : buffers[i].errors)
+                errorLogger->reportErr(errmsg);
+            for (const std::string &str : buffers[i].bughunting)
+                errorLogger->bughuntingReport(str);
+        }
+        std::cout << outs[i].str();
+        report << reports[i].str();
+        if (terminated[i])
+            break;
     }
 }
 
@@ -2986,6 +3240,12 @@ static ExprEngine::ValuePtr createVariableValue(const Variable &var, Data &data)
 }
 
 void ExprEngine::executeFunction(const Scope *functionScope, ErrorLogger *errorLogger, const Tokenizer *tokenizer, const Settings *settings, const std::vector<ExprEngine::Callback> &callbacks, std::ostream &report)
+{
+    SolverCache solverCache;
+    ::executeFunction(functionScope, errorLogger, tokenizer, settings, callbacks, report, &solverCache);
+}
+
+static void executeFunction(const Scope *functionScope, ErrorLogger *errorLogger, const Tokenizer *tokenizer, const Settings *settings, const std::vector<ExprEngine::Callback> &callbacks, std::ostream &report, SolverCache *solverCache)
 {
     if (!functionScope->bodyStart)
         return;
@@ -3000,7 +3260,9 @@ void ExprEngine::executeFunction(const Scope *functionScope, ErrorLogger *errorL
 
     int symbolValueIndex = 0;
     TrackExecution trackExecution;
-    Data data(&symbolValueIndex, errorLogger, tokenizer, settings, currentFunction, callbacks, &trackExecution);
+    SolverStats solverStats;
+    PathSolver pathSolver;
+    Data data(&symbolValueIndex, errorLogger, tokenizer, settings, currentFunction, callbacks, &trackExecution, solverCache, &solverStats, &pathSolver);
 
     for (const Variable &arg : function->argumentList)
         data.assignValue(functionScope->bodyStart, arg.declarationId(), createVariableValue(arg, data));
@@ -3017,7 +3279,7 @@ void ExprEngine::executeFunction(const Scope *functionScope, ErrorLogger *errorL
         if (settings->debugBugHunting)
             report << "ExprEngineException " << e.tok->linenr() << ":" << e.tok->column() << ": " << e.what << "\n";
         trackExecution.setAbortLine(e.tok->linenr());
-        auto bailoutValue = std::make_shared<BailoutValue>();
+        auto bailoutValue = std::make_shared<ExprEngine::BailoutValue>();
         for (const Token *tok = e.tok; tok != functionScope->bodyEnd; tok = tok->next()) {
             if (std::time(nullptr) >= stopTime)
                 break;
@@ -3068,6 +3330,8 @@ void ExprEngine::executeFunction(const Scope *functionScope, ErrorLogger *errorL
             report << "[intvar] " << v << std::endl;
         for (const std::string &f: trackExecution.getMissingContracts())
             report << "[missing contract] " << f << std::endl;
+        if (solverStats.queries > 0)
+            report << "[solver time] " << currentFunction << " " << solverStats.seconds << "s, " << solverStats.queries << " queries, " << solverStats.cacheHits << " cached, " << solverStats.reusedConstraints << " reused constraints" << std::endl;
     }
 }
 
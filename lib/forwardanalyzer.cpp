@@ -23,11 +23,12 @@ struct OnExit {
 struct ForwardTraversal {
     enum class Progress { Continue, Break, Skip };
     enum class Terminate { None, Bail, Escape, Modified, Inconclusive, Conditional };
-    ForwardTraversal(const ValuePtr<Analyzer>& analyzer, const Settings* settings)
-        : analyzer(analyzer), settings(settings), actions(Analyzer::Action::None), analyzeOnly(false), analyzeTerminate(false)
+    ForwardTraversal(const ValuePtr<Analyzer>& analyzer, const Settings* settings, ValueFlowCost* cost)
+        : analyzer(analyzer), settings(settings), cost(cost), actions(Analyzer::Action::None), analyzeOnly(false), analyzeTerminate(false)
     {}
     ValuePtr<Analyzer> analyzer;
     const Settings* settings;
+    ValueFlowCost* cost;
     Analyzer::Action actions;
     bool analyzeOnly;
     bool analyzeTerminate;
@@ -35,6 +36,11 @@ struct ForwardTraversal {
     bool forked = false;
     std::vector<Token*> loopEnds = {};
 
+    /** read only access to the analyzer, a forked analyzer stays shared with its parent */
+    const Analyzer* reader() const {
+        return analyzer.get();
+    }
+
     Progress Break(Analyzer::Terminate t = Analyzer::Terminate::None) {
         if ((!analyzeOnly || analyzeTerminate) && t != Analyzer::Terminate::None)
             terminate = t;
@@ -74,7 +80,7 @@ struct ForwardTraversal {
     std::pair<bool, bool> evalCond(const Token* tok, const Token* ctx = nullptr) const {
         if (!tok)
             return std::make_pair(false, false);
-        std::vector<MathLib::bigint> result = analyzer->evaluate(tok, ctx);
+        std::vector<MathLib::bigint> result = reader()->evaluate(tok, ctx);
         // TODO: We should convert to bool
         bool checkThen = std::any_of(result.begin(), result.end(), [](int x) {
             return x != 0;
@@ -168,7 +174,7 @@ struct ForwardTraversal {
             bool checkThen, checkElse;
             std::tie(checkThen, checkElse) = evalCond(condTok);
             if (!checkThen && !checkElse) {
-                if (!traverseUnknown && analyzer->stopOnCondition(condTok) && stopUpdates()) {
+                if (!traverseUnknown && reader()->stopOnCondition(condTok) && stopUpdates()) {
                     return Progress::Continue;
                 }
                 checkThen = true;
@@ -192,7 +198,9 @@ struct ForwardTraversal {
     }
 
     Progress update(Token* tok) {
-        Analyzer::Action action = analyzer->analyze(tok, Analyzer::Direction::Forward);
+        if (cost && !cost->step(settings))
+            return Break(Analyzer::Terminate::Bail);
+        Analyzer::Action action = reader()->analyze(tok, Analyzer::Direction::Forward);
         actions |= action;
         if (!action.isNone() && !analyzeOnly)
             analyzer->update(tok, action, Analyzer::Direction::Forward);
@@ -224,7 +232,7 @@ struct ForwardTraversal {
     template<class T, class F>
     T* findRange(T* start, const Token* end, F pred) {
         for (T* tok = start; tok && tok != end; tok = tok->next()) {
-            Analyzer::Action action = analyzer->analyze(tok, Analyzer::Direction::Forward);
+            Analyzer::Action action = reader()->analyze(tok, Analyzer::Direction::Forward);
             if (pred(action))
                 return tok;
         }
@@ -234,7 +242,7 @@ struct ForwardTraversal {
     Analyzer::Action analyzeRecursive(const Token* start) {
         Analyzer::Action result = Analyzer::Action::None;
         auto f = [&](const Token* tok) {
-            result = analyzer->analyze(tok, Analyzer::Direction::Forward);
+            result = reader()->analyze(tok, Analyzer::Direction::Forward);
             if (result.isModified() || result.isInconclusive())
                 return Break();
             return Progress::Continue;
@@ -246,7 +254,7 @@ struct ForwardTraversal {
     Analyzer::Action analyzeRange(const Token* start, const Token* end) {
         Analyzer::Action result = Analyzer::Action::None;
         for (const Token* tok = start; tok && tok != end; tok = tok->next()) {
-            Analyzer::Action action = analyzer->analyze(tok, Analyzer::Direction::Forward);
+            Analyzer::Action action = reader()->analyze(tok, Analyzer::Direction::Forward);
             if (action.isModified() || action.isInconclusive())
                 return action;
             result |= action;
@@ -255,6 +263,7 @@ struct ForwardTraversal {
     }
 
     ForwardTraversal fork(bool analyze = false) const {
+        ++ForwardAnalyzerCounters::get().forks;
         ForwardTraversal ft = *this;
         if (analyze) {
             ft.analyzeOnly = true;
@@ -266,7 +275,7 @@ struct ForwardTraversal {
     }
 
     std::vector<ForwardTraversal> tryForkScope(Token* endBlock, bool isModified = false) {
-        if (analyzer->updateScope(endBlock, isModified)) {
+        if (reader()->updateScope(endBlock, isModified)) {
             ForwardTraversal ft = fork();
             return {ft};
         }
@@ -413,7 +422,7 @@ struct ForwardTraversal {
             if (hasJump(endBlock)) {
                 if (!analyzer->lowerToPossible())
                     return Break(Analyzer::Terminate::Bail);
-                if (analyzer->isConditional() && stopUpdates())
+                if (reader()->isConditional() && stopUpdates())
                     return Break(Analyzer::Terminate::Conditional);
             }
             return Progress::Continue;
@@ -449,7 +458,7 @@ struct ForwardTraversal {
                 if (updateRecursive(condTok) == Progress::Break)
                     return Break();
         }
-        if (!checkThen && !checkElse && !isDoWhile && analyzer->stopOnCondition(condTok) && stopUpdates())
+        if (!checkThen && !checkElse && !isDoWhile && reader()->stopOnCondition(condTok) && stopUpdates())
             return Break(Analyzer::Terminate::Conditional);
         // condition is false, we don't enter the loop
         if (checkElse)
@@ -479,7 +488,7 @@ struct ForwardTraversal {
                 // TODO: Don't bail on missing condition
                 if (!condTok)
                     return Break(Analyzer::Terminate::Bail);
-                if (analyzer->isConditional() && stopUpdates())
+                if (reader()->isConditional() && stopUpdates())
                     return Break(Analyzer::Terminate::Conditional);
                 analyzer->assume(condTok, false);
             }
@@ -615,7 +624,7 @@ struct ForwardTraversal {
                             return Break();
                         bool isEmpty = false;
                         std::vector<MathLib::bigint> result =
-                            analyzer->evaluate(Analyzer::Evaluate::ContainerEmpty, conTok);
+                            reader()->evaluate(Analyzer::Evaluate::ContainerEmpty, conTok);
                         if (result.empty())
                             analyzer->assume(conTok, false, Analyzer::Assume::ContainerEmpty);
                         else
@@ -636,7 +645,7 @@ struct ForwardTraversal {
                     Branch elseBranch{endBlock->tokAt(2) ? endBlock->linkAt(2) : nullptr};
                     // Check if condition is true or false
                     std::tie(thenBranch.check, elseBranch.check) = evalCond(condTok);
-                    if (!thenBranch.check && !elseBranch.check && analyzer->stopOnCondition(condTok) && stopUpdates())
+                    if (!thenBranch.check && !elseBranch.check && reader()->stopOnCondition(condTok) && stopUpdates())
                         return Break(Analyzer::Terminate::Conditional);
                     bool hasElse = Token::simpleMatch(endBlock, "} else {");
                     bool bail = false;
@@ -690,7 +699,7 @@ struct ForwardTraversal {
                         } else if (thenBranch.check) {
                             return Break();
                         } else {
-                            if (analyzer->isConditional() && stopUpdates())
+                            if (reader()->isConditional() && stopUpdates())
                                 return Break(Analyzer::Terminate::Conditional);
                             analyzer->assume(condTok, false);
                         }
@@ -699,7 +708,7 @@ struct ForwardTraversal {
                         if (!analyzer->lowerToInconclusive())
                             return Break(Analyzer::Terminate::Bail);
                     } else if (thenBranch.isModified() || elseBranch.isModified()) {
-                        if (!hasElse && analyzer->isConditional() && stopUpdates())
+                        if (!hasElse && reader()->isConditional() && stopUpdates())
                             return Break(Analyzer::Terminate::Conditional);
                         if (!analyzer->lowerToPossible())
                             return Break(Analyzer::Terminate::Bail);
@@ -825,14 +834,22 @@ struct ForwardTraversal {
 
 Analyzer::Result valueFlowGenericForward(Token* start, const Token* end, const ValuePtr<Analyzer>& a, const Settings* settings)
 {
-    ForwardTraversal ft{a, settings};
+    ValueFlowCost* cost = ValueFlowCost::get(start);
+    if (cost && cost->bailout)
+        return {Analyzer::Action::None, Analyzer::Terminate::Bail};
+    ValueFlowCost::Measure measure(cost);
+    ForwardTraversal ft{a, settings, cost};
     ft.updateRange(start, end);
     return {ft.actions, ft.terminate};
 }
 
 Analyzer::Result valueFlowGenericForward(Token* start, const ValuePtr<Analyzer>& a, const Settings* settings)
 {
-    ForwardTraversal ft{a, settings};
+    ValueFlowCost* cost = ValueFlowCost::get(start);
+    if (cost && cost->bailout)
+        return {Analyzer::Action::None, Analyzer::Terminate::Bail};
+    ValueFlowCost::Measure measure(cost);
+    ForwardTraversal ft{a, settings, cost};
     ft.updateRecursive(start);
     return {ft.actions, ft.terminate};
 }
@@ -21,10 +21,23 @@
 
 #include "analyzer.h"
 
+#include <cstddef>
+
 class Settings;
 class Token;
 template<class T> class ValuePtr;
 
+/** Number of branches that the forward analysis forked, counted per thread (--showtime) */
+struct ForwardAnalyzerCounters {
+    ForwardAnalyzerCounters() : forks(0) {}
+    std::size_t forks;
+
+    static ForwardAnalyzerCounters& get() {
+        static thread_local ForwardAnalyzerCounters counters;
+        return counters;
+    }
+};
+
 Analyzer::Result valueFlowGenericForward(Token* start,
                                          const Token* end,
                                          const ValuePtr<Analyzer>& a,
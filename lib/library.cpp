@@ -26,12 +26,16 @@
 #include "token.h"
 #include "tokenlist.h"
 #include "utils.h"
+#include "version.h"
 
 #include <cctype>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <list>
+#include <sstream>
 #include <string>
+#include <type_traits>
 
 static std::vector<std::string> getnames(const char *names)
 {
@@ -56,9 +60,52 @@ static void gettokenlistfromvalid(const std::string& valid, TokenList& tokenList
     }
 }
 
-Library::Library() : bugHunting(false), mAllocId(0)
+Library::Library() : bugHunting(false), mAllocId(0), mIndexesBuilt(false)
 {}
 
+// the files that are tried when the configuration file is loaded, in order
+static std::vector<std::string> getCfgCandidates(const char exename[], const std::string &path)
+{
+    std::vector<std::string> candidates(1, path);
+
+    // is there no extension?
+    std::string fullfilename(path);
+    if (Path::getFilenameExtension(fullfilename).empty()) {
+        fullfilename += ".cfg";
+        candidates.push_back(fullfilename);
+    }
+
+    std::list<std::string> cfgfolders;
+#ifdef FILESDIR
+    cfgfolders.emplace_back(FILESDIR "/cfg");
+#endif
+    if (exename) {
+        const std::string exepath(Path::fromNativeSeparators(Path::getPathFromFilename(exename)));
+        cfgfolders.push_back(exepath + "cfg");
+        cfgfolders.push_back(exepath);
+    }
+
+    while (!cfgfolders.empty()) {
+        const std::string cfgfolder(cfgfolders.back());
+        cfgfolders.pop_back();
+        const char *sep = (!cfgfolder.empty() && endsWith(cfgfolder,'/') ? "" : "/");
+        candidates.push_back(cfgfolder + sep + fullfilename);
+    }
+    return candidates;
+}
+
+// absolute path of the file that load() would read, empty if there is none
+static std::string resolveCfg(const char exename[], const std::string &path)
+{
+    for (const std::string &filename : getCfgCandidates(exename, path)) {
+        // a directory can be opened but not read
+        std::ifstream fin(filename);
+        if (fin.is_open() && (fin.peek(), !fin.bad()))
+            return Path::getAbsoluteFilePath(filename);
+    }
+    return "";
+}
+
 Library::Error Library::load(const char exename[], const char path[])
 {
     if (std::strchr(path,',') != nullptr) {
@@ -80,50 +127,29 @@ Library::Error Library::load(const char exename[], const char path[])
     std::string absolute_path;
     // open file..
     tinyxml2::XMLDocument doc;
-    tinyxml2::XMLError error = doc.LoadFile(path);
-    if (error == tinyxml2::XML_ERROR_FILE_READ_ERROR && Path::getFilenameExtension(path).empty())
-        // Reading file failed, try again...
-        error = tinyxml2::XML_ERROR_FILE_NOT_FOUND;
-    if (error == tinyxml2::XML_ERROR_FILE_NOT_FOUND) {
-        // failed to open file.. is there no extension?
-        std::string fullfilename(path);
-        if (Path::getFilenameExtension(fullfilename).empty()) {
-            fullfilename += ".cfg";
-            error = doc.LoadFile(fullfilename.c_str());
-            if (error != tinyxml2::XML_ERROR_FILE_NOT_FOUND)
-                absolute_path = Path::getAbsoluteFilePath(fullfilename);
-        }
-
-        std::list<std::string> cfgfolders;
-#ifdef FILESDIR
-        cfgfolders.emplace_back(FILESDIR "/cfg");
-#endif
-        if (exename) {
-            const std::string exepath(Path::fromNativeSeparators(Path::getPathFromFilename(exename)));
-            cfgfolders.push_back(exepath + "cfg");
-            cfgfolders.push_back(exepath);
+    tinyxml2::XMLError error = tinyxml2::XML_ERROR_FILE_NOT_FOUND;
+    for (const std::string &filename : getCfgCandidates(exename, path)) {
+        error = doc.LoadFile(filename.c_str());
+        if (error == tinyxml2::XML_ERROR_FILE_READ_ERROR && Path::getFilenameExtension(filename).empty())
+            // Reading file failed, try again...
+            error = tinyxml2::XML_ERROR_FILE_NOT_FOUND;
+        if (error != tinyxml2::XML_ERROR_FILE_NOT_FOUND) {
+            absolute_path = Path::getAbsoluteFilePath(filename);
+            break;
         }
-
-        while (error == tinyxml2::XML_ERROR_FILE_NOT_FOUND && !cfgfolders.empty()) {
-            const std::string cfgfolder(cfgfolders.back());
-            cfgfolders.pop_back();
-            const char *sep = (!cfgfolder.empty() && endsWith(cfgfolder,'/') ? "" : "/");
-            const std::string filename(cfgfolder + sep + fullfilename);
-            error = doc.LoadFile(filename.c_str());
-            if (error != tinyxml2::XML_ERROR_FILE_NOT_FOUND)
-                absolute_path = Path::getAbsoluteFilePath(filename);
-        }
-    } else
-        absolute_path = Path::getAbsoluteFilePath(path);
+    }
 
     if (error == tinyxml2::XML_SUCCESS) {
         if (mFiles.find(absolute_path) == mFiles.end()) {
             Error err = load(doc);
-            if (err.errorcode == ErrorCode::OK)
+            if (err.errorcode == ErrorCode::OK) {
                 mFiles.insert(absolute_path);
+                mLoadedFiles.emplace_back(path, absolute_path);
+            }
             return err;
         }
 
+        mLoadedFiles.emplace_back(path, absolute_path);
         return Error(ErrorCode::OK); // ignore duplicates
     }
 
@@ -135,6 +161,679 @@ Library::Error Library::load(const char exename[], const char path[])
     }
 }
 
+class Library::CacheWriter {
+public:
+    /**
+     * When layout is true no values are written. Each value is described by
+     * its type instead, and each range by a sample element, so the result
+     * describes the layout of the cache.
+     */
+    explicit CacheWriter(std::string &data, bool layout = false) : mData(data), mLayout(layout) {}
+
+    void write(bool b) {
+        if (mLayout)
+            mData += 'b';
+        else
+            mData += b ? '\1' : '\0';
+    }
+    void write(char c) {
+        mData += mLayout ? 'c' : c;
+    }
+    void write(long long value) {
+        if (mLayout) {
+            mData += 'l';
+            return;
+        }
+        // zigzag encoding so small negative numbers are small too
+        writeSize((static_cast<unsigned long long>(value) << 1) ^ static_cast<unsigned long long>(value >> 63));
+    }
+    void write(int value) {
+        if (mLayout)
+            mData += 'i';
+        else
+            write(static_cast<long long>(value));
+    }
+    void write(unsigned int value) {
+        if (mLayout)
+            mData += 'u';
+        else
+            writeSize(value);
+    }
+    void writeSize(unsigned long long value) {
+        while (value >= 0x80) {
+            mData += static_cast<char>((value & 0x7f) | 0x80);
+            value >>= 7;
+        }
+        mData += static_cast<char>(value);
+    }
+    void write(const std::string &str) {
+        if (mLayout) {
+            mData += 's';
+            return;
+        }
+        writeSize(str.size());
+        mData += str;
+    }
+    template<class T>
+    typename std::enable_if<std::is_enum<T>::value>::type write(T value) {
+        write(static_cast<int>(value));
+    }
+    template<class T1, class T2>
+    void write(const std::pair<T1, T2> &p) {
+        write(p.first);
+        write(p.second);
+    }
+    template<class T>
+    void writeRange(const T &range) {
+        if (mLayout) {
+            writeLayout(typename T::value_type());
+            return;
+        }
+        writeSize(range.size());
+        for (typename T::const_iterator it = range.begin(); it != range.end(); ++it)
+            write(*it);
+    }
+    template<class T>
+    void write(const std::vector<T> &v) {
+        writeRange(v);
+    }
+    template<class T>
+    void write(const std::set<T> &v) {
+        writeRange(v);
+    }
+    template<class K, class V>
+    void write(const std::map<K, V> &m) {
+        writeRange(m);
+    }
+    template<class K, class V>
+    void write(const std::unordered_map<K, V> &m) {
+        writeRange(m);
+    }
+
+    void write(const Standards &standards) {
+        write(standards.c);
+        write(standards.cpp);
+        write(standards.stdValue);
+    }
+    void write(const WarnInfo &warn) {
+        write(warn.message);
+        write(warn.standards);
+        write(warn.severity);
+    }
+    void write(const Container::Function &f) {
+        write(f.action);
+        write(f.yield);
+    }
+    void write(const Container::RangeItemRecordTypeItem &item) {
+        write(item.name);
+        write(item.templateParameter);
+    }
+    void write(const Container &c) {
+        write(c.startPattern);
+        write(c.startPattern2);
+        write(c.endPattern);
+        write(c.itEndPattern);
+        write(c.functions);
+        write(c.type_templateArgNo);
+        write(c.rangeItemRecordType);
+        write(c.size_templateArgNo);
+        write(c.arrayLike_indexOp);
+        write(c.stdStringLike);
+        write(c.stdAssociativeLike);
+        write(c.opLessAllowed);
+        write(c.hasInitializerListConstructor);
+        write(c.unstableErase);
+        write(c.unstableInsert);
+        write(c.view);
+    }
+    void write(const std::vector<ArgumentChecks::MinSize> &minsizes) {
+        if (mLayout) {
+            writeLayout(ArgumentChecks::MinSize(ArgumentChecks::MinSize::Type::NONE, 0));
+            return;
+        }
+        writeSize(minsizes.size());
+        for (const ArgumentChecks::MinSize &minsize : minsizes)
+            write(minsize);
+    }
+    void write(const ArgumentChecks::MinSize &minsize) {
+        write(minsize.type);
+        write(minsize.arg);
+        write(minsize.arg2);
+        write(minsize.value);
+    }
+    void write(const ArgumentChecks &ac) {
+        write(ac.notbool);
+        write(ac.notnull);
+        write(ac.notuninit);
+        write(ac.formatstr);
+        write(ac.strz);
+        write(ac.optional);
+        write(ac.variadic);
+        write(ac.valid);
+        write(ac.iteratorInfo.container);
+        write(ac.iteratorInfo.it);
+        write(ac.iteratorInfo.first);
+        write(ac.iteratorInfo.last);
+        write(ac.minsizes);
+        write(ac.direction);
+    }
+    void write(const Function &f) {
+        write(f.argumentChecks);
+        write(f.use);
+        write(f.leakignore);
+        write(f.isconst);
+        write(f.ispure);
+        write(f.useretval);
+        write(f.ignore);
+        write(f.formatstr);
+        write(f.formatstr_scan);
+        write(f.formatstr_secure);
+        write(f.containerAction);
+        write(f.containerYield);
+    }
+    void write(const SmartPointer &sp) {
+        write(sp.name);
+        write(sp.unique);
+    }
+    void write(const AllocFunc &af) {
+        write(af.groupId);
+        write(af.arg);
+        write(af.bufferSize);
+        write(af.bufferSizeArg1);
+        write(af.bufferSizeArg2);
+        write(af.reallocArg);
+        write(af.initData);
+    }
+    void write(const CodeBlock &block) {
+        write(block.start());
+        write(block.end());
+        write(block.offset());
+        write(block.blocks());
+    }
+    void write(const ExportedFunctions &exporter) {
+        write(exporter.prefixes());
+        write(exporter.suffixes());
+    }
+    void write(const PodType &podType) {
+        write(podType.size);
+        write(podType.sign);
+        write(podType.stdtype);
+    }
+    void write(const PlatformType &type) {
+        write(type.mType);
+        write(type.mSigned);
+        write(type.mUnsigned);
+        write(type.mLong);
+        write(type.mPointer);
+        write(type.mPtrPtr);
+        write(type.mConstPtr);
+    }
+    void write(const Platform &platform) {
+        write(platform.mPlatformTypes);
+    }
+    void write(const NonOverlappingData &data) {
+        write(data.ptr1Arg);
+        write(data.ptr2Arg);
+        write(data.sizeArg);
+        write(data.strlenArg);
+    }
+
+private:
+    template<class T>
+    void writeLayout(const T &sample) {
+        mData += '[';
+        write(sample);
+        mData += ']';
+    }
+
+    std::string &mData;
+    const bool mLayout;
+};
+
+class Library::CacheReader {
+public:
+    explicit CacheReader(const std::string &data) : mData(data), mPos(0), mFailed(false) {}
+
+    bool failed() const {
+        return mFailed;
+    }
+    bool atEnd() const {
+        return mPos == mData.size();
+    }
+
+    void read(bool &b) {
+        char c = 0;
+        read(c);
+        b = (c != 0);
+    }
+    void read(char &c) {
+        if (mPos >= mData.size()) {
+            mFailed = true;
+            c = 0;
+            return;
+        }
+        c = mData[mPos++];
+    }
+    void read(long long &value) {
+        const unsigned long long u = readSize();
+        value = static_cast<long long>(u >> 1) ^ -static_cast<long long>(u & 1);
+    }
+    void read(int &value) {
+        long long v = 0;
+        read(v);
+        value = static_cast<int>(v);
+    }
+    void read(unsigned int &value) {
+        value = static_cast<unsigned int>(readSize());
+    }
+    unsigned long long readSize() {
+        unsigned long long value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            char c = 0;
+            read(c);
+            if (mFailed)
+                return 0;
+            value |= static_cast<unsigned long long>(c & 0x7f) << shift;
+            if ((c & 0x80) == 0)
+                return value;
+        }
+        mFailed = true;
+        return 0;
+    }
+    void read(std::string &str) {
+        const unsigned long long size = readSize();
+        if (mFailed || size > mData.size() - mPos) {
+            mFailed = true;
+            str.clear();
+            return;
+        }
+        str.assign(mData, mPos, size);
+        mPos += size;
+    }
+    template<class T>
+    typename std::enable_if<std::is_enum<T>::value>::type read(T &value) {
+        int i = 0;
+        read(i);
+        value = static_cast<T>(i);
+    }
+    template<class T1, class T2>
+    void read(std::pair<T1, T2> &p) {
+        read(p.first);
+        read(p.second);
+    }
+    template<class T>
+    void read(std::vector<T> &v) {
+        v.clear();
+        for (unsigned long long n = readSize(); n > 0 && !mFailed; --n) {
+            T value;
+            read(value);
+            v.push_back(value);
+        }
+    }
+    template<class T>
+    void read(std::set<T> &s) {
+        s.clear();
+        for (unsigned long long n = readSize(); n > 0 && !mFailed; --n) {
+            T value;
+            read(value);
+            s.insert(value);
+        }
+    }
+    template<class M>
+    void readMap(M &m) {
+        m.clear();
+        for (unsigned long long n = readSize(); n > 0 && !mFailed; --n) {
+            typename M::key_type key;
+            read(key);
+            read(m[key]);
+        }
+    }
+    template<class K, class V>
+    void read(std::map<K, V> &m) {
+        readMap(m);
+    }
+    template<class K, class V>
+    void read(std::unordered_map<K, V> &m) {
+        readMap(m);
+    }
+
+    void read(Standards &standards) {
+        read(standards.c);
+        read(standards.cpp);
+        read(standards.stdValue);
+    }
+    void read(WarnInfo &warn) {
+        read(warn.message);
+        read(warn.standards);
+        read(warn.severity);
+    }
+    void read(Container::Function &f) {
+        read(f.action);
+        read(f.yield);
+    }
+    void read(Container::RangeItemRecordTypeItem &item) {
+        read(item.name);
+        read(item.templateParameter);
+    }
+    void read(Container &c) {
+        read(c.startPattern);
+        read(c.startPattern2);
+        read(c.endPattern);
+        read(c.itEndPattern);
+        read(c.functions);
+        read(c.type_templateArgNo);
+        read(c.rangeItemRecordType);
+        read(c.size_templateArgNo);
+        read(c.arrayLike_indexOp);
+        read(c.stdStringLike);
+        read(c.stdAssociativeLike);
+        read(c.opLessAllowed);
+        read(c.hasInitializerListConstructor);
+        read(c.unstableErase);
+        read(c.unstableInsert);
+        read(c.view);
+    }
+    void read(std::vector<ArgumentChecks::MinSize> &minsizes) {
+        minsizes.clear();
+        for (unsigned long long n = readSize(); n > 0 && !mFailed; --n) {
+            ArgumentChecks::MinSize minsize(ArgumentChecks::MinSize::Type::NONE, 0);
+            read(minsize.type);
+            read(minsize.arg);
+            read(minsize.arg2);
+            read(minsize.value);
+            minsizes.push_back(minsize);
+        }
+    }
+    void read(ArgumentChecks &ac) {
+        read(ac.notbool);
+        read(ac.notnull);
+        read(ac.notuninit);
+        read(ac.formatstr);
+        read(ac.strz);
+        read(ac.optional);
+        read(ac.variadic);
+        read(ac.valid);
+        read(ac.iteratorInfo.container);
+        read(ac.iteratorInfo.it);
+        read(ac.iteratorInfo.first);
+        read(ac.iteratorInfo.last);
+        read(ac.minsizes);
+        read(ac.direction);
+    }
+    void read(Function &f) {
+        read(f.argumentChecks);
+        read(f.use);
+        read(f.leakignore);
+        read(f.isconst);
+        read(f.ispure);
+        read(f.useretval);
+        read(f.ignore);
+        read(f.formatstr);
+        read(f.formatstr_scan);
+        read(f.formatstr_secure);
+        read(f.containerAction);
+        read(f.containerYield);
+    }
+    void read(SmartPointer &sp) {
+        read(sp.name);
+        read(sp.unique);
+    }
+    void read(AllocFunc &af) {
+        read(af.groupId);
+        read(af.arg);
+        read(af.bufferSize);
+        read(af.bufferSizeArg1);
+        read(af.bufferSizeArg2);
+        read(af.reallocArg);
+        read(af.initData);
+    }
+    void read(CodeBlock &block) {
+        std::string str;
+        read(str);
+        block.setStart(str.c_str());
+        read(str);
+        block.setEnd(str.c_str());
+        int offset = 0;
+        read(offset);
+        block.setOffset(offset);
+        std::set<std::string> blocks;
+        read(blocks);
+        for (const std::string &b : blocks)
+            block.addBlock(b.c_str());
+    }
+    void read(ExportedFunctions &exporter) {
+        std::set<std::string> names;
+        read(names);
+        for (const std::string &prefix : names)
+            exporter.addPrefix(prefix);
+        read(names);
+        for (const std::string &suffix : names)
+            exporter.addSuffix(suffix);
+    }
+    void read(PodType &podType) {
+        read(podType.size);
+        read(podType.sign);
+        read(podType.stdtype);
+    }
+    void read(PlatformType &type) {
+        read(type.mType);
+        read(type.mSigned);
+        read(type.mUnsigned);
+        read(type.mLong);
+        read(type.mPointer);
+        read(type.mPtrPtr);
+        read(type.mConstPtr);
+    }
+    void read(Platform &platform) {
+        read(platform.mPlatformTypes);
+    }
+    void read(NonOverlappingData &data) {
+        read(data.ptr1Arg);
+        read(data.ptr2Arg);
+        read(data.sizeArg);
+        read(data.strlenArg);
+    }
+
+private:
+    const std::string &mData;
+    std::string::size_type mPos;
+    bool mFailed;
+};
+
+static const char libraryCacheMagic[] = "cppcheck library cache";
+/** Version of the cache encoding, the cached members are described by Library::cacheLayout() */
+static const unsigned int libraryCacheVersion = 2;
+
+static bool readWholeFile(const std::string &filename, std::string &data)
+{
+    std::ifstream fin(filename, std::ios::in | std::ios::binary);
+    if (!fin.is_open())
+        return false;
+    std::ostringstream ostr;
+    ostr << fin.rdbuf();
+    data = ostr.str();
+    return !fin.bad();
+}
+
+static unsigned long long fnv1a(const std::string &data)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    for (const char c : data) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// FNV-1a hash of the file contents
+static bool fileHash(const std::string &filename, unsigned long long &hash)
+{
+    std::string data;
+    if (!readWholeFile(filename, data))
+        return false;
+    hash = fnv1a(data);
+    return true;
+}
+
+void Library::writeCacheData(CacheWriter &writer) const
+{
+    writer.write(functionwarn);
+    writer.write(containers);
+    writer.write(functions);
+    writer.write(defines);
+    writer.write(smartPointers);
+    writer.write(mAllocId);
+    writer.write(mFiles);
+    writer.write(mAlloc);
+    writer.write(mDealloc);
+    writer.write(mRealloc);
+    writer.write(mNoReturn);
+    writer.write(mReturnValue);
+    writer.write(mReturnValueType);
+    writer.write(mReturnValueContainer);
+    writer.write(mUnknownReturnValues);
+    writer.write(mReportErrors);
+    writer.write(mProcessAfterCode);
+    writer.write(mMarkupExtensions);
+    writer.write(mKeywords);
+    writer.write(mExecutableBlocks);
+    writer.write(mExporters);
+    writer.write(mImporters);
+    writer.write(mReflection);
+    writer.write(mPodTypes);
+    writer.write(mPlatformTypes);
+    writer.write(mPlatforms);
+    writer.write(mTypeChecks);
+    writer.write(mNonOverlappingData);
+}
+
+unsigned long long Library::cacheLayout()
+{
+    std::string layout;
+    CacheWriter writer(layout, true);
+    Library().writeCacheData(writer);
+    return fnv1a(layout);
+}
+
+bool Library::saveCache(const std::string &filename) const
+{
+    std::string data;
+    CacheWriter writer(data);
+    writer.write(std::string(libraryCacheMagic));
+    writer.write(libraryCacheVersion);
+    writer.writeSize(cacheLayout());
+    writer.write(std::string(CPPCHECK_VERSION_STRING));
+
+    writer.writeSize(mLoadedFiles.size());
+    for (const std::pair<std::string, std::string> &file : mLoadedFiles) {
+        unsigned long long hash = 0;
+        if (!fileHash(file.second, hash))
+            return false;
+        writer.write(file.first);
+        writer.write(file.second);
+        writer.writeSize(hash);
+    }
+
+    writeCacheData(writer);
+
+    std::ofstream fout(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!fout.is_open())
+        return false;
+    fout.write(data.data(), data.size());
+    return fout.good();
+}
+
+bool Library::loadCache(const std::string &filename, const char exename[], const std::vector<std::string> &cfgs)
+{
+    if (!mFiles.empty() || !mLoadedFiles.empty())
+        return false;
+
+    std::string data;
+    if (!readWholeFile(filename, data))
+        return false;
+
+    CacheReader reader(data);
+    std::string magic, toolVersion;
+    unsigned int version = 0;
+    reader.read(magic);
+    reader.read(version);
+    const unsigned long long layout = reader.readSize();
+    reader.read(toolVersion);
+    if (reader.failed() || magic != libraryCacheMagic || version != libraryCacheVersion || layout != cacheLayout() || toolVersion != CPPCHECK_VERSION_STRING)
+        return false;
+
+    // the same configuration files must be requested..
+    std::vector<std::string> names;
+    for (const std::string &cfg : cfgs) {
+        std::string::size_type start = 0;
+        for (;;) {
+            const std::string::size_type end = cfg.find(',', start);
+            const std::string name = cfg.substr(start, end == std::string::npos ? std::string::npos : end - start);
+            if (!name.empty())
+                names.push_back(name);
+            if (end == std::string::npos)
+                break;
+            start = end + 1;
+        }
+    }
+
+    Library library;
+    library.bugHunting = bugHunting;
+    const unsigned long long fileCount = reader.readSize();
+    if (reader.failed() || fileCount != names.size())
+        return false;
+    for (const std::string &name : names) {
+        std::pair<std::string, std::string> file;
+        reader.read(file);
+        const unsigned long long hash = reader.readSize();
+        if (reader.failed() || file.first != name)
+            return false;
+        // ..they must resolve to the same files as before..
+        if (resolveCfg(exename, name) != file.second)
+            return false;
+        // ..and they must be unchanged
+        unsigned long long currentHash = 0;
+        if (!fileHash(file.second, currentHash) || currentHash != hash)
+            return false;
+        library.mLoadedFiles.push_back(file);
+    }
+
+    reader.read(library.functionwarn);
+    reader.read(library.containers);
+    reader.read(library.functions);
+    reader.read(library.defines);
+    reader.read(library.smartPointers);
+    reader.read(library.mAllocId);
+    reader.read(library.mFiles);
+    reader.read(library.mAlloc);
+    reader.read(library.mDealloc);
+    reader.read(library.mRealloc);
+    reader.read(library.mNoReturn);
+    reader.read(library.mReturnValue);
+    reader.read(library.mReturnValueType);
+    reader.read(library.mReturnValueContainer);
+    reader.read(library.mUnknownReturnValues);
+    reader.read(library.mReportErrors);
+    reader.read(library.mProcessAfterCode);
+    reader.read(library.mMarkupExtensions);
+    reader.read(library.mKeywords);
+    reader.read(library.mExecutableBlocks);
+    reader.read(library.mExporters);
+    reader.read(library.mImporters);
+    reader.read(library.mReflection);
+    reader.read(library.mPodTypes);
+    reader.read(library.mPlatformTypes);
+    reader.read(library.mPlatforms);
+    reader.read(library.mTypeChecks);
+    reader.read(library.mNonOverlappingData);
+    if (reader.failed() || !reader.atEnd())
+        return false;
+
+    library.buildIndexes();
+    *this = std::move(library);
+    return true;
+}
+
 Library::Container::Yield Library::Container::yieldFrom(const std::string& yieldName)
 {
     if (yieldName == "at_index")
@@ -637,6 +1336,7 @@ Library::Error Library::load(const tinyxml2::XMLDocument &doc)
         else
             unknown_elements.insert(nodename);
     }
+    buildIndexes();
     if (!unknown_elements.empty()) {
         std::string str;
         for (std::set<std::string>::const_iterator i = unknown_elements.begin(); i != unknown_elements.end();) {
@@ -649,6 +1349,69 @@ Library::Error Library::load(const tinyxml2::XMLDocument &doc)
     return Error(ErrorCode::OK);
 }
 
+static bool isPlainName(const std::string &str)
+{
+    if (str.empty())
+        return false;
+    for (const char c : str) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_' && c != ':')
+            return false;
+    }
+    return true;
+}
+
+// split a pattern word like "map|unordered_map", returns false if some alternative is not a plain name
+static bool splitAlternatives(const std::string &word, std::vector<std::string> &names)
+{
+    names.clear();
+    std::string::size_type start = 0;
+    for (;;) {
+        const std::string::size_type end = word.find('|', start);
+        names.push_back(word.substr(start, end == std::string::npos ? std::string::npos : end - start));
+        if (!isPlainName(names.back()))
+            return false;
+        if (end == std::string::npos)
+            return true;
+        start = end + 1;
+    }
+}
+
+void Library::buildIndexes()
+{
+    mContainerIndex.clear();
+    mContainerFallback.clear();
+    std::vector<std::string> first, second;
+    for (const std::pair<const std::string, Container> &c : containers) {
+        const std::string &pattern = c.second.startPattern;
+        if (pattern.empty())
+            continue;
+        std::istringstream istr(pattern);
+        std::string word1, word2, word3;
+        istr >> word1 >> word2 >> word3;
+        if (!splitAlternatives(word1, first)) {
+            mContainerFallback.push_back(c.first);
+            continue;
+        }
+        const bool scoped = (word2 == "::" && splitAlternatives(word3, second));
+        for (const std::string &name1 : first) {
+            if (!scoped) {
+                mContainerIndex[name1].push_back(c.first);
+                continue;
+            }
+            for (const std::string &name2 : second)
+                mContainerIndex[name1 + "::" + name2].push_back(c.first);
+        }
+    }
+
+    mMemberFunctionNames.clear();
+    for (const std::pair<const std::string, Function> &f : functions) {
+        const std::string::size_type pos = f.first.rfind("::");
+        if (pos != std::string::npos)
+            mMemberFunctionNames.insert(f.first.substr(pos + 2));
+    }
+    mIndexesBuilt = true;
+}
+
 Library::Error Library::loadFunction(const tinyxml2::XMLElement * const node, const std::string &name, std::set<std::string> &unknown_elements)
 {
     if (name.empty())
@@ -983,13 +1746,24 @@ std::string Library::getFunctionName(const Token *ftok, bool *error) const
         return "";
     }
     if (ftok->isName()) {
+        // no need to look in the base classes if there is no member function with this name
+        if (mIndexesBuilt && mMemberFunctionNames.find(ftok->str()) == mMemberFunctionNames.end())
+            return ftok->str();
+        int callargs = -1;
         for (const Scope *scope = ftok->scope(); scope; scope = scope->nestedIn) {
             if (!scope->isClassOrStruct())
                 continue;
             const std::vector<Type::BaseInfo> &derivedFrom = scope->definedType->derivedFrom;
             for (const Type::BaseInfo & baseInfo : derivedFrom) {
-                const std::string name(baseInfo.name + "::" + ftok->str());
-                if (functions.find(name) != functions.end() && matchArguments(ftok, name))
+                std::string name;
+                name.reserve(baseInfo.name.size() + 2 + ftok->str().size());
+                name.append(baseInfo.name).append("::").append(ftok->str());
+                const std::unordered_map<std::string, Function>::const_iterator it = functions.find(name);
+                if (it == functions.end())
+                    continue;
+                if (callargs < 0)
+                    callargs = numberOfArguments(ftok);
+                if (matchArguments(it->second, callargs))
                     return name;
             }
         }
@@ -1167,29 +1941,64 @@ bool Library::isScopeNoReturn(const Token *end, std::string *unknownFunc) const
     return false;
 }
 
-const Library::Container* Library::detectContainer(const Token* typeStart, bool iterator) const
+bool Library::matchContainer(const Container &container, const Token *typeStart, bool iterator) const
 {
-    for (std::map<std::string, Container>::const_iterator i = containers.begin(); i != containers.end(); ++i) {
-        const Container& container = i->second;
-        if (container.startPattern.empty())
-            continue;
+    if (container.startPattern.empty())
+        return false;
 
-        if (!Token::Match(typeStart, container.startPattern2.c_str()))
-            continue;
+    if (!Token::Match(typeStart, container.startPattern2.c_str()))
+        return false;
 
-        if (!iterator && container.endPattern.empty()) // If endPattern is undefined, it will always match, but itEndPattern has to be defined.
-            return &container;
+    if (!iterator && container.endPattern.empty()) // If endPattern is undefined, it will always match, but itEndPattern has to be defined.
+        return true;
 
-        for (const Token* tok = typeStart; tok && !tok->varId(); tok = tok->next()) {
-            if (tok->link()) {
-                const std::string& endPattern = iterator ? container.itEndPattern : container.endPattern;
-                if (Token::Match(tok->link(), endPattern.c_str()))
-                    return &container;
-                break;
-            }
+    for (const Token* tok = typeStart; tok && !tok->varId(); tok = tok->next()) {
+        if (tok->link()) {
+            const std::string& endPattern = iterator ? container.itEndPattern : container.endPattern;
+            return Token::Match(tok->link(), endPattern.c_str());
         }
     }
-    return nullptr;
+    return false;
+}
+
+const Library::Container* Library::detectContainer(const Token* typeStart, bool iterator) const
+{
+    if (!mIndexesBuilt) {
+        // the library was not loaded, the containers were added directly
+        for (std::map<std::string, Container>::const_iterator i = containers.begin(); i != containers.end(); ++i) {
+            if (matchContainer(i->second, typeStart, iterator))
+                return &i->second;
+        }
+        return nullptr;
+    }
+
+    // Candidates, each list is sorted by container name. Merge them so the
+    // first match in map order is returned like above.
+    static const std::vector<std::string> none;
+    const std::vector<std::string> *lists[3] = { &mContainerFallback, &none, &none };
+    if (typeStart) {
+        std::unordered_map<std::string, std::vector<std::string>>::const_iterator it = mContainerIndex.find(typeStart->str());
+        if (it != mContainerIndex.end())
+            lists[1] = &it->second;
+        if (typeStart->strAt(1) == "::" && typeStart->tokAt(2)) {
+            it = mContainerIndex.find(typeStart->str() + "::" + typeStart->strAt(2));
+            if (it != mContainerIndex.end())
+                lists[2] = &it->second;
+        }
+    }
+    std::size_t pos[3] = { 0, 0, 0 };
+    for (;;) {
+        int best = -1;
+        for (int i = 0; i < 3; ++i) {
+            if (pos[i] < lists[i]->size() && (best < 0 || (*lists[i])[pos[i]] < (*lists[best])[pos[best]]))
+                best = i;
+        }
+        if (best < 0)
+            return nullptr;
+        const std::map<std::string, Container>::const_iterator c = containers.find((*lists[best])[pos[best]++]);
+        if (c != containers.end() && matchContainer(c->second, typeStart, iterator))
+            return &c->second;
+    }
 }
 
 bool Library::isContainerYield(const Token * const cond, Library::Container::Yield y, const std::string& fallback)
@@ -1230,9 +2039,14 @@ bool Library::matchArguments(const Token *ftok, const std::string &functionName)
     const std::unordered_map<std::string, Function>::const_iterator it = functions.find(functionName);
     if (it == functions.cend())
         return (callargs == 0);
+    return matchArguments(it->second, callargs);
+}
+
+bool Library::matchArguments(const Function &function, int callargs)
+{
     int args = 0;
     int firstOptionalArg = -1;
-    for (std::map<int, ArgumentChecks>::const_iterator it2 = it->second.argumentChecks.cbegin(); it2 != it->second.argumentChecks.cend(); ++it2) {
+    for (std::map<int, ArgumentChecks>::const_iterator it2 = function.argumentChecks.cbegin(); it2 != function.argumentChecks.cend(); ++it2) {
         if (it2->first > args)
             args = it2->first;
         if (it2->second.optional && (firstOptionalArg == -1 || firstOptionalArg > it2->first))
@@ -31,6 +31,7 @@
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -71,6 +72,33 @@ public:
     /** this is used for unit tests */
     bool loadxmldata(const char xmldata[], std::size_t len);
 
+    /**
+     * Save the loaded configuration in a binary cache file. The cache
+     * records which configuration files were loaded so it can be
+     * validated by loadCache().
+     * @return true if the cache was written
+     */
+    bool saveCache(const std::string &filename) const;
+
+    /**
+     * Load a cache written by saveCache(). Nothing is loaded if the cache was
+     * written by another cppcheck version, for other configuration files, if
+     * a configuration file is found at another path now or if any of the
+     * configuration files has changed since. The library must be empty.
+     * @param filename cache file
+     * @param exename  the configuration files are looked up like load() does
+     * @param cfgs     configuration files that would be loaded otherwise, in load order
+     * @return true if the library was loaded from the cache
+     */
+    bool loadCache(const std::string &filename, const char exename[], const std::vector<std::string> &cfgs);
+
+    /**
+     * Index the containers and the member functions for the lookups. This is
+     * done by load() and loadCache(), it must be called again when
+     * \ref containers or \ref functions are changed directly.
+     */
+    void buildIndexes();
+
     struct AllocFunc {
         int groupId;
         int arg;
@@ -567,6 +595,12 @@ private:
         void addSuffix(const std::string& suffix) {
             mSuffixes.insert(suffix);
         }
+        const std::set<std::string>& prefixes() const {
+            return mPrefixes;
+        }
+        const std::set<std::string>& suffixes() const {
+            return mSuffixes;
+        }
         bool isPrefix(const std::string& prefix) const {
             return (mPrefixes.find(prefix) != mPrefixes.end());
         }
@@ -606,6 +640,9 @@ private:
         bool isBlock(const std::string& blockName) const {
             return mBlocks.find(blockName) != mBlocks.end();
         }
+        const std::set<std::string>& blocks() const {
+            return mBlocks;
+        }
 
     private:
         std::string mStart;
@@ -616,6 +653,8 @@ private:
     enum class FalseTrueMaybe { False, True, Maybe };
     int mAllocId;
     std::set<std::string> mFiles;
+    /** Configuration files in load order, requested name => absolute path */
+    std::vector<std::pair<std::string, std::string>> mLoadedFiles;
     std::map<std::string, AllocFunc> mAlloc; // allocation functions
     std::map<std::string, AllocFunc> mDealloc; // deallocation functions
     std::map<std::string, AllocFunc> mRealloc; // reallocation functions
@@ -638,6 +677,30 @@ private:
     std::map<std::pair<std::string,std::string>, TypeCheck> mTypeChecks;
     std::unordered_map<std::string, NonOverlappingData> mNonOverlappingData;
 
+    /**
+     * Containers indexed by the leading name(s) of their startPattern, so
+     * detectContainer() only has to match a handful of candidates.
+     * "std :: vector <" is stored as "std::vector", "QString" as "QString".
+     * The names are the keys in \ref containers, in map order.
+     */
+    std::unordered_map<std::string, std::vector<std::string>> mContainerIndex;
+    /** Containers whose startPattern does not start with a plain name */
+    std::vector<std::string> mContainerFallback;
+    /** Unqualified names of library functions that have a scope, "vector::push_back" => "push_back" */
+    std::unordered_set<std::string> mMemberFunctionNames;
+    /** Are the indexes built? Until buildIndexes() is called every container and base class is tried */
+    bool mIndexesBuilt;
+
+    /** binary (de)serialization of the library cache */
+    class CacheWriter;
+    class CacheReader;
+    void writeCacheData(CacheWriter &writer) const;
+    /** Hash of the cached members and their types, a cache with another layout is not loaded */
+    static unsigned long long cacheLayout();
+
+    bool matchContainer(const Container &container, const Token *typeStart, bool iterator) const;
+    static bool matchArguments(const Function &function, int callargs);
+
     const ArgumentChecks * getarg(const Token *ftok, int argnr) const;
 
     std::string getFunctionName(const Token *ftok, bool *error) const;
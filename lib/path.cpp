@@ -27,6 +27,8 @@
 #include <cstdlib>
 #include <fstream>
 
+#include <sys/stat.h>
+
 #ifndef _WIN32
 #include <unistd.h>
 #else
@@ -249,3 +251,19 @@ bool Path::fileExists(const std::string &file)
     std::ifstream f(file.c_str());
     return f.is_open();
 }
+
+bool Path::getFileStatus(const std::string &file, long long &size, long long &mtime)
+{
+#ifdef _WIN32
+    struct _stat64 file_stat;
+    if (_stat64(file.c_str(), &file_stat) != 0)
+        return false;
+#else
+    struct stat file_stat;
+    if (stat(file.c_str(), &file_stat) != 0)
+        return false;
+#endif
+    size = file_stat.st_size;
+    mtime = file_stat.st_mtime;
+    return true;
+}
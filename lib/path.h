@@ -179,6 +179,15 @@ public:
      * @return true if given path is a File
      */
     static bool fileExists(const std::string &file);
+
+    /**
+     * @brief Get the size and the modification time of a file
+     * @param file  the file
+     * @param size  the size in bytes
+     * @param mtime the modification time in seconds
+     * @return false if the file status can't be read
+     */
+    static bool getFileStatus(const std::string &file, long long &size, long long &mtime);
 };
 
 /// @}
@@ -26,12 +26,71 @@
 #include <cstddef>
 
 PathMatch::PathMatch(const std::vector<std::string> &excludedPaths, bool caseSensitive)
-    : mExcludedPaths(excludedPaths), mCaseSensitive(caseSensitive)
+    : mCaseSensitive(caseSensitive)
 {
-    if (!mCaseSensitive)
-        for (std::string& excludedPath : mExcludedPaths)
+    const std::vector<std::string> workingDirectory(1, Path::getCurrentPath());
+    for (std::string excludedPath : excludedPaths) {
+        if (!mCaseSensitive)
             std::transform(excludedPath.begin(), excludedPath.end(), excludedPath.begin(), ::tolower);
-    mWorkingDirectory.push_back(Path::getCurrentPath());
+        mAbsolutePathMasks.insert(excludedPath);
+        mRelativePathMasks.insert(Path::isAbsolute(excludedPath) ? Path::getRelativePath(excludedPath, workingDirectory) : excludedPath);
+    }
+}
+
+void PathMatch::Masks::insert(const std::string &mask)
+{
+    if (endsWith(mask, '/'))
+        directories.insert(mask, false);
+    else
+        files.insert(mask, true);
+}
+
+void PathMatch::Trie::insert(const std::string &mask, bool reversed)
+{
+    std::size_t node = 0;
+    for (std::string::size_type i = 0; i < mask.size(); ++i) {
+        const char c = reversed ? mask[mask.size() - 1 - i] : mask[i];
+        const std::map<char, std::size_t>::const_iterator child = mNodes[node].children.find(c);
+        if (child != mNodes[node].children.end()) {
+            node = child->second;
+        } else {
+            mNodes[node].children[c] = mNodes.size();
+            node = mNodes.size();
+            mNodes.emplace_back();
+        }
+    }
+    mNodes[node].mask = true;
+}
+
+bool PathMatch::Trie::matchPrefix(const std::string &str, std::string::size_type pos) const
+{
+    std::size_t node = 0;
+    while (!mNodes[node].mask) {
+        if (pos >= str.size())
+            return false;
+        const std::map<char, std::size_t>::const_iterator child = mNodes[node].children.find(str[pos]);
+        if (child == mNodes[node].children.end())
+            return false;
+        node = child->second;
+        ++pos;
+    }
+    return true;
+}
+
+bool PathMatch::Trie::matchSuffix(const std::string &str) const
+{
+    std::size_t node = 0;
+    std::string::size_type pos = str.size();
+    while (!mNodes[node].mask) {
+        if (pos == 0)
+            return false;
+        --pos;
+        const std::map<char, std::size_t>::const_iterator child = mNodes[node].children.find(str[pos]);
+        if (child == mNodes[node].children.end())
+            return false;
+        node = child->second;
+    }
+    return true;
 }
 
 bool PathMatch::match(const std::string &path) const
@@ -39,41 +98,34 @@ bool PathMatch::match(const std::string &path) const
     if (path.empty())
         return false;
 
-    for (std::vector<std::string>::const_iterator i = mExcludedPaths.begin(); i != mExcludedPaths.end(); ++i) {
-        const std::string excludedPath((!Path::isAbsolute(path) && Path::isAbsolute(*i)) ? Path::getRelativePath(*i, mWorkingDirectory) : *i);
-
-        std::string findpath = Path::fromNativeSeparators(path);
-        if (!mCaseSensitive)
-            std::transform(findpath.begin(), findpath.end(), findpath.begin(), ::tolower);
+    std::string findpath = Path::fromNativeSeparators(path);
+    if (!mCaseSensitive)
+        std::transform(findpath.begin(), findpath.end(), findpath.begin(), ::tolower);
 
-        // Filtering directory name
-        if (endsWith(excludedPath,'/')) {
-            if (!endsWith(findpath,'/'))
-                findpath = removeFilename(findpath);
+    return match(Path::isAbsolute(path) ? mAbsolutePathMasks : mRelativePathMasks, findpath);
+}
 
-            if (excludedPath.length() > findpath.length())
-                continue;
-            // Match relative paths starting with mask
-            // -isrc matches src/foo.cpp
-            if (findpath.compare(0, excludedPath.size(), excludedPath) == 0)
-                return true;
-            // Match only full directory name in middle or end of the path
-            // -isrc matches myproject/src/ but does not match
-            // myproject/srcfiles/ or myproject/mysrc/
-            if (findpath.find("/" + excludedPath) != std::string::npos)
-                return true;
-        }
-        // Filtering filename
-        else {
-            if (excludedPath.length() > findpath.length())
-                continue;
-            // Check if path ends with mask
-            // -ifoo.cpp matches (./)foo.c, src/foo.cpp and proj/src/foo.cpp
-            // -isrc/file.cpp matches src/foo.cpp and proj/src/foo.cpp
-            if (findpath.compare(findpath.size() - excludedPath.size(), findpath.size(), excludedPath) == 0)
-                return true;
+bool PathMatch::match(const Masks &masks, const std::string &path)
+{
+    // Filtering filename
+    // Check if path ends with mask
+    // -ifoo.cpp matches (./)foo.c, src/foo.cpp and proj/src/foo.cpp
+    // -isrc/file.cpp matches src/foo.cpp and proj/src/foo.cpp
+    if (masks.files.matchSuffix(path))
+        return true;
 
-        }
+    // Filtering directory name
+    const std::string dir = endsWith(path, '/') ? path : removeFilename(path);
+    // Match relative paths starting with mask
+    // -isrc matches src/foo.cpp
+    if (masks.directories.matchPrefix(dir, 0))
+        return true;
+    // Match only full directory name in middle or end of the path
+    // -isrc matches myproject/src/ but does not match
+    // myproject/srcfiles/ or myproject/mysrc/
+    for (std::string::size_type pos = dir.find('/'); pos != std::string::npos; pos = dir.find('/', pos + 1)) {
+        if (masks.directories.matchPrefix(dir, pos + 1))
+            return true;
     }
     return false;
 }
@@ -21,6 +21,8 @@
 
 #include "config.h"
 
+#include <cstddef>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -58,9 +60,47 @@ protected:
     static std::string removeFilename(const std::string &path);
 
 private:
-    std::vector<std::string> mExcludedPaths;
+    /** Masks in a trie, so a path is compared with all masks in one pass */
+    class Trie {
+    public:
+        Trie() : mNodes(1) {}
+
+        void insert(const std::string &mask, bool reversed);
+
+        /** Does a mask match the start of str at position pos? */
+        bool matchPrefix(const std::string &str, std::string::size_type pos) const;
+
+        /** Does a reversed mask match the end of str? */
+        bool matchSuffix(const std::string &str) const;
+
+    private:
+        struct Node {
+            Node() : mask(false) {}
+            /** character => node index */
+            std::map<char, std::size_t> children;
+            /** a mask ends in this node */
+            bool mask;
+        };
+        std::vector<Node> mNodes;
+    };
+
+    /** The masks that a path is matched against */
+    struct Masks {
+        /** directory masks, they end with '/' */
+        Trie directories;
+        /** file masks, they are stored reversed */
+        Trie files;
+
+        void insert(const std::string &mask);
+    };
+
+    static bool match(const Masks &masks, const std::string &path);
+
     bool mCaseSensitive;
-    std::vector<std::string> mWorkingDirectory;
+    /** masks for absolute paths */
+    Masks mAbsolutePathMasks;
+    /** masks for relative paths, absolute masks are relative to the working directory */
+    Masks mRelativePathMasks;
 };
 
 /// @}
@@ -106,6 +106,24 @@ public:
 
     bool loadFiles(const simplecpp::TokenList &rawtokens, std::vector<std::string> &files);
 
+    /**
+     * Directories that are searched for the includes of the loaded files.
+     * A header that is added to one of these directories can change which
+     * file an include resolves to. Call after loadFiles().
+     * @param rawtokens source file tokens
+     * @return directory names, "." for the current directory
+     */
+    std::set<std::string> getIncludeDirectories(const simplecpp::TokenList &rawtokens) const;
+
+    /**
+     * Size, modification time and content hash of the source file and the
+     * loaded headers, taken when they were read. Call after loadFiles().
+     * @param filename  source file name
+     * @param rawtokens source file tokens
+     * @return status of the files that were read
+     */
+    std::map<std::string, simplecpp::FileStatus> getFileStatus(const std::string &filename, const simplecpp::TokenList &rawtokens) const;
+
     void removeComments();
 
     void setPlatformInfo(simplecpp::TokenList *tokens) const;
@@ -142,9 +160,17 @@ public:
      */
     void preprocess(std::istream &srcCodeStream, std::string &processedFile, std::list<std::string> &resultConfigurations, const std::string &filename, const std::list<std::string> &includePaths);
 
-    simplecpp::TokenList preprocess(const simplecpp::TokenList &tokens1, const std::string &cfg, std::vector<std::string> &files, bool throwError = false);
+    /**
+     * Preprocess the code for a configuration
+     * @param tokens1 source file tokens
+     * @param cfg configuration
+     * @param files internal data of simplecpp
+     * @param throwError throw if there is a preprocessor error
+     * @param cache results of included files, shared by the configurations of tokens1
+     */
+    simplecpp::TokenList preprocess(const simplecpp::TokenList &tokens1, const std::string &cfg, std::vector<std::string> &files, bool throwError = false, simplecpp::PreprocessCache *cache = nullptr);
 
-    std::string getcode(const simplecpp::TokenList &tokens1, const std::string &cfg, std::vector<std::string> &files, const bool writeLocations);
+    std::string getcode(const simplecpp::TokenList &tokens1, const std::string &cfg, std::vector<std::string> &files, const bool writeLocations, simplecpp::PreprocessCache *cache = nullptr);
 
     /**
      * Get preprocessed code for a given configuration
@@ -170,13 +196,13 @@ public:
     void validateCfgError(const std::string &file, const unsigned int line, const std::string &cfg, const std::string &macro);
 
     /**
-     * Calculate CRC32 checksum. Using toolinfo, tokens1, filedata.
+     * Calculate 64 bit checksum. Using toolinfo, tokens1, filedata.
      *
      * @param tokens1    Sourcefile tokens
      * @param toolinfo   Arbitrary extra toolinfo
-     * @return CRC32 checksum
+     * @return checksum
      */
-    unsigned int calculateChecksum(const simplecpp::TokenList &tokens1, const std::string &toolinfo) const;
+    unsigned long long calculateChecksum(const simplecpp::TokenList &tokens1, const std::string &toolinfo) const;
 
     void simplifyPragmaAsm(simplecpp::TokenList *tokenList);
 
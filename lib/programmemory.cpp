@@ -14,20 +14,36 @@
 #include <functional>
 #include <memory>
 
+ProgramMemory::ProgramMemory() : mValues(std::make_shared<Map>()) {}
+
+ProgramMemory::ProgramMemory(Map values) : mValues(std::make_shared<Map>(std::move(values))) {}
+
+ProgramMemory::Map& ProgramMemory::edit()
+{
+    if (mValues.use_count() > 1)
+        mValues = std::make_shared<Map>(*mValues);
+    return *mValues;
+}
+
 void ProgramMemory::setValue(nonneg int exprid, const ValueFlow::Value& value)
 {
-    values[exprid] = value;
+    edit()[exprid] = value;
 }
 const ValueFlow::Value* ProgramMemory::getValue(nonneg int exprid, bool impossible) const
 {
-    const ProgramMemory::Map::const_iterator it = values.find(exprid);
-    const bool found = it != values.end() && (impossible || !it->second.isImpossible());
+    const ProgramMemory::Map::const_iterator it = mValues->find(exprid);
+    const bool found = it != mValues->end() && (impossible || !it->second.isImpossible());
     if (found)
         return &it->second;
     else
         return nullptr;
 }
 
+ValueFlow::Value& ProgramMemory::at(nonneg int exprid)
+{
+    return edit().at(exprid);
+}
+
 bool ProgramMemory::getIntValue(nonneg int exprid, MathLib::bigint* result) const
 {
     const ValueFlow::Value* value = getValue(exprid);
@@ -43,7 +59,7 @@ void ProgramMemory::setIntValue(nonneg int exprid, MathLib::bigint value, bool i
     ValueFlow::Value v(value);
     if (impossible)
         v.setImpossible();
-    values[exprid] = v;
+    edit()[exprid] = v;
 }
 
 bool ProgramMemory::getTokValue(nonneg int exprid, const Token** result) const
@@ -87,44 +103,58 @@ void ProgramMemory::setContainerSizeValue(nonneg int exprid, MathLib::bigint val
     v.valueType = ValueFlow::Value::ValueType::CONTAINER_SIZE;
     if (!isEqual)
         v.valueKind = ValueFlow::Value::ValueKind::Impossible;
-    values[exprid] = v;
+    edit()[exprid] = v;
 }
 
 void ProgramMemory::setUnknown(nonneg int exprid)
 {
-    values[exprid].valueType = ValueFlow::Value::ValueType::UNINIT;
+    edit()[exprid].valueType = ValueFlow::Value::ValueType::UNINIT;
 }
 
-bool ProgramMemory::hasValue(nonneg int exprid)
+bool ProgramMemory::hasValue(nonneg int exprid) const
 {
-    return values.find(exprid) != values.end();
+    return mValues->find(exprid) != mValues->end();
 }
 
 void ProgramMemory::swap(ProgramMemory &pm)
 {
-    values.swap(pm.values);
+    mValues.swap(pm.mValues);
 }
 
 void ProgramMemory::clear()
 {
-    values.clear();
+    mValues = std::make_shared<Map>();
 }
 
 bool ProgramMemory::empty() const
 {
-    return values.empty();
+    return mValues->empty();
 }
 
 void ProgramMemory::replace(const ProgramMemory &pm)
 {
-    for (auto&& p : pm.values) {
+    if (pm.empty())
+        return;
+    if (empty()) {
+        mValues = pm.mValues;
+        return;
+    }
+    Map& values = edit();
+    for (auto&& p : *pm.mValues) {
         values[p.first] = p.second;
     }
 }
 
 void ProgramMemory::insert(const ProgramMemory &pm)
 {
-    for (auto&& p:pm.values)
+    if (pm.empty())
+        return;
+    if (empty()) {
+        mValues = pm.mValues;
+        return;
+    }
+    Map& values = edit();
+    for (auto&& p : *pm.mValues)
         values.insert(p);
 }
 
@@ -313,13 +343,9 @@ static void fillProgramMemoryFromAssignments(ProgramMemory& pm, const Token* tok
 
 static void removeModifiedVars(ProgramMemory& pm, const Token* tok, const Token* origin)
 {
-    for (auto i = pm.values.begin(), last = pm.values.end(); i != last;) {
-        if (isVariableChanged(origin, tok, i->first, false, nullptr, true)) {
-            i = pm.values.erase(i);
-        } else {
-            ++i;
-        }
-    }
+    pm.eraseIf([&](const std::pair<const nonneg int, ValueFlow::Value>& p) {
+        return isVariableChanged(origin, tok, p.first, false, nullptr, true);
+    });
 }
 
 static ProgramMemory getInitialProgramState(const Token* tok,
@@ -338,20 +364,27 @@ static ProgramMemory getInitialProgramState(const Token* tok,
 
 ProgramMemoryState::ProgramMemoryState(const Settings* s) : state(), origins(), settings(s) {}
 
+void ProgramMemoryState::invalidate()
+{
+    mCache.reset();
+}
+
 void ProgramMemoryState::insert(const ProgramMemory &pm, const Token* origin)
 {
     if (origin)
-        for (auto&& p:pm.values)
+        for (auto&& p:pm)
             origins.insert(std::make_pair(p.first, origin));
     state.insert(pm);
+    invalidate();
 }
 
 void ProgramMemoryState::replace(const ProgramMemory &pm, const Token* origin)
 {
     if (origin)
-        for (auto&& p:pm.values)
+        for (auto&& p:pm)
             origins[p.first] = origin;
     state.replace(pm);
+    invalidate();
 }
 
 void ProgramMemoryState::addState(const Token* tok, const ProgramMemory::Map& vars)
@@ -386,20 +419,42 @@ void ProgramMemoryState::assume(const Token* tok, bool b, bool isEmpty)
 
 void ProgramMemoryState::removeModifiedVars(const Token* tok)
 {
-    for (auto i = state.values.begin(), last = state.values.end(); i != last;) {
-        const Token* start = origins[i->first];
-        const Token* expr = findExpression(start ? start : tok, i->first);
+    bool changed = false;
+    state.eraseIf([&](const std::pair<const nonneg int, ValueFlow::Value>& p) {
+        const Token* start = origins[p.first];
+        const Token* expr = findExpression(start ? start : tok, p.first);
         if (!expr || isExpressionChanged(expr, start, tok, settings, true)) {
-            origins.erase(i->first);
-            i = state.values.erase(i);
-        } else {
-            ++i;
+            origins.erase(p.first);
+            changed = true;
+            return true;
         }
-    }
+        return false;
+    });
+    if (changed)
+        invalidate();
 }
 
+/** results of get() that are kept for one (tok, ctx) pair, the bucket is searched linearly */
+static const std::size_t maxCacheEntriesPerKey = 8;
+/** the cache is cleared when it has this many results */
+static const std::size_t maxCacheEntries = 1024;
+
 ProgramMemory ProgramMemoryState::get(const Token* tok, const Token* ctx, const ProgramMemory::Map& vars) const
 {
+    // The same conditions are evaluated again and again when the forward
+    // analysis walks through nested code, reuse the result if the state is
+    // the same
+    if (!mCache)
+        mCache = std::make_shared<Cache>();
+    const std::pair<const Token*, const Token*> key = std::make_pair(tok, ctx);
+    const auto it = mCache->entries.find(key);
+    if (it != mCache->entries.end()) {
+        for (const CacheEntry& entry : it->second) {
+            if (entry.vars == vars)
+                return entry.result;
+        }
+    }
+
     ProgramMemoryState local = *this;
     if (ctx)
         local.addState(ctx, vars);
@@ -413,6 +468,18 @@ ProgramMemory ProgramMemoryState::get(const Token* tok, const Token* ctx, const
     } else {
         local.removeModifiedVars(ctx);
     }
+    if (mCache->size >= maxCacheEntries) {
+        mCache->entries.clear();
+        mCache->size = 0;
+    }
+    std::vector<CacheEntry>& entries = mCache->entries[key];
+    if (entries.size() >= maxCacheEntriesPerKey) {
+        // drop the oldest result
+        entries.erase(entries.begin());
+        --mCache->size;
+    }
+    entries.push_back(CacheEntry{vars, local.state});
+    ++mCache->size;
     return local.state;
 }
 
@@ -558,7 +625,7 @@ static ValueFlow::Value execute(const Token* expr, ProgramMemory& pm, const Sett
         if (expr->str() != "=") {
             if (!pm.hasValue(expr->astOperand1()->exprId()))
                 return unknown;
-            ValueFlow::Value& lhs = pm.values.at(expr->astOperand1()->exprId());
+            ValueFlow::Value& lhs = pm.at(expr->astOperand1()->exprId());
             rhs = evaluate(removeAssign(expr->str()), lhs, rhs);
             if (lhs.isIntValue())
                 ValueFlow::Value::visitValue(rhs, std::bind(assign{}, std::ref(lhs.intvalue), std::placeholders::_1));
@@ -568,7 +635,7 @@ static ValueFlow::Value execute(const Token* expr, ProgramMemory& pm, const Sett
                 return unknown;
             return lhs;
         } else {
-            pm.values[expr->astOperand1()->exprId()] = rhs;
+            pm.setValue(expr->astOperand1()->exprId(), rhs);
             return rhs;
         }
     } else if (expr->str() == "&&" && expr->astOperand1() && expr->astOperand2()) {
@@ -591,7 +658,7 @@ static ValueFlow::Value execute(const Token* expr, ProgramMemory& pm, const Sett
     } else if (Token::Match(expr, "++|--") && expr->astOperand1() && expr->astOperand1()->exprId() != 0) {
         if (!pm.hasValue(expr->astOperand1()->exprId()))
             return unknown;
-        ValueFlow::Value& lhs = pm.values.at(expr->astOperand1()->exprId());
+        ValueFlow::Value& lhs = pm.at(expr->astOperand1()->exprId());
         if (!lhs.isIntValue())
             return unknown;
         // overflow
@@ -673,7 +740,7 @@ static ValueFlow::Value execute(const Token* expr, ProgramMemory& pm, const Sett
             return execute(expr->astOperand1(), pm);
     }
     if (expr->exprId() > 0 && pm.hasValue(expr->exprId())) {
-        ValueFlow::Value result = pm.values.at(expr->exprId());
+        ValueFlow::Value result = *pm.getValue(expr->exprId(), true);
         if (result.isImpossible() && result.isIntValue() && result.intvalue == 0 && isUsedAsBool(expr)) {
             result.intvalue = !result.intvalue;
             result.setKnown();
@@ -684,13 +751,13 @@ static ValueFlow::Value execute(const Token* expr, ProgramMemory& pm, const Sett
     if (Token::Match(expr->previous(), ">|%name% {|(")) {
         visitAstNodes(expr->astOperand2(), [&](const Token* child) {
             if (child->exprId() > 0 && pm.hasValue(child->exprId())) {
-                ValueFlow::Value& v = pm.values.at(child->exprId());
+                const ValueFlow::Value& v = *pm.getValue(child->exprId(), true);
                 if (v.valueType == ValueFlow::Value::ValueType::CONTAINER_SIZE) {
                     if (isContainerSizeChanged(child, settings))
-                        v = unknown;
+                        pm.setValue(child->exprId(), unknown);
                 } else if (v.valueType != ValueFlow::Value::ValueType::UNINIT) {
                     if (isVariableChanged(child, v.indirect, settings, true))
-                        v = unknown;
+                        pm.setValue(child->exprId(), unknown);
                 }
             }
             return ChildrenToVisit::op1_and_op2;
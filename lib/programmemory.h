@@ -4,18 +4,32 @@
 #include "mathlib.h"
 #include "utils.h"
 #include "valueflow.h" // needed for alias
+#include <algorithm>
 #include <map>
+#include <memory>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 class Token;
 class Settings;
 
+/**
+ * The values are stored in a map that is shared between copies, it is only
+ * copied when a shared map is modified. That way program memories and the
+ * analyzers that hold them can be copied in O(1) when the forward analysis
+ * forks a branch.
+ */
 struct ProgramMemory {
     using Map = std::unordered_map<nonneg int, ValueFlow::Value>;
-    Map values;
+
+    ProgramMemory();
+    explicit ProgramMemory(Map values);
 
     void setValue(nonneg int exprid, const ValueFlow::Value& value);
     const ValueFlow::Value* getValue(nonneg int exprid, bool impossible = false) const;
+    /** value that is modified in place, the exprid must exist */
+    ValueFlow::Value& at(nonneg int exprid);
 
     bool getIntValue(nonneg int exprid, MathLib::bigint* result) const;
     void setIntValue(nonneg int exprid, MathLib::bigint value, bool impossible = false);
@@ -27,7 +41,7 @@ struct ProgramMemory {
     void setUnknown(nonneg int exprid);
 
     bool getTokValue(nonneg int exprid, const Token** result) const;
-    bool hasValue(nonneg int exprid);
+    bool hasValue(nonneg int exprid) const;
 
     void swap(ProgramMemory &pm);
 
@@ -38,6 +52,33 @@ struct ProgramMemory {
     void replace(const ProgramMemory &pm);
 
     void insert(const ProgramMemory &pm);
+
+    template<class Predicate>
+    void eraseIf(Predicate pred) {
+        std::vector<nonneg int> erased;
+        for (const auto& p : *mValues) {
+            if (pred(p))
+                erased.push_back(p.first);
+        }
+        if (erased.empty())
+            return;
+        Map& values = edit();
+        for (nonneg int exprid : erased)
+            values.erase(exprid);
+    }
+
+    Map::const_iterator begin() const {
+        return mValues->cbegin();
+    }
+    Map::const_iterator end() const {
+        return mValues->cend();
+    }
+
+private:
+    /** the map that can be modified, it is copied first if it is shared */
+    Map& edit();
+
+    std::shared_ptr<Map> mValues;
 };
 
 void programMemoryParseCondition(ProgramMemory& pm, const Token* tok, const Token* endTok, const Settings* settings, bool then);
@@ -59,6 +100,22 @@ struct ProgramMemoryState {
     void removeModifiedVars(const Token* tok);
 
     ProgramMemory get(const Token* tok, const Token* ctx, const ProgramMemory::Map& vars) const;
+
+private:
+    /** the state has changed, the results of get() can't be reused */
+    void invalidate();
+
+    struct CacheEntry {
+        ProgramMemory::Map vars;
+        ProgramMemory result;
+    };
+    struct Cache {
+        std::map<std::pair<const Token*, const Token*>, std::vector<CacheEntry>> entries;
+        /** number of entries in all buckets */
+        std::size_t size = 0;
+    };
+    /** results of get() for the current state, shared with the copies that have the same state */
+    mutable std::shared_ptr<Cache> mCache;
 };
 
 void execute(const Token* expr,
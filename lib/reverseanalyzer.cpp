@@ -11,11 +11,12 @@
 #include <algorithm>
 
 struct ReverseTraversal {
-    ReverseTraversal(const ValuePtr<Analyzer>& analyzer, const Settings* settings)
-        : analyzer(analyzer), settings(settings)
+    ReverseTraversal(const ValuePtr<Analyzer>& analyzer, const Settings* settings, ValueFlowCost* cost)
+        : analyzer(analyzer), settings(settings), cost(cost)
     {}
     ValuePtr<Analyzer> analyzer;
     const Settings* settings;
+    ValueFlowCost* cost;
 
     std::pair<bool, bool> evalCond(const Token* tok) {
         std::vector<MathLib::bigint> result = analyzer->evaluate(tok);
@@ -163,6 +164,8 @@ struct ReverseTraversal {
             if (tok->index() >= i)
                 throw InternalError(tok, "Cyclic reverse analysis.");
             i = tok->index();
+            if (cost && !cost->step(settings))
+                break;
             if (tok == start || (tok->str() == "{" && (tok->scope()->type == Scope::ScopeType::eFunction ||
                                                        tok->scope()->type == Scope::ScopeType::eLambda))) {
                 const Function* f = tok->scope()->function;
@@ -361,12 +364,20 @@ struct ReverseTraversal {
 
 void valueFlowGenericReverse(Token* start, const ValuePtr<Analyzer>& a, const Settings* settings)
 {
-    ReverseTraversal rt{a, settings};
+    ValueFlowCost* cost = ValueFlowCost::get(start);
+    if (cost && cost->bailout)
+        return;
+    ValueFlowCost::Measure measure(cost);
+    ReverseTraversal rt{a, settings, cost};
     rt.traverse(start);
 }
 
 void valueFlowGenericReverse(Token* start, const Token* end, const ValuePtr<Analyzer>& a, const Settings* settings)
 {
-    ReverseTraversal rt{a, settings};
+    ValueFlowCost* cost = ValueFlowCost::get(start);
+    if (cost && cost->bailout)
+        return;
+    ValueFlowCost::Measure measure(cost);
+    ReverseTraversal rt{a, settings, cost};
     rt.traverse(start, end);
 }
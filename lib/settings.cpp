@@ -37,6 +37,7 @@ const char Settings::SafeChecks::XmlExternalVariables[] = "external-variables";
 Settings::Settings()
     : bugHunting(false),
     bugHuntingCheckFunctionMaxTime(60),
+    bugHuntingJobs(1),
     checkAllConfigurations(true),
     checkConfiguration(false),
     checkHeaders(true),
@@ -52,6 +53,7 @@ Settings::Settings()
     debugtemplate(false),
     debugwarnings(false),
     dump(false),
+    dumpFormat(DumpFormat::Xml),
     enforcedLang(None),
     exceptionHandling(false),
     exitCode(0),
@@ -63,6 +65,9 @@ Settings::Settings()
     maxConfigs(12),
     maxCtuDepth(2),
     maxTemplateRecursion(100),
+    maxValueFlowFunctionSteps(0),
+    maxValueFlowFunctionTime(0),
+    maxValueFlowMemory(0),
     preprocessOnly(false),
     quiet(false),
     relativePaths(false),
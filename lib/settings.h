@@ -112,6 +112,10 @@ public:
      * timeout the analysis will just stop. */
     int bugHuntingCheckFunctionMaxTime;
 
+    /** @brief Number of threads that analyze the functions of a file
+        in bug hunting mode (--bug-hunting-jobs=N) */
+    int bugHuntingJobs;
+
     /** Filename for bug hunting report */
     std::string bugHuntingReport;
 
@@ -175,6 +179,13 @@ public:
     bool dump;
     std::string dumpFile;
 
+    enum class DumpFormat {
+        Xml, Binary
+    };
+
+    /** @brief Format of the dump file (--dump-format). Addons always get xml. */
+    DumpFormat dumpFormat;
+
     enum Language {
         None, C, CPP
     };
@@ -241,6 +252,20 @@ public:
     /** @brief max template recursion */
     int maxTemplateRecursion;
 
+    /** @brief Max number of ValueFlow analysis steps per function, after
+        that the analysis of the function is cut off. 0 means no limit
+        (--max-valueflow-function-steps=N) */
+    int maxValueFlowFunctionSteps;
+
+    /** @brief Max time in seconds for the ValueFlow analysis of a function,
+        after that the analysis of the function is cut off. 0 means no limit
+        (--max-valueflow-function-time=N) */
+    int maxValueFlowFunctionTime;
+
+    /** @brief Memory budget in MB for the ValueFlow values of a
+        translation unit, 0 means no limit (--max-valueflow-memory=N) */
+    int maxValueFlowMemory;
+
     /** @brief suppress exitcode */
     Suppressions nofail;
 
@@ -340,6 +365,9 @@ public:
     /** @brief show timing information (--showtime=file|summary|top5) */
     SHOWTIME_MODES showtime;
 
+    /** @brief write the timing information as a Chrome trace json file (--showtime-output=<file>) */
+    std::string showtimeOutput;
+
     /** Struct contains standards settings */
     Standards standards;
 
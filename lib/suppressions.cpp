@@ -27,7 +27,7 @@
 
 #include <algorithm>
 #include <cctype>   // std::isdigit, std::isalnum, etc
-#include <functional> // std::bind, std::placeholders
+#include <iterator>
 
 static bool isAcceptedErrorIdChar(char c)
 {
@@ -217,9 +217,9 @@ std::string Suppressions::addSuppressionLine(const std::string &line)
 std::string Suppressions::addSuppression(const Suppressions::Suppression &suppression)
 {
     // Check if suppression is already in list
-    auto foundSuppression = std::find_if(mSuppressions.begin(), mSuppressions.end(),
-                                         std::bind(&Suppression::isSameParameters, &suppression, std::placeholders::_1));
-    if (foundSuppression != mSuppressions.end()) {
+    updateIndex();
+    Suppression * const foundSuppression = mIndex.findSame(suppression);
+    if (foundSuppression) {
         // Update matched state of existing global suppression
         if (!suppression.isLocal() && suppression.matched)
             foundSuppression->matched = suppression.matched;
@@ -359,30 +359,162 @@ std::string Suppressions::Suppression::getText() const
     return ret;
 }
 
-bool Suppressions::isSuppressed(const Suppressions::ErrorMessage &errmsg)
+static bool hasGlobOrSeparator(const std::string &s)
 {
-    const bool unmatchedSuppression(errmsg.errorId == "unmatchedSuppression");
-    for (Suppression &s : mSuppressions) {
-        if (unmatchedSuppression && s.errorId != errmsg.errorId)
-            continue;
-        if (s.isMatch(errmsg))
-            return true;
+    return s.find_first_of("*?/\\") != std::string::npos;
+}
+
+static bool isIndexedByLocation(const Suppressions::Suppression &suppression)
+{
+    return suppression.isLocal() && suppression.lineNumber != Suppressions::Suppression::NO_LINE;
+}
+
+static bool isIndexedByErrorId(const Suppressions::Suppression &suppression)
+{
+    return !suppression.errorId.empty() && !hasGlobOrSeparator(suppression.errorId);
+}
+
+// matchglob() treats '/' and '\\' as the same character
+static std::string indexFileName(std::string fileName)
+{
+    std::replace(fileName.begin(), fileName.end(), '\\', '/');
+    return fileName;
+}
+
+// The file name characters that matchglob() compares literally
+static std::string indexFilePrefix(const std::string &fileName)
+{
+    return indexFileName(fileName.substr(0, fileName.find_first_of("*?")));
+}
+
+void Suppressions::Index::add(Suppression *suppression, std::size_t order)
+{
+    const IndexEntry entry{suppression, order};
+    if (isIndexedByLocation(*suppression)) {
+        std::unordered_map<int, std::vector<IndexEntry>> &lines = byLocation[indexFileName(suppression->fileName)];
+        lines[suppression->lineNumber].push_back(entry);
+        if (suppression->thisAndNextLine)
+            lines[suppression->lineNumber + 1].push_back(entry);
+        return;
     }
-    return false;
+    FileNode *node = &files;
+    for (const char c : indexFilePrefix(suppression->fileName)) {
+        std::unique_ptr<FileNode> &child = node->children[c];
+        if (!child)
+            child.reset(new FileNode);
+        node = child.get();
+    }
+    if (isIndexedByErrorId(*suppression))
+        node->byErrorId[suppression->errorId].push_back(entry);
+    else
+        node->globs.push_back(entry);
 }
 
-bool Suppressions::isSuppressedLocal(const Suppressions::ErrorMessage &errmsg)
+Suppressions::Suppression *Suppressions::Index::findSame(const Suppression &suppression) const
+{
+    const std::vector<IndexEntry> *entries;
+    if (isIndexedByLocation(suppression)) {
+        const auto file = byLocation.find(indexFileName(suppression.fileName));
+        if (file == byLocation.end())
+            return nullptr;
+        const auto line = file->second.find(suppression.lineNumber);
+        if (line == file->second.end())
+            return nullptr;
+        entries = &line->second;
+    } else {
+        const FileNode *node = &files;
+        for (const char c : indexFilePrefix(suppression.fileName)) {
+            const auto child = node->children.find(c);
+            if (child == node->children.end())
+                return nullptr;
+            node = child->second.get();
+        }
+        if (isIndexedByErrorId(suppression)) {
+            const auto id = node->byErrorId.find(suppression.errorId);
+            if (id == node->byErrorId.end())
+                return nullptr;
+            entries = &id->second;
+        } else {
+            entries = &node->globs;
+        }
+    }
+    for (const IndexEntry &entry : *entries) {
+        if (entry.suppression->isSameParameters(suppression))
+            return entry.suppression;
+    }
+    return nullptr;
+}
+
+void Suppressions::updateIndex()
 {
+    if (mIndex.size == mSuppressions.size())
+        return;
+    for (std::list<Suppression>::iterator it = std::next(mSuppressions.begin(), mIndex.size); it != mSuppressions.end(); ++it) {
+        mIndex.add(&*it, mIndex.size);
+        ++mIndex.size;
+    }
+}
+
+bool Suppressions::isSuppressed(const Suppressions::ErrorMessage &errmsg, bool localOnly)
+{
+    updateIndex();
+
+    // The first matching suppression in mSuppressions is marked as matched
     const bool unmatchedSuppression(errmsg.errorId == "unmatchedSuppression");
-    for (Suppression &s : mSuppressions) {
-        if (!s.isLocal())
-            continue;
-        if (unmatchedSuppression && s.errorId != errmsg.errorId)
-            continue;
-        if (s.isMatch(errmsg))
-            return true;
+    const IndexEntry *first = nullptr;
+    auto findFirst = [&](const std::vector<IndexEntry> &entries) {
+        for (const IndexEntry &entry : entries) {
+            if (first && entry.order > first->order)
+                break;
+            const Suppression &s = *entry.suppression;
+            if (localOnly && !s.isLocal())
+                continue;
+            if (unmatchedSuppression && s.errorId != errmsg.errorId)
+                continue;
+            if (s.isSuppressed(errmsg)) {
+                first = &entry;
+                break;
+            }
+        }
+    };
+
+    const std::string &fileName = errmsg.getFileName();
+    const auto file = mIndex.byLocation.find(fileName);
+    if (file != mIndex.byLocation.end()) {
+        const auto line = file->second.find(errmsg.lineNumber);
+        if (line != file->second.end())
+            findFirst(line->second);
     }
-    return false;
+
+    // only the file name patterns whose literal prefix matches the file name can match
+    const FileNode *node = &mIndex.files;
+    for (std::string::size_type pos = 0;; ++pos) {
+        const auto id = node->byErrorId.find(errmsg.errorId);
+        if (id != node->byErrorId.end())
+            findFirst(id->second);
+        findFirst(node->globs);
+        if (pos >= fileName.size())
+            break;
+        const auto child = node->children.find(fileName[pos]);
+        if (child == node->children.end())
+            break;
+        node = child->second.get();
+    }
+
+    if (!first)
+        return false;
+    first->suppression->matched = true;
+    return true;
+}
+
+bool Suppressions::isSuppressed(const Suppressions::ErrorMessage &errmsg)
+{
+    return isSuppressed(errmsg, false);
+}
+
+bool Suppressions::isSuppressedLocal(const Suppressions::ErrorMessage &errmsg)
+{
+    return isSuppressed(errmsg, true);
 }
 
 void Suppressions::dump(std::ostream & out) const
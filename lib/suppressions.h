@@ -23,9 +23,13 @@
 #include "config.h"
 #include "errortypes.h"
 
+#include <cstddef>
 #include <istream>
 #include <list>
+#include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 /// @addtogroup Core
@@ -204,8 +208,66 @@ public:
     const std::list<Suppression> &getSuppressions() const;
 
 private:
+    /** Suppression and its position in mSuppressions */
+    struct IndexEntry {
+        Suppression *suppression;
+        std::size_t order;
+    };
+
+    /** Suppressions whose file name patterns start with the same characters */
+    struct FileNode {
+        /** error id => suppressions */
+        std::unordered_map<std::string, std::vector<IndexEntry>> byErrorId;
+        /** suppressions with an empty or glob error id */
+        std::vector<IndexEntry> globs;
+        /** next character of the file name => node */
+        std::map<char, std::unique_ptr<FileNode>> children;
+    };
+
+    /**
+     * Index of the suppressions, an error message is only compared with the
+     * suppressions that can match it. Suppressions for a line are looked up
+     * by file name and line number. The other suppressions are stored in a
+     * trie of the file name pattern characters before the first wildcard,
+     * and by error id. The index is updated when it is used, a copy is empty.
+     */
+    struct Index {
+        Index() : size(0) {}
+        Index(const Index & /*other*/) : size(0) {}
+        Index &operator=(const Index & /*other*/) {
+            clear();
+            return *this;
+        }
+
+        void clear() {
+            byLocation.clear();
+            files = FileNode();
+            size = 0;
+        }
+
+        void add(Suppression *suppression, std::size_t order);
+
+        /** Find a suppression with the same parameters */
+        Suppression *findSame(const Suppression &suppression) const;
+
+        /** file name => line number => suppressions */
+        std::unordered_map<std::string, std::unordered_map<int, std::vector<IndexEntry>>> byLocation;
+        /** the other suppressions */
+        FileNode files;
+        /** number of suppressions in the index */
+        std::size_t size;
+    };
+
+    /** Add the new suppressions to the index */
+    void updateIndex();
+
+    /** Find the first suppression that matches, it is marked as matched */
+    bool isSuppressed(const ErrorMessage &errmsg, bool localOnly);
+
     /** @brief List of error which the user doesn't want to see. */
     std::list<Suppression> mSuppressions;
+
+    Index mIndex;
 };
 
 /// @}
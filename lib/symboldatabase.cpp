@@ -20,6 +20,7 @@
 #include "symboldatabase.h"
 
 #include "astutils.h"
+#include "binarydump.h"
 #include "errorlogger.h"
 #include "library.h"
 #include "mathlib.h"
@@ -33,6 +34,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <cstring>
 #include <iomanip>
 #include <iostream>
@@ -3710,6 +3712,27 @@ void SymbolDatabase::printOut(const char *title) const
     std::cout << std::resetiosflags(std::ios::boolalpha);
 }
 
+static const char *functionTypeToString(Function::Type type)
+{
+    switch (type) {
+    case Function::eConstructor:
+        return "Constructor";
+    case Function::eCopyConstructor:
+        return "CopyConstructor";
+    case Function::eMoveConstructor:
+        return "MoveConstructor";
+    case Function::eOperatorEqual:
+        return "OperatorEqual";
+    case Function::eDestructor:
+        return "Destructor";
+    case Function::eFunction:
+        return "Function";
+    case Function::eLambda:
+        return "Lambda";
+    }
+    return "Unknown";
+}
+
 void SymbolDatabase::printXml(std::ostream &out) const
 {
     out << std::setiosflags(std::ios::boolalpha);
@@ -3732,6 +3755,12 @@ void SymbolDatabase::printXml(std::ostream &out) const
             out << " nestedIn=\"" << scope->nestedIn << "\"";
         if (scope->function)
             out << " function=\"" << scope->function << "\"";
+        if (scope->valueFlowCost.steps > 0) {
+            out << " valueflowSteps=\"" << scope->valueFlowCost.steps << "\"";
+            out << " valueflowTimeMs=\"" << static_cast<long long>(scope->valueFlowCost.seconds * 1000) << "\"";
+            if (scope->valueFlowCost.bailout)
+                out << " valueflowBailout=\"true\"";
+        }
         if (scope->functionList.empty() && scope->varlist.empty())
             out << "/>" << std::endl;
         else {
@@ -3743,14 +3772,7 @@ void SymbolDatabase::printXml(std::ostream &out) const
                         << "\" token=\"" << function->token
                         << "\" tokenDef=\"" << function->tokenDef
                         << "\" name=\"" << ErrorLogger::toxml(function->name()) << '\"';
-                    out << " type=\"" << (function->type == Function::eConstructor? "Constructor" :
-                                          function->type == Function::eCopyConstructor ? "CopyConstructor" :
-                                          function->type == Function::eMoveConstructor ? "MoveConstructor" :
-                                          function->type == Function::eOperatorEqual ? "OperatorEqual" :
-                                          function->type == Function::eDestructor ? "Destructor" :
-                                          function->type == Function::eFunction ? "Function" :
-                                          function->type == Function::eLambda ? "Lambda" :
-                                          "Unknown") << '\"';
+                    out << " type=\"" << functionTypeToString(function->type) << '\"';
                     if (function->nestedIn->definedType) {
                         if (function->hasVirtualSpecifier())
                             out << " hasVirtualSpecifier=\"true\"";
@@ -3815,6 +3837,95 @@ void SymbolDatabase::printXml(std::ostream &out) const
     out << std::resetiosflags(std::ios::boolalpha);
 }
 
+static std::uint64_t dumpId(const void *p)
+{
+    return reinterpret_cast<std::uintptr_t>(p);
+}
+
+void SymbolDatabase::printBinary(BinaryDump::Writer &writer) const
+{
+    // Same data as printXml()
+    std::set<const Variable *> variables;
+
+    for (const Scope &scope : scopeList) {
+        BinaryDump::Scope dscope;
+        dscope.id = dumpId(&scope);
+        dscope.type = scope.type;
+        dscope.className = scope.className;
+        dscope.bodyStart = dumpId(scope.bodyStart);
+        dscope.bodyEnd = dumpId(scope.bodyEnd);
+        dscope.nestedIn = dumpId(scope.nestedIn);
+        dscope.function = dumpId(scope.function);
+        if (scope.valueFlowCost.steps > 0) {
+            dscope.valueflowSteps = scope.valueFlowCost.steps;
+            dscope.valueflowTimeMs = static_cast<std::uint64_t>(scope.valueFlowCost.seconds * 1000);
+            dscope.valueflowBailout = scope.valueFlowCost.bailout;
+        }
+        for (const Function &function : scope.functionList) {
+            BinaryDump::Function dfunction;
+            dfunction.id = dumpId(&function);
+            dfunction.token = dumpId(function.token);
+            dfunction.tokenDef = dumpId(function.tokenDef);
+            dfunction.name = function.name();
+            dfunction.type = functionTypeToString(function.type);
+            if (function.nestedIn->definedType) {
+                if (function.hasVirtualSpecifier())
+                    dfunction.flags |= BinaryDump::Function::fHasVirtualSpecifier;
+                else if (function.isImplicitlyVirtual())
+                    dfunction.flags |= BinaryDump::Function::fIsImplicitlyVirtual;
+            }
+            if (function.isInlineKeyword())
+                dfunction.flags |= BinaryDump::Function::fIsInlineKeyword;
+            if (function.isStatic())
+                dfunction.flags |= BinaryDump::Function::fIsStatic;
+            for (unsigned int argnr = 0; argnr < function.argCount(); ++argnr) {
+                const Variable *arg = function.getArgumentVar(argnr);
+                dfunction.args.push_back(dumpId(arg));
+                variables.insert(arg);
+            }
+            dscope.functions.push_back(std::move(dfunction));
+        }
+        for (const Variable &var : scope.varlist)
+            dscope.varlist.push_back(dumpId(&var));
+        writer.scope(dscope);
+    }
+
+    for (const Variable *var : mVariableList)
+        variables.insert(var);
+    for (const Variable *var : variables) {
+        if (!var)
+            continue;
+        BinaryDump::Variable dvar;
+        dvar.id = dumpId(var);
+        dvar.nameToken = dumpId(var->nameToken());
+        dvar.typeStartToken = dumpId(var->typeStartToken());
+        dvar.typeEndToken = dumpId(var->typeEndToken());
+        dvar.access = accessControlToString(var->mAccess);
+        dvar.scope = dumpId(var->scope());
+        if (var->valueType()) {
+            dvar.constness = var->valueType()->constness;
+            dvar.flags |= BinaryDump::Variable::fHasConstness;
+        }
+        if (var->isArray())
+            dvar.flags |= BinaryDump::Variable::fIsArray;
+        if (var->isClass())
+            dvar.flags |= BinaryDump::Variable::fIsClass;
+        if (var->isConst())
+            dvar.flags |= BinaryDump::Variable::fIsConst;
+        if (var->isExtern())
+            dvar.flags |= BinaryDump::Variable::fIsExtern;
+        if (var->isPointer())
+            dvar.flags |= BinaryDump::Variable::fIsPointer;
+        if (var->isReference())
+            dvar.flags |= BinaryDump::Variable::fIsReference;
+        if (var->isStatic())
+            dvar.flags |= BinaryDump::Variable::fIsStatic;
+        if (var->isVolatile())
+            dvar.flags |= BinaryDump::Variable::fIsVolatile;
+        writer.variable(dvar);
+    }
+}
+
 //---------------------------------------------------------------------------
 
 static const Type* findVariableTypeIncludingUsedNamespaces(const SymbolDatabase* symbolDatabase, const Scope* scope, const Token* typeTok)
@@ -4094,6 +4205,50 @@ const Variable* Function::getArgumentVar(nonneg int num) const
 
 //---------------------------------------------------------------------------
 
+ValueFlowCost *ValueFlowCost::get(const Token *tok)
+{
+    if (!tok)
+        return nullptr;
+    for (const Scope *scope = tok->scope(); scope; scope = scope->nestedIn) {
+        if (scope->type == Scope::eFunction)
+            return &scope->valueFlowCost;
+    }
+    return nullptr;
+}
+
+ValueFlowCost::Measure::Measure(ValueFlowCost *cost) : mCost(cost)
+{
+    if (mCost && mCost->mDepth++ == 0)
+        mCost->mStart = std::chrono::steady_clock::now();
+}
+
+ValueFlowCost::Measure::~Measure()
+{
+    if (mCost && --mCost->mDepth == 0)
+        mCost->seconds += mCost->elapsed();
+}
+
+double ValueFlowCost::elapsed() const
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - mStart).count();
+}
+
+bool ValueFlowCost::step(const Settings *settings)
+{
+    if (bailout)
+        return false;
+    ++steps;
+    if (!settings)
+        return true;
+    if (settings->maxValueFlowFunctionSteps > 0 && steps > static_cast<std::size_t>(settings->maxValueFlowFunctionSteps))
+        bailout = true;
+    // Reading the clock is not free, only check the time now and then
+    else if (settings->maxValueFlowFunctionTime > 0 && mDepth > 0 && (steps % 1024) == 0 &&
+             seconds + elapsed() > settings->maxValueFlowFunctionTime)
+        bailout = true;
+    return !bailout;
+}
+
 Scope::Scope(const SymbolDatabase *check_, const Token *classDef_, const Scope *nestedIn_, ScopeType type_, const Token *start_) :
     check(check_),
     classDef(classDef_),
@@ -28,6 +28,8 @@
 #include "utils.h"
 
 #include <cctype>
+#include <chrono>
+#include <cstddef>
 #include <list>
 #include <map>
 #include <set>
@@ -38,6 +40,9 @@
 namespace cppcheck {
     class Platform;
 }
+namespace BinaryDump {
+    class Writer;
+}
 
 class ErrorLogger;
 class Function;
@@ -1007,6 +1012,47 @@ private:
     const Token *setFlags(const Token *tok1, const Scope *scope);
 };
 
+/**
+ * @brief Cost of the ValueFlow analysis of a function.
+ *
+ * The forward and reverse analyzers count a step for every token they
+ * analyze and measure the time they spend in the function. When one of
+ * the limits in the settings is exceeded the function is marked and its
+ * analysis is cut off.
+ */
+class CPPCHECKLIB ValueFlowCost {
+public:
+    ValueFlowCost() : steps(0), seconds(0), bailout(false), mDepth(0) {}
+
+    /** @brief cost of the function that the token belongs to, nullptr if it is not in a function */
+    static ValueFlowCost *get(const Token *tok);
+
+    /** @brief Measure the time of an analysis. Nested analyses of the same function are measured once. */
+    class Measure {
+    public:
+        explicit Measure(ValueFlowCost *cost);
+        ~Measure();
+    private:
+        ValueFlowCost *mCost;
+    };
+
+    /**
+     * @brief Count an analysis step
+     * @return false if the analysis of the function should be cut off
+     */
+    bool step(const Settings *settings);
+
+    std::size_t steps;
+    double seconds;
+    bool bailout;
+
+private:
+    double elapsed() const;
+
+    int mDepth;
+    std::chrono::steady_clock::time_point mStart;
+};
+
 class CPPCHECKLIB Scope {
     // let tests access private function for testing
     friend class TestSymbolDatabase;
@@ -1050,6 +1096,9 @@ public:
 
     std::vector<Enumerator> enumeratorList;
 
+    /** ValueFlow analysis cost, only used for function scopes */
+    mutable ValueFlowCost valueFlowCost;
+
     void setBodyStartEnd(const Token *start) {
         bodyStart = start;
         bodyEnd = start ? start->link() : nullptr;
@@ -1408,6 +1457,7 @@ public:
     void printOut(const char * title = nullptr) const;
     void printVariable(const Variable *var, const char *indent) const;
     void printXml(std::ostream &out) const;
+    void printBinary(BinaryDump::Writer &writer) const;
 
     bool isCPP() const;
 
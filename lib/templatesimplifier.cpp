@@ -2454,13 +2454,13 @@ void TemplateSimplifier::simplifyTemplateArgs(Token *start, Token *end)
                     tok = tok->linkAt(1);
                 }
             } else if (Token::Match(tok, "%num% %comp% %num%") &&
-                       MathLib::isInt(tok->str()) &&
-                       MathLib::isInt(tok->strAt(2))) {
+                       tok->isIntNumber() &&
+                       tok->tokAt(2)->isIntNumber()) {
                 if ((Token::Match(tok->previous(), "(|&&|%oror%|,") || tok == start) &&
                     (Token::Match(tok->tokAt(3), ")|&&|%oror%|?") || tok->tokAt(3) == end)) {
-                    const MathLib::bigint op1(MathLib::toLongNumber(tok->str()));
+                    const MathLib::bigint op1(tok->intNumber());
                     const std::string &cmp(tok->next()->str());
-                    const MathLib::bigint op2(MathLib::toLongNumber(tok->strAt(2)));
+                    const MathLib::bigint op2(tok->tokAt(2)->intNumber());
 
                     std::string result;
 
@@ -2648,7 +2648,7 @@ bool TemplateSimplifier::simplifyCalculations(Token* frontToken, Token *backToke
             tok->deleteThis();
             if (tok->isBoolean())
                 tok->str("bool");
-            else if (MathLib::isFloat(tok->str())) {
+            else if (tok->isFloatNumber()) {
                 // MathLib::getSuffix doesn't work for floating point numbers
                 char suffix = tok->str().back();
                 if (suffix == 'f' || suffix == 'F')
@@ -2658,7 +2658,7 @@ bool TemplateSimplifier::simplifyCalculations(Token* frontToken, Token *backToke
                     tok->isLong(true);
                 } else
                     tok->str("double");
-            } else if (MathLib::isInt(tok->str())) {
+            } else if (tok->isIntNumber()) {
                 std::string suffix = MathLib::getSuffix(tok->str());
                 if (suffix.find("LL") != std::string::npos) {
                     tok->str("long");
@@ -2820,14 +2820,14 @@ bool TemplateSimplifier::simplifyCalculations(Token* frontToken, Token *backToke
 
             if (validTokenEnd(bounded, tok, backToken, 2) &&
                 Token::Match(tok, "%num% %comp% %num%") &&
-                MathLib::isInt(tok->str()) &&
-                MathLib::isInt(tok->strAt(2))) {
+                tok->isIntNumber() &&
+                tok->tokAt(2)->isIntNumber()) {
                 if (validTokenStart(bounded, tok, frontToken, -1) &&
                     Token::Match(tok->previous(), "(|&&|%oror%") &&
                     Token::Match(tok->tokAt(3), ")|&&|%oror%|?")) {
-                    const MathLib::bigint op1(MathLib::toLongNumber(tok->str()));
+                    const MathLib::bigint op1(tok->intNumber());
                     const std::string &cmp(tok->next()->str());
-                    const MathLib::bigint op2(MathLib::toLongNumber(tok->strAt(2)));
+                    const MathLib::bigint op2(tok->tokAt(2)->intNumber());
 
                     std::string result;
 
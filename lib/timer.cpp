@@ -19,16 +19,25 @@
 #include "timer.h"
 
 #include <algorithm>
+#include <chrono>
+#include <functional>
 #include <iostream>
+#include <sstream>
+#include <thread>
 #include <utility>
 #include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
 /*
     TODO:
     - rename "file" to "single"
-    - synchronise map access in multithreaded mode or disable timing
     - add unit tests
         - for --showtime (needs input file)
-        - for Timer* classes
  */
 
 namespace {
@@ -37,6 +46,61 @@ namespace {
     {
         return lhs.second.seconds() > rhs.second.seconds();
     }
+
+    std::int64_t wallTime()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /** peak resident set size in kB, 0 if it is unknown */
+    long peakRss()
+    {
+#ifdef _WIN32
+        return 0;
+#else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+            return 0;
+#ifdef __APPLE__
+        return usage.ru_maxrss / 1024;
+#else
+        return usage.ru_maxrss;
+#endif
+#endif
+    }
+
+    long processId()
+    {
+#ifdef _WIN32
+        return _getpid();
+#else
+        return getpid();
+#endif
+    }
+
+    void writeJsonString(std::ostream &out, const std::string &str)
+    {
+        out << '\"';
+        for (const char c : str) {
+            if (c == '\"' || c == '\\')
+                out << '\\';
+            out << c;
+        }
+        out << '\"';
+    }
+
+    void writeData(std::ostream &out, const TimerResultsData &data)
+    {
+        out << data.mClocks << '\t' << data.mWallTime << '\t' << data.mPeakRss << '\t' << data.mNumberOfResults;
+    }
+
+    bool readData(std::istream &in, TimerResultsData &data)
+    {
+        long clocks = 0;
+        in >> clocks >> data.mWallTime >> data.mPeakRss >> data.mNumberOfResults;
+        data.mClocks = clocks;
+        return !in.fail();
+    }
 }
 
 void TimerResults::showResults(SHOWTIME_MODES mode) const
@@ -44,6 +108,8 @@ void TimerResults::showResults(SHOWTIME_MODES mode) const
     if (mode == SHOWTIME_MODES::SHOWTIME_NONE)
         return;
 
+    std::lock_guard<std::mutex> lock(mMutex);
+
     std::cout << std::endl;
     TimerResultsData overallData;
 
@@ -56,30 +122,160 @@ void TimerResults::showResults(SHOWTIME_MODES mode) const
         const double secAverage = sec / (double)(iter->second.mNumberOfResults);
         overallData.mClocks += iter->second.mClocks;
         if ((mode != SHOWTIME_MODES::SHOWTIME_TOP5) || (ordinal<=5)) {
-            std::cout << iter->first << ": " << sec << "s (avg. " << secAverage << "s - " << iter->second.mNumberOfResults  << " result(s))" << std::endl;
+            std::cout << iter->first << ": " << sec << "s (avg. " << secAverage << "s - " << iter->second.mNumberOfResults  << " result(s))"
+                      << " wall: " << iter->second.wallSeconds() << "s rss: +" << iter->second.mPeakRss << "kB" << std::endl;
         }
         ++ordinal;
     }
 
     const double secOverall = overallData.seconds();
     std::cout << "Overall time: " << secOverall << "s" << std::endl;
+
+    for (const std::pair<const std::string, std::int64_t> &counter : mCounters)
+        std::cout << counter.first << ": " << counter.second << std::endl;
+}
+
+void TimerResults::addResults(const std::string& str, const TimerResultsData &data, std::int64_t start)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mResults[str].add(data);
+    if (mTrace) {
+        TimerEvent event;
+        event.name = str;
+        event.pid = processId();
+        event.tid = std::hash<std::thread::id>()(std::this_thread::get_id()) & 0x7fffffff;
+        event.start = start;
+        event.data = data;
+        mEvents.push_back(std::move(event));
+    }
+}
+
+void TimerResults::addCounter(const std::string& str, std::int64_t value)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mCounters[str] += value;
+}
+
+void TimerResults::setTrace(bool trace)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mTrace = trace;
+}
+
+void TimerResults::clear()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mResults.clear();
+    mCounters.clear();
+    mEvents.clear();
 }
 
-void TimerResults::addResults(const std::string& str, std::clock_t clocks)
+std::string TimerResults::serialize() const
 {
-    mResults[str].mClocks += clocks;
-    mResults[str].mNumberOfResults++;
+    std::lock_guard<std::mutex> lock(mMutex);
+    std::ostringstream out;
+    for (const std::pair<const std::string, TimerResultsData> &result : mResults) {
+        out << "R\t" << result.first << '\t';
+        writeData(out, result.second);
+        out << '\n';
+    }
+    for (const std::pair<const std::string, std::int64_t> &counter : mCounters)
+        out << "C\t" << counter.first << '\t' << counter.second << '\n';
+    for (const TimerEvent &event : mEvents) {
+        out << "E\t" << event.name << '\t' << event.pid << '\t' << event.tid << '\t' << event.start << '\t';
+        writeData(out, event.data);
+        out << '\n';
+    }
+    return out.str();
+}
+
+bool TimerResults::merge(const std::string &data)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    std::istringstream in(data);
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string type, name;
+        if (!std::getline(fields, type, '\t') || !std::getline(fields, name, '\t'))
+            return false;
+        if (type == "R") {
+            TimerResultsData result;
+            if (!readData(fields, result))
+                return false;
+            mResults[name].add(result);
+        } else if (type == "C") {
+            std::int64_t value = 0;
+            if (!(fields >> value))
+                return false;
+            mCounters[name] += value;
+        } else if (type == "E") {
+            TimerEvent event;
+            event.name = name;
+            fields >> event.pid >> event.tid >> event.start;
+            if (!readData(fields, event.data))
+                return false;
+            mEvents.push_back(std::move(event));
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TimerResults::writeJson(std::ostream &out) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    out << "{\"traceEvents\":[";
+    for (std::vector<TimerEvent>::const_iterator it = mEvents.begin(); it != mEvents.end(); ++it) {
+        if (it != mEvents.begin())
+            out << ',';
+        out << "\n{\"name\":";
+        writeJsonString(out, it->name);
+        out << ",\"cat\":\"cppcheck\",\"ph\":\"X\",\"pid\":" << it->pid << ",\"tid\":" << it->tid
+            << ",\"ts\":" << it->start << ",\"dur\":" << it->data.mWallTime
+            << ",\"args\":{\"cpu\":" << it->data.seconds() << ",\"rss\":" << it->data.mPeakRss << "}}";
+    }
+    out << "],\n\"displayTimeUnit\":\"ms\",\n\"summary\":[";
+    for (std::map<std::string, TimerResultsData>::const_iterator it = mResults.begin(); it != mResults.end(); ++it) {
+        if (it != mResults.begin())
+            out << ',';
+        out << "\n{\"name\":";
+        writeJsonString(out, it->first);
+        out << ",\"calls\":" << it->second.mNumberOfResults
+            << ",\"wall\":" << it->second.wallSeconds()
+            << ",\"cpu\":" << it->second.seconds()
+            << ",\"rss\":" << it->second.mPeakRss << '}';
+    }
+    out << ']';
+    if (!mCounters.empty()) {
+        out << ",\n\"counters\":{";
+        for (std::map<std::string, std::int64_t>::const_iterator it = mCounters.begin(); it != mCounters.end(); ++it) {
+            if (it != mCounters.begin())
+                out << ',';
+            out << '\n';
+            writeJsonString(out, it->first);
+            out << ':' << it->second;
+        }
+        out << '}';
+    }
+    out << "}\n";
 }
 
 Timer::Timer(const std::string& str, SHOWTIME_MODES showtimeMode, TimerResultsIntf* timerResults)
     : mStr(str)
     , mTimerResults(timerResults)
     , mStart(0)
+    , mWallStart(0)
+    , mPeakRssStart(0)
     , mShowTimeMode(showtimeMode)
     , mStopped(false)
 {
-    if (showtimeMode != SHOWTIME_MODES::SHOWTIME_NONE)
+    if (showtimeMode != SHOWTIME_MODES::SHOWTIME_NONE) {
         mStart = std::clock();
+        mWallStart = wallTime();
+        mPeakRssStart = peakRss();
+    }
 }
 
 Timer::~Timer()
@@ -97,10 +293,24 @@ void Timer::stop()
             const double sec = (double)diff / CLOCKS_PER_SEC;
             std::cout << mStr << ": " << sec << "s" << std::endl;
         } else {
-            if (mTimerResults)
-                mTimerResults->addResults(mStr, diff);
+            if (mTimerResults) {
+                TimerResultsData data;
+                data.mClocks = diff;
+                data.mWallTime = wallTime() - mWallStart;
+                data.mPeakRss = peakRss() - mPeakRssStart;
+                data.mNumberOfResults = 1;
+                mTimerResults->addResults(mStr, data, mWallStart);
+            }
         }
     }
 
     mStopped = true;
 }
+
+void Timer::count(const std::string& str, std::int64_t value, SHOWTIME_MODES showtimeMode, TimerResultsIntf* timerResults)
+{
+    if (showtimeMode == SHOWTIME_MODES::SHOWTIME_FILE)
+        std::cout << str << ": " << value << std::endl;
+    else if (showtimeMode != SHOWTIME_MODES::SHOWTIME_NONE && timerResults)
+        timerResults->addCounter(str, value);
+}
@@ -22,9 +22,13 @@
 
 #include "config.h"
 
+#include <cstdint>
 #include <ctime>
+#include <iosfwd>
 #include <map>
+#include <mutex>
 #include <string>
+#include <vector>
 
 enum class SHOWTIME_MODES {
     SHOWTIME_NONE = 0,
@@ -33,36 +37,101 @@ enum class SHOWTIME_MODES {
     SHOWTIME_TOP5
 };
 
-class CPPCHECKLIB TimerResultsIntf {
-public:
-    virtual ~TimerResultsIntf() {}
-
-    virtual void addResults(const std::string& str, std::clock_t clocks) = 0;
-};
-
 struct TimerResultsData {
     std::clock_t mClocks;
+    /** wall clock time in microseconds */
+    std::int64_t mWallTime;
+    /** growth of the peak resident set size in kB */
+    long mPeakRss;
     long mNumberOfResults;
 
     TimerResultsData()
         : mClocks(0)
+        , mWallTime(0)
+        , mPeakRss(0)
         , mNumberOfResults(0) {}
 
     double seconds() const {
         const double ret = (double)((unsigned long)mClocks) / (double)CLOCKS_PER_SEC;
         return ret;
     }
+
+    double wallSeconds() const {
+        return (double)mWallTime / 1000000.0;
+    }
+
+    void add(const TimerResultsData &other) {
+        mClocks += other.mClocks;
+        mWallTime += other.mWallTime;
+        mPeakRss += other.mPeakRss;
+        mNumberOfResults += other.mNumberOfResults;
+    }
+};
+
+class CPPCHECKLIB TimerResultsIntf {
+public:
+    virtual ~TimerResultsIntf() {}
+
+    /**
+     * Add a measurement
+     * @param str   name of the measured phase
+     * @param data  the measurement, mNumberOfResults is 1
+     * @param start wall clock time in microseconds when the phase started
+     */
+    virtual void addResults(const std::string& str, const TimerResultsData &data, std::int64_t start) = 0;
+
+    /**
+     * Add to a counter, for instance the number of times something expensive is done
+     * @param str   name of the counter
+     * @param value the amount to add
+     */
+    virtual void addCounter(const std::string& str, std::int64_t value) = 0;
+};
+
+/** A single measurement, used for the trace output */
+struct TimerEvent {
+    std::string name;
+    long pid;
+    unsigned long tid;
+    std::int64_t start;
+    TimerResultsData data;
 };
 
 class CPPCHECKLIB TimerResults : public TimerResultsIntf {
 public:
-    TimerResults() {}
+    TimerResults() : mTrace(false) {}
 
     void showResults(SHOWTIME_MODES mode) const;
-    void addResults(const std::string& str, std::clock_t clocks) OVERRIDE;
+    void addResults(const std::string& str, const TimerResultsData &data, std::int64_t start) OVERRIDE;
+    void addCounter(const std::string& str, std::int64_t value) OVERRIDE;
+
+    /** Keep the individual measurements for the trace in writeJson() */
+    void setTrace(bool trace);
+
+    void clear();
+
+    /** Serialize the results so they can be merged in another process */
+    std::string serialize() const;
+
+    /**
+     * Merge results that were serialized by another process
+     * @return false if the data is invalid
+     */
+    bool merge(const std::string &data);
+
+    /**
+     * Write the results in the Chrome trace event format. The trace can be
+     * loaded in chrome://tracing or Perfetto. The accumulated results are
+     * written in the "summary" array.
+     */
+    void writeJson(std::ostream &out) const;
 
 private:
+    mutable std::mutex mMutex;
     std::map<std::string, struct TimerResultsData> mResults;
+    std::map<std::string, std::int64_t> mCounters;
+    std::vector<TimerEvent> mEvents;
+    bool mTrace;
 };
 
 class CPPCHECKLIB Timer {
@@ -71,6 +140,9 @@ public:
     ~Timer();
     void stop();
 
+    /** Add to a counter, in SHOWTIME_FILE mode the value is printed right away */
+    static void count(const std::string& str, std::int64_t value, SHOWTIME_MODES showtimeMode, TimerResultsIntf* timerResults);
+
 private:
     Timer(const Timer& other); // disallow copying
     Timer& operator=(const Timer&); // disallow assignments
@@ -78,6 +150,8 @@ private:
     const std::string mStr;
     TimerResultsIntf* mTimerResults;
     std::clock_t mStart;
+    std::int64_t mWallStart;
+    long mPeakRssStart;
     const SHOWTIME_MODES mShowTimeMode;
     bool mStopped;
 };
@@ -19,6 +19,7 @@
 #include "token.h"
 
 #include "astutils.h"
+#include "binarydump.h"
 #include "library.h"
 #include "settings.h"
 #include "symboldatabase.h"
@@ -30,6 +31,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cctype>
+#include <cstdint>
 #include <cstring>
 #include <functional>
 #include <iostream>
@@ -80,6 +82,55 @@ static const std::unordered_set<std::string> controlFlowKeywords = {
     "return"
 };
 
+void Token::parseNumber() const
+{
+    mImpl->mNumberInfo |= TokenImpl::fNumberParsed;
+    if (MathLib::isInt(mStr))
+        mImpl->mNumberInfo |= TokenImpl::fNumberIsInt;
+    if (MathLib::isFloat(mStr))
+        mImpl->mNumberInfo |= TokenImpl::fNumberIsFloat;
+}
+
+bool Token::isIntNumber() const
+{
+    if (mTokType != eNumber)
+        return MathLib::isInt(mStr);
+    if (!(mImpl->mNumberInfo & TokenImpl::fNumberParsed))
+        parseNumber();
+    return mImpl->mNumberInfo & TokenImpl::fNumberIsInt;
+}
+
+bool Token::isFloatNumber() const
+{
+    if (mTokType != eNumber)
+        return MathLib::isFloat(mStr);
+    if (!(mImpl->mNumberInfo & TokenImpl::fNumberParsed))
+        parseNumber();
+    return mImpl->mNumberInfo & TokenImpl::fNumberIsFloat;
+}
+
+MathLib::bigint Token::intNumber() const
+{
+    if (mTokType != eNumber)
+        return MathLib::toLongNumber(mStr);
+    if (!(mImpl->mNumberInfo & TokenImpl::fNumberIntValue)) {
+        mImpl->mNumber.intValue = MathLib::toLongNumber(mStr);
+        mImpl->mNumberInfo = (mImpl->mNumberInfo & ~TokenImpl::fNumberFloatValue) | TokenImpl::fNumberIntValue;
+    }
+    return mImpl->mNumber.intValue;
+}
+
+double Token::floatNumber() const
+{
+    if (mTokType != eNumber)
+        return MathLib::toDoubleNumber(mStr);
+    if (!(mImpl->mNumberInfo & TokenImpl::fNumberFloatValue)) {
+        mImpl->mNumber.floatValue = MathLib::toDoubleNumber(mStr);
+        mImpl->mNumberInfo = (mImpl->mNumberInfo & ~TokenImpl::fNumberIntValue) | TokenImpl::fNumberFloatValue;
+    }
+    return mImpl->mNumber.floatValue;
+}
+
 void Token::update_property_info()
 {
     setFlag(fIsControlFlowKeyword, controlFlowKeywords.find(mStr) != controlFlowKeywords.end());
@@ -196,6 +247,7 @@ void Token::concatStr(std::string const& b)
     if (isCChar() && isStringLiteral(b) && b[0] != '"') {
         mStr.insert(0, b.substr(0, b.find('"')));
     }
+    mImpl->mNumberInfo = 0;
     update_property_info();
 }
 
@@ -1021,14 +1073,14 @@ void Token::function(const Function *f)
         tokType(eName);
 }
 
-Token* Token::insertToken(const std::string& tokenStr, const std::string& originalNameStr, bool prepend)
+Token* Token::insertToken(std::string tokenStr, const std::string& originalNameStr, bool prepend)
 {
     Token *newToken;
     if (mStr.empty())
         newToken = this;
     else
         newToken = new Token(mTokensFrontBack);
-    newToken->str(tokenStr);
+    newToken->str(std::move(tokenStr));
     if (!originalNameStr.empty())
         newToken->originalName(originalNameStr);
 
@@ -1833,6 +1885,75 @@ void Token::printValueFlow(bool xml, std::ostream &out) const
         out << "  </valueflow>" << std::endl;
 }
 
+void Token::printValueFlow(BinaryDump::Writer &writer) const
+{
+    // Same data as the xml <valueflow>
+    BinaryDump::Values dvalues;
+    for (const Token *tok = this; tok; tok = tok->next()) {
+        if (!tok->mImpl->mValues || tok->mImpl->mValues->empty())
+            continue;
+        dvalues.id = reinterpret_cast<std::uintptr_t>(tok->mImpl->mValues);
+        dvalues.values.clear();
+        for (const ValueFlow::Value &value : *tok->mImpl->mValues) {
+            BinaryDump::Value dvalue;
+            switch (value.valueType) {
+            case ValueFlow::Value::ValueType::INT:
+                dvalue.type = BinaryDump::Value::Int;
+                break;
+            case ValueFlow::Value::ValueType::TOK:
+                dvalue.type = BinaryDump::Value::Tok;
+                break;
+            case ValueFlow::Value::ValueType::FLOAT:
+                dvalue.type = BinaryDump::Value::Float;
+                break;
+            case ValueFlow::Value::ValueType::MOVED:
+                dvalue.type = BinaryDump::Value::Moved;
+                dvalue.moveKind = ValueFlow::Value::toString(value.moveKind);
+                break;
+            case ValueFlow::Value::ValueType::UNINIT:
+                dvalue.type = BinaryDump::Value::Uninit;
+                break;
+            case ValueFlow::Value::ValueType::BUFFER_SIZE:
+                dvalue.type = BinaryDump::Value::BufferSize;
+                break;
+            case ValueFlow::Value::ValueType::CONTAINER_SIZE:
+                dvalue.type = BinaryDump::Value::ContainerSize;
+                break;
+            case ValueFlow::Value::ValueType::ITERATOR_START:
+                dvalue.type = BinaryDump::Value::IteratorStart;
+                break;
+            case ValueFlow::Value::ValueType::ITERATOR_END:
+                dvalue.type = BinaryDump::Value::IteratorEnd;
+                break;
+            case ValueFlow::Value::ValueType::LIFETIME:
+                dvalue.type = BinaryDump::Value::Lifetime;
+                dvalue.lifetimeScope = ValueFlow::Value::toString(value.lifetimeScope);
+                dvalue.lifetimeKind = ValueFlow::Value::toString(value.lifetimeKind);
+                break;
+            case ValueFlow::Value::ValueType::SYMBOLIC:
+                dvalue.type = BinaryDump::Value::Symbolic;
+                break;
+            }
+            dvalue.intvalue = value.intvalue;
+            dvalue.tokvalue = reinterpret_cast<std::uintptr_t>(value.tokvalue);
+            dvalue.floatValue = value.floatValue;
+            dvalue.bound = ValueFlow::Value::toString(value.bound);
+            dvalue.conditionLine = value.condition ? value.condition->linenr() : 0;
+            if (value.isKnown())
+                dvalue.kind = BinaryDump::Value::Known;
+            else if (value.isPossible())
+                dvalue.kind = BinaryDump::Value::Possible;
+            else if (value.isImpossible())
+                dvalue.kind = BinaryDump::Value::Impossible;
+            else
+                dvalue.kind = BinaryDump::Value::Inconclusive;
+            dvalue.path = value.path;
+            dvalues.values.push_back(std::move(dvalue));
+        }
+        writer.values(dvalues);
+    }
+}
+
 const ValueFlow::Value * Token::getValueLE(const MathLib::bigint val, const Settings *settings) const
 {
     if (!mImpl->mValues)
@@ -2153,8 +2274,23 @@ static bool sameValueType(const ValueFlow::Value& x, const ValueFlow::Value& y)
     return true;
 }
 
+// Estimated heap memory used by a value in the std::list of a token
+static std::size_t valueMemory(const ValueFlow::Value &value)
+{
+    std::size_t bytes = sizeof(ValueFlow::Value) + 2 * sizeof(void *);
+    for (const ErrorPathItem &item : value.errorPath)
+        bytes += sizeof(ErrorPathItem) + 2 * sizeof(void *) + item.second.capacity();
+    return bytes;
+}
+
 bool Token::addValue(const ValueFlow::Value &value)
 {
+    const TokenList *list = mTokensFrontBack ? mTokensFrontBack->list : nullptr;
+
+    // Possible values are dropped when the ValueFlow memory budget is used up
+    if (list && (value.isPossible() || value.isInconclusive()) && list->isValueFlowMemoryExceeded())
+        return false;
+
     if (value.isKnown() && mImpl->mValues) {
         // Clear all other values of the same type since value is known
         mImpl->mValues->remove_if([&](const ValueFlow::Value& x) {
@@ -2211,12 +2347,16 @@ bool Token::addValue(const ValueFlow::Value &value)
                 mImpl->mValues->push_front(v);
             else
                 mImpl->mValues->push_back(v);
+            if (list)
+                list->addValueFlowMemory(valueMemory(value));
         }
     } else {
         ValueFlow::Value v(value);
         if (v.varId == 0)
             v.varId = mImpl->mVarId;
         mImpl->mValues = new std::list<ValueFlow::Value>(1, v);
+        if (list)
+            list->addValueFlowMemory(sizeof(std::list<ValueFlow::Value>) + valueMemory(value));
     }
 
     removeContradictions(*mImpl->mValues);
@@ -33,6 +33,7 @@
 #include <memory>
 #include <ostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 class Enumerator;
@@ -43,6 +44,9 @@ class Type;
 class ValueType;
 class Variable;
 class TokenList;
+namespace BinaryDump {
+    class Writer;
+}
 
 class ConstTokenRange;
 
@@ -124,6 +128,20 @@ struct TokenImpl {
     /** Bitfield bit count. */
     unsigned char mBits;
 
+    // Number literal parsed by MathLib, cached on first use. Reset when the token string changes.
+    enum NumberInfo : unsigned char {
+        fNumberParsed = (1 << 0), // fNumberIsInt and fNumberIsFloat are set
+        fNumberIsInt = (1 << 1),
+        fNumberIsFloat = (1 << 2),
+        fNumberIntValue = (1 << 3), // mNumber.intValue is set
+        fNumberFloatValue = (1 << 4) // mNumber.floatValue is set
+    };
+    unsigned char mNumberInfo;
+    union {
+        MathLib::bigint intValue;
+        double floatValue;
+    } mNumber;
+
     void setCppcheckAttribute(CppcheckAttributes::Type type, MathLib::bigint value);
     bool getCppcheckAttribute(CppcheckAttributes::Type type, MathLib::bigint *value) const;
 
@@ -148,7 +166,10 @@ struct TokenImpl {
         , mCppcheckAttributes(nullptr)
         , mCpp11init(Cpp11init::UNKNOWN)
         , mBits(0)
-    {}
+        , mNumberInfo(0)
+    {
+        mNumber.intValue = 0;
+    }
 
     ~TokenImpl();
 };
@@ -193,8 +214,9 @@ public:
 
     template<typename T>
     void str(T&& s) {
-        mStr = s;
+        mStr = std::forward<T>(s);
         mImpl->mVarId = 0;
+        mImpl->mNumberInfo = 0;
 
         update_property_info();
     }
@@ -401,6 +423,16 @@ public:
     bool isNumber() const {
         return mTokType == eNumber;
     }
+
+    /**
+     * MathLib::isInt(), MathLib::isFloat(), MathLib::toLongNumber() and
+     * MathLib::toDoubleNumber() of the token string. For number tokens the
+     * literal is only parsed once.
+     */
+    bool isIntNumber() const;
+    bool isFloatNumber() const;
+    MathLib::bigint intNumber() const;
+    double floatNumber() const;
     bool isEnumerator() const {
         return mTokType == eEnumerator;
     }
@@ -810,11 +842,11 @@ public:
      * @param prepend Insert the new token before this token when it's not
      * the first one on the tokens list.
      */
-    Token* insertToken(const std::string& tokenStr, const std::string& originalNameStr = emptyString, bool prepend = false);
+    Token* insertToken(std::string tokenStr, const std::string& originalNameStr = emptyString, bool prepend = false);
 
-    Token* insertTokenBefore(const std::string& tokenStr, const std::string& originalNameStr = emptyString)
+    Token* insertTokenBefore(std::string tokenStr, const std::string& originalNameStr = emptyString)
     {
-        return insertToken(tokenStr, originalNameStr, true);
+        return insertToken(std::move(tokenStr), originalNameStr, true);
     }
 
     Token *previous() const {
@@ -1284,6 +1316,9 @@ private:
         Called after any mStr() modification. */
     void update_property_info();
 
+    /** Classify the number literal for isIntNumber() and isFloatNumber() */
+    void parseNumber() const;
+
     /** Update internal property cache about isStandardType() */
     void update_property_isStandardType();
 
@@ -1388,6 +1423,8 @@ public:
     void printAst(bool verbose, bool xml, const std::vector<std::string> &fileNames, std::ostream &out) const;
 
     void printValueFlow(bool xml, std::ostream &out) const;
+    /** Write the values of this and the following tokens as binary dump records */
+    void printValueFlow(BinaryDump::Writer &writer) const;
 
     void scopeInfo(std::shared_ptr<ScopeInfo2> newScopeInfo);
     std::shared_ptr<ScopeInfo2> scopeInfo() const;
@@ -19,6 +19,7 @@
 //---------------------------------------------------------------------------
 #include "tokenize.h"
 
+#include "binarydump.h"
 #include "check.h"
 #include "errorlogger.h"
 #include "library.h"
@@ -38,9 +39,11 @@
 #include <algorithm>
 #include <cassert>
 #include <cctype>
+#include <cstdint>
 #include <cstring>
 #include <iostream>
 #include <set>
+#include <sstream>
 #include <stack>
 #include <unordered_map>
 #include <utility>
@@ -2778,7 +2781,7 @@ bool Tokenizer::simplifyTokens1(const std::string &configuration)
 
     if (mTimerResults) {
         Timer t("Tokenizer::simplifyTokens1::ValueFlow", mSettings->showtime, mTimerResults);
-        ValueFlow::setValues(&list, mSymbolDatabase, mErrorLogger, mSettings);
+        ValueFlow::setValues(&list, mSymbolDatabase, mErrorLogger, mSettings, mTimerResults);
     } else {
         ValueFlow::setValues(&list, mSymbolDatabase, mErrorLogger, mSettings);
     }
@@ -5413,55 +5416,99 @@ void Tokenizer::printDebugOutput(int simplification) const
     }
 }
 
+static std::uint64_t dumpId(const void *p)
+{
+    return reinterpret_cast<std::uintptr_t>(p);
+}
+
+/** Token type and flags, shared by the xml and the binary dump */
+static BinaryDump::Token::Type dumpTokenType(const Token *tok, const Library &library, unsigned int &flags)
+{
+    BinaryDump::Token::Type type = BinaryDump::Token::Other;
+    flags = 0;
+    if (tok->isName()) {
+        type = BinaryDump::Token::Name;
+        if (tok->isUnsigned())
+            flags |= BinaryDump::Token::fIsUnsigned;
+        else if (tok->isSigned())
+            flags |= BinaryDump::Token::fIsSigned;
+    } else if (tok->isNumber()) {
+        type = BinaryDump::Token::Number;
+        if (tok->isIntNumber())
+            flags |= BinaryDump::Token::fIsInt;
+        if (tok->isFloatNumber())
+            flags |= BinaryDump::Token::fIsFloat;
+    } else if (tok->tokType() == Token::eString)
+        type = BinaryDump::Token::String;
+    else if (tok->tokType() == Token::eChar)
+        type = BinaryDump::Token::Char;
+    else if (tok->isBoolean())
+        type = BinaryDump::Token::Boolean;
+    else if (tok->isOp()) {
+        type = BinaryDump::Token::Op;
+        if (tok->isArithmeticalOp())
+            flags |= BinaryDump::Token::fIsArithmeticalOp;
+        else if (tok->isAssignmentOp())
+            flags |= BinaryDump::Token::fIsAssignmentOp;
+        else if (tok->isComparisonOp())
+            flags |= BinaryDump::Token::fIsComparisonOp;
+        else if (tok->tokType() == Token::eLogicalOp)
+            flags |= BinaryDump::Token::fIsLogicalOp;
+    }
+    if (tok->isExpandedMacro())
+        flags |= BinaryDump::Token::fIsExpandedMacro;
+    if (tok->isSplittedVarDeclComma())
+        flags |= BinaryDump::Token::fIsSplittedVarDeclComma;
+    if (tok->isSplittedVarDeclEq())
+        flags |= BinaryDump::Token::fIsSplittedVarDeclEq;
+    if (tok->isImplicitInt())
+        flags |= BinaryDump::Token::fIsImplicitInt;
+    if (!tok->varId() && tok->scope()->isExecutable() && Token::Match(tok, "%name% (")) {
+        if (library.isnoreturn(tok))
+            flags |= BinaryDump::Token::fNoreturn;
+    }
+    return type;
+}
+
 void Tokenizer::dump(std::ostream &out) const
 {
     // Create a xml data dump.
     // The idea is not that this will be readable for humans. It's a
     // data dump that 3rd party tools could load and get useful info from.
 
+    static const char * const typeNames[] = { nullptr, "name", "number", "string", "char", "boolean", "op" };
+    // xml attributes of the flags, in the order they are written
+    static const std::pair<BinaryDump::Token::Flag, const char *> flagNames[] = {
+        { BinaryDump::Token::fIsUnsigned, "isUnsigned" },
+        { BinaryDump::Token::fIsSigned, "isSigned" },
+        { BinaryDump::Token::fIsInt, "isInt" },
+        { BinaryDump::Token::fIsFloat, "isFloat" },
+        { BinaryDump::Token::fIsArithmeticalOp, "isArithmeticalOp" },
+        { BinaryDump::Token::fIsAssignmentOp, "isAssignmentOp" },
+        { BinaryDump::Token::fIsComparisonOp, "isComparisonOp" },
+        { BinaryDump::Token::fIsLogicalOp, "isLogicalOp" },
+        { BinaryDump::Token::fIsExpandedMacro, "isExpandedMacro" },
+        { BinaryDump::Token::fIsSplittedVarDeclComma, "isSplittedVarDeclComma" },
+        { BinaryDump::Token::fIsSplittedVarDeclEq, "isSplittedVarDeclEq" },
+        { BinaryDump::Token::fIsImplicitInt, "isImplicitInt" }
+    };
+
     // tokens..
     out << "  <tokenlist>" << std::endl;
     for (const Token *tok = list.front(); tok; tok = tok->next()) {
         out << "    <token id=\"" << tok << "\" file=\"" << ErrorLogger::toxml(list.file(tok)) << "\" linenr=\"" << tok->linenr() << "\" column=\"" << tok->column() << "\"";
         out << " str=\"" << ErrorLogger::toxml(tok->str()) << '\"';
         out << " scope=\"" << tok->scope() << '\"';
-        if (tok->isName()) {
-            out << " type=\"name\"";
-            if (tok->isUnsigned())
-                out << " isUnsigned=\"true\"";
-            else if (tok->isSigned())
-                out << " isSigned=\"true\"";
-        } else if (tok->isNumber()) {
-            out << " type=\"number\"";
-            if (MathLib::isInt(tok->str()))
-                out << " isInt=\"true\"";
-            if (MathLib::isFloat(tok->str()))
-                out << " isFloat=\"true\"";
-        } else if (tok->tokType() == Token::eString)
-            out << " type=\"string\" strlen=\"" << Token::getStrLength(tok) << '\"';
-        else if (tok->tokType() == Token::eChar)
-            out << " type=\"char\"";
-        else if (tok->isBoolean())
-            out << " type=\"boolean\"";
-        else if (tok->isOp()) {
-            out << " type=\"op\"";
-            if (tok->isArithmeticalOp())
-                out << " isArithmeticalOp=\"true\"";
-            else if (tok->isAssignmentOp())
-                out << " isAssignmentOp=\"true\"";
-            else if (tok->isComparisonOp())
-                out << " isComparisonOp=\"true\"";
-            else if (tok->tokType() == Token::eLogicalOp)
-                out << " isLogicalOp=\"true\"";
-        }
-        if (tok->isExpandedMacro())
-            out << " isExpandedMacro=\"true\"";
-        if (tok->isSplittedVarDeclComma())
-            out << " isSplittedVarDeclComma=\"true\"";
-        if (tok->isSplittedVarDeclEq())
-            out << " isSplittedVarDeclEq=\"true\"";
-        if (tok->isImplicitInt())
-            out << " isImplicitInt=\"true\"";
+        unsigned int flags;
+        const BinaryDump::Token::Type type = dumpTokenType(tok, mSettings->library, flags);
+        if (type != BinaryDump::Token::Other)
+            out << " type=\"" << typeNames[type] << '\"';
+        if (type == BinaryDump::Token::String)
+            out << " strlen=\"" << Token::getStrLength(tok) << '\"';
+        for (const std::pair<BinaryDump::Token::Flag, const char *> &flag : flagNames) {
+            if (flags & flag.first)
+                out << ' ' << flag.second << "=\"true\"";
+        }
         if (tok->link())
             out << " link=\"" << tok->link() << '\"';
         if (tok->varId() > 0)
@@ -5487,10 +5534,8 @@ void Tokenizer::dump(std::ostream &out) const
             if (!vt.empty())
                 out << ' ' << vt;
         }
-        if (!tok->varId() && tok->scope()->isExecutable() && Token::Match(tok, "%name% (")) {
-            if (mSettings->library.isnoreturn(tok))
-                out << " noreturn=\"true\"";
-        }
+        if (flags & BinaryDump::Token::fNoreturn)
+            out << " noreturn=\"true\"";
 
         out << "/>" << std::endl;
     }
@@ -5515,6 +5560,48 @@ void Tokenizer::dump(std::ostream &out) const
     }
 }
 
+void Tokenizer::dump(BinaryDump::Writer &writer) const
+{
+    // Same data as the xml dump, one record per token
+    BinaryDump::Token dtok;
+    for (const Token *tok = list.front(); tok; tok = tok->next()) {
+        dtok.id = dumpId(tok);
+        dtok.file = list.file(tok);
+        dtok.linenr = tok->linenr();
+        dtok.column = tok->column();
+        dtok.str = tok->str();
+        dtok.scope = dumpId(tok->scope());
+        dtok.type = dumpTokenType(tok, mSettings->library, dtok.flags);
+        dtok.strlen = (dtok.type == BinaryDump::Token::String) ? Token::getStrLength(tok) : 0;
+        dtok.link = dumpId(tok->link());
+        dtok.varId = tok->varId();
+        dtok.variable = dumpId(tok->variable());
+        dtok.function = dumpId(tok->function());
+        dtok.values = tok->values().empty() ? 0 : dumpId(&tok->values());
+        dtok.typeScope = tok->type() ? dumpId(tok->type()->classScope) : 0;
+        dtok.astParent = dumpId(tok->astParent());
+        dtok.astOperand1 = dumpId(tok->astOperand1());
+        dtok.astOperand2 = dumpId(tok->astOperand2());
+        dtok.originalName = tok->originalName();
+        dtok.valueType = tok->valueType() ? tok->valueType()->dump() : emptyString;
+        writer.token(dtok);
+    }
+
+    mSymbolDatabase->printBinary(writer);
+    if (list.front())
+        list.front()->printValueFlow(writer);
+
+    BinaryDump::TypedefInfo info;
+    for (const TypedefInfo &typedefInfo: mTypedefInfo) {
+        info.name = typedefInfo.name;
+        info.file = typedefInfo.filename;
+        info.line = typedefInfo.lineNumber;
+        info.column = typedefInfo.column;
+        info.used = typedefInfo.used;
+        writer.typedefInfo(info);
+    }
+}
+
 void Tokenizer::simplifyHeadersAndUnusedTemplates()
 {
     if (mSettings->checkHeaders && mSettings->checkUnusedTemplates)
@@ -6604,17 +6691,17 @@ bool Tokenizer::simplifyConditions()
                 // Compare numbers
 
                 if (cmp == "==" || cmp == "!=") {
-                    const std::string& op1(tok->next()->str());
-                    const std::string& op2(tok->strAt(3));
+                    const Token *op1 = tok->next();
+                    const Token *op2 = tok->tokAt(3);
 
                     bool eq = false;
-                    if (MathLib::isInt(op1) && MathLib::isInt(op2))
-                        eq = (MathLib::toLongNumber(op1) == MathLib::toLongNumber(op2));
+                    if (op1->isIntNumber() && op2->isIntNumber())
+                        eq = (op1->intNumber() == op2->intNumber());
                     else {
-                        eq = (op1 == op2);
+                        eq = (op1->str() == op2->str());
 
                         // It is inconclusive whether two unequal float representations are numerically equal
-                        if (!eq && MathLib::isFloat(op1))
+                        if (!eq && op1->isFloatNumber())
                             cmp.clear();
                     }
 
@@ -6623,8 +6710,8 @@ bool Tokenizer::simplifyConditions()
                     else
                         result = !eq;
                 } else {
-                    const double op1 = MathLib::toDoubleNumber(tok->next()->str());
-                    const double op2 = MathLib::toDoubleNumber(tok->strAt(3));
+                    const double op1 = tok->next()->floatNumber();
+                    const double op2 = tok->tokAt(3)->floatNumber();
                     if (cmp == ">=")
                         result = (op1 >= op2);
                     else if (cmp == ">")
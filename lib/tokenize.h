@@ -37,6 +37,9 @@ class Token;
 class TemplateSimplifier;
 class ErrorLogger;
 class Preprocessor;
+namespace BinaryDump {
+    class Writer;
+}
 
 namespace simplecpp {
     class TokenList;
@@ -880,6 +883,9 @@ public:
 
     void dump(std::ostream &out) const;
 
+    /** Write the token list in the compact binary dump format */
+    void dump(BinaryDump::Writer &writer) const;
+
     Token *deleteInvalidTypedef(Token *typeDef);
 
     /**
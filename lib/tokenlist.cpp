@@ -33,6 +33,7 @@
 #include <cstring>
 #include <set>
 #include <stack>
+#include <utility>
 
 // How many compileExpression recursions are allowed?
 // For practical code this could be endless. But in some special torture test
@@ -44,7 +45,8 @@ TokenList::TokenList(const Settings* settings) :
     mTokensFrontBack(),
     mSettings(settings),
     mIsC(false),
-    mIsCpp(false)
+    mIsCpp(false),
+    mValueFlowMemory(0)
 {
     mTokensFrontBack.list = this;
     mKeywords.insert("auto");
@@ -98,6 +100,12 @@ const std::string& TokenList::getSourceFilePath() const
     return getFiles()[0];
 }
 
+bool TokenList::isValueFlowMemoryExceeded() const
+{
+    return mSettings && mSettings->maxValueFlowMemory > 0 &&
+           mValueFlowMemory > static_cast<std::size_t>(mSettings->maxValueFlowMemory) * 1024 * 1024;
+}
+
 //---------------------------------------------------------------------------
 
 // Deallocate lists..
@@ -402,20 +410,21 @@ void TokenList::createTokens(simplecpp::TokenList&& tokenList)
 
     determineCppC();
 
-    for (const simplecpp::Token *tok = tokenList.cfront(); tok;) {
+    // The simplecpp tokens are deleted as they are converted so the strings can be moved
+    for (simplecpp::Token *tok = tokenList.front(); tok;) {
 
-        std::string str = tok->str();
+        std::string str = tok->takestr();
 
         // Float literal
         if (str.size() > 1 && str[0] == '.' && std::isdigit(str[1]))
-            str = '0' + str;
+            str.insert(0, 1, '0');
 
         if (mTokensFrontBack.back) {
-            mTokensFrontBack.back->insertToken(str);
+            mTokensFrontBack.back->insertToken(std::move(str));
         } else {
             mTokensFrontBack.front = new Token(&mTokensFrontBack);
             mTokensFrontBack.back = mTokensFrontBack.front;
-            mTokensFrontBack.back->str(str);
+            mTokensFrontBack.back->str(std::move(str));
         }
 
         mTokensFrontBack.back->fileIndex(tok->location.fileIndex);
@@ -24,6 +24,7 @@
 #include "config.h"
 #include "token.h"
 
+#include <cstddef>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -53,6 +54,20 @@ public:
     /** @return the source file path. e.g. "file.cpp" */
     const std::string& getSourceFilePath() const;
 
+    /** Bytes allocated for ValueFlow values since clearValueFlowMemory(), see Token::addValue() */
+    std::size_t valueFlowMemory() const {
+        return mValueFlowMemory;
+    }
+    void addValueFlowMemory(std::size_t bytes) const {
+        mValueFlowMemory += bytes;
+    }
+    void clearValueFlowMemory() const {
+        mValueFlowMemory = 0;
+    }
+
+    /** Is the ValueFlow memory budget (Settings::maxValueFlowMemory) used up? */
+    bool isValueFlowMemoryExceeded() const;
+
     /** Is the code C. Used for bailouts */
     bool isC() const {
         return mIsC;
@@ -217,6 +232,9 @@ private:
     /** File is known to be C/C++ code */
     bool mIsC;
     bool mIsCpp;
+
+    /** ValueFlow memory accounting */
+    mutable std::size_t mValueFlowMemory;
 };
 
 /// @}
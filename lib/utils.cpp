@@ -21,6 +21,7 @@
 #include <utility>
 #include <stack>
 #include <cctype>
+#include <vector>
 
 
 int caseInsensitiveStringCompare(const std::string &lhs, const std::string &rhs)
@@ -53,7 +54,8 @@ bool matchglob(const std::string& pattern, const std::string& name)
 {
     const char* p = pattern.c_str();
     const char* n = name.c_str();
-    std::stack<std::pair<const char*, const char*>> backtrack;
+    // a vector is only allocated when there is something to backtrack
+    std::stack<std::pair<const char*, const char*>, std::vector<std::pair<const char*, const char*>>> backtrack;
 
     for (;;) {
         bool matching = true;
@@ -25,6 +25,7 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <initializer_list>
 #include <string>
 #include <vector>
@@ -146,6 +147,37 @@ inline static const char *getOrdinalText(int i)
     return "th";
 }
 
+/** 64 bit FNV-1a hash that is stable between runs and platforms. The data can be added in pieces. */
+class Hash64 {
+public:
+    Hash64() : mHash(0xcbf29ce484222325ULL) {}
+
+    void add(const char *data, std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i) {
+            mHash ^= static_cast<unsigned char>(data[i]);
+            mHash *= 0x100000001b3ULL;
+        }
+    }
+
+    void add(const std::string &s) {
+        add(s.data(), s.size());
+    }
+
+    void add(std::uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            mHash ^= (value >> (8 * i)) & 0xff;
+            mHash *= 0x100000001b3ULL;
+        }
+    }
+
+    std::uint64_t get() const {
+        return mHash;
+    }
+
+private:
+    std::uint64_t mHash;
+};
+
 CPPCHECKLIB int caseInsensitiveStringCompare(const std::string& lhs, const std::string& rhs);
 
 CPPCHECKLIB bool isValidGlobPattern(const std::string& pattern);
@@ -95,6 +95,7 @@
 #include "settings.h"
 #include "standards.h"
 #include "symboldatabase.h"
+#include "timer.h"
 #include "token.h"
 #include "tokenlist.h"
 #include "utils.h"
@@ -998,19 +999,19 @@ size_t ValueFlow::getSizeOf(const ValueType &vt, const Settings *settings)
 // Handle various constants..
 static Token * valueFlowSetConstantValue(Token *tok, const Settings *settings, bool cpp)
 {
-    if ((tok->isNumber() && MathLib::isInt(tok->str())) || (tok->tokType() == Token::eChar)) {
+    if ((tok->isNumber() && tok->isIntNumber()) || (tok->tokType() == Token::eChar)) {
         try {
-            ValueFlow::Value value(MathLib::toLongNumber(tok->str()));
+            ValueFlow::Value value(tok->intNumber());
             if (!tok->isTemplateArg())
                 value.setKnown();
             setTokenValue(tok, value, settings);
         } catch (const std::exception & /*e*/) {
             // Bad character literal
         }
-    } else if (tok->isNumber() && MathLib::isFloat(tok->str())) {
+    } else if (tok->isNumber() && tok->isFloatNumber()) {
         ValueFlow::Value value;
         value.valueType = ValueFlow::Value::ValueType::FLOAT;
-        value.floatValue = MathLib::toDoubleNumber(tok->str());
+        value.floatValue = tok->floatNumber();
         if (!tok->isTemplateArg())
             value.setKnown();
         setTokenValue(tok, value, settings);
@@ -1360,10 +1361,10 @@ static void valueFlowBitAnd(TokenList *tokenlist)
             continue;
 
         MathLib::bigint number;
-        if (MathLib::isInt(tok->astOperand1()->str()))
-            number = MathLib::toLongNumber(tok->astOperand1()->str());
-        else if (MathLib::isInt(tok->astOperand2()->str()))
-            number = MathLib::toLongNumber(tok->astOperand2()->str());
+        if (tok->astOperand1()->isIntNumber())
+            number = tok->astOperand1()->intNumber();
+        else if (tok->astOperand2()->isIntNumber())
+            number = tok->astOperand2()->intNumber();
         else
             continue;
 
@@ -6071,17 +6072,17 @@ static void valueFlowForLoop(TokenList *tokenlist, SymbolDatabase* symboldatabas
             ProgramMemory mem1, mem2, memAfter;
             if (valueFlowForLoop2(tok, &mem1, &mem2, &memAfter)) {
                 ProgramMemory::Map::const_iterator it;
-                for (it = mem1.values.begin(); it != mem1.values.end(); ++it) {
+                for (it = mem1.begin(); it != mem1.end(); ++it) {
                     if (!it->second.isIntValue())
                         continue;
                     valueFlowForLoopSimplify(bodyStart, it->first, false, it->second.intvalue, tokenlist, errorLogger, settings);
                 }
-                for (it = mem2.values.begin(); it != mem2.values.end(); ++it) {
+                for (it = mem2.begin(); it != mem2.end(); ++it) {
                     if (!it->second.isIntValue())
                         continue;
                     valueFlowForLoopSimplify(bodyStart, it->first, false, it->second.intvalue, tokenlist, errorLogger, settings);
                 }
-                for (it = memAfter.values.begin(); it != memAfter.values.end(); ++it) {
+                for (it = memAfter.begin(); it != memAfter.end(); ++it) {
                     if (!it->second.isIntValue())
                         continue;
                     valueFlowForLoopSimplifyAfter(tok, it->first, it->second.intvalue, tokenlist, settings);
@@ -6234,7 +6235,7 @@ struct MultiValueFlowAnalyzer : ValueFlowAnalyzer {
     }
 
     virtual void forkScope(const Token* endBlock) OVERRIDE {
-        ProgramMemory pm = {getProgramState()};
+        ProgramMemory pm(getProgramState());
         const Scope* scope = endBlock->scope();
         const Token* condTok = getCondTokFromEnd(endBlock);
         if (scope && condTok)
@@ -6245,7 +6246,7 @@ struct MultiValueFlowAnalyzer : ValueFlowAnalyzer {
                 pm.replace(endMemory);
         }
         // ProgramMemory pm = pms.get(endBlock->link()->next(), getProgramState());
-        for (const auto& p:pm.values) {
+        for (const auto& p:pm) {
             nonneg int varid = p.first;
             if (symboldatabase && !symboldatabase->isVarId(varid))
                 continue;
@@ -7892,65 +7893,138 @@ static std::size_t getTotalValues(TokenList *tokenlist)
     return n;
 }
 
-void ValueFlow::setValues(TokenList *tokenlist, SymbolDatabase* symboldatabase, ErrorLogger *errorLogger, const Settings *settings)
+// Has the memory budget been used up? The first time it is the possible values
+// are removed, so the remaining passes can still add the known values.
+static bool valueFlowMemoryExceeded(TokenList *tokenlist, ErrorLogger *errorLogger, const Settings *settings)
+{
+    if (!tokenlist->front() || !tokenlist->isValueFlowMemoryExceeded())
+        return false;
+    for (Token *tok = tokenlist->front(); tok; tok = tok->next()) {
+        tok->removeValues([](const ValueFlow::Value &v) {
+            return v.isPossible() || v.isInconclusive();
+        });
+    }
+    if (settings->debugwarnings)
+        bailout(tokenlist, errorLogger, tokenlist->front(), "ValueFlow memory budget of " + MathLib::toString(settings->maxValueFlowMemory) + " MB is used up, possible values are dropped and expensive passes are skipped");
+    return true;
+}
+
+// Run a valueflow pass, the time is measured for --showtime
+#define VALUEFLOW_PASS(name, pass) \
+    do { \
+        { \
+            Timer timer("ValueFlow::" name, timerResults ? settings->showtime : SHOWTIME_MODES::SHOWTIME_NONE, timerResults); \
+            pass; \
+        } \
+        if (!lowMemory) \
+            lowMemory = valueFlowMemoryExceeded(tokenlist, errorLogger, settings); \
+    } while (false)
+
+static ErrorMessage functionLimitError(const std::list<ErrorMessage::FileLocation> &callstack, const std::string &file, const std::string &function, std::size_t steps)
+{
+    return ErrorMessage(callstack, file, Severity::information,
+                        "ValueFlow analysis of function '" + function + "' is cut off after " +
+                        MathLib::toString(steps) + " steps, the function exceeds the limits set by --max-valueflow-function-steps or --max-valueflow-function-time.",
+                        "valueFlowFunctionLimit", Certainty::normal);
+}
+
+static void valueFlowFunctionLimits(TokenList *tokenlist, const SymbolDatabase *symboldatabase, ErrorLogger *errorLogger, const Settings *settings)
+{
+    if (!errorLogger || !settings->severity.isEnabled(Severity::information))
+        return;
+    for (const Scope *scope : symboldatabase->functionScopes) {
+        if (!scope->valueFlowCost.bailout)
+            continue;
+        const std::list<ErrorMessage::FileLocation> callstack(1, ErrorMessage::FileLocation(scope->classDef, tokenlist));
+        errorLogger->reportErr(functionLimitError(callstack, tokenlist->getSourceFilePath(), scope->className, scope->valueFlowCost.steps));
+    }
+}
+
+void ValueFlow::getErrorMessages(ErrorLogger *errorLogger)
+{
+    errorLogger->reportErr(functionLimitError(std::list<ErrorMessage::FileLocation>(), emptyString, "f", 0));
+}
+
+void ValueFlow::setValues(TokenList *tokenlist, SymbolDatabase* symboldatabase, ErrorLogger *errorLogger, const Settings *settings, TimerResultsIntf *timerResults)
 {
     for (Token *tok = tokenlist->front(); tok; tok = tok->next())
         tok->clearValueFlow();
-
-    valueFlowEnumValue(symboldatabase, settings);
-    valueFlowNumber(tokenlist);
-    valueFlowString(tokenlist);
-    valueFlowArray(tokenlist);
-    valueFlowUnknownFunctionReturn(tokenlist, settings);
-    valueFlowGlobalConstVar(tokenlist, settings);
-    valueFlowEnumValue(symboldatabase, settings);
-    valueFlowNumber(tokenlist);
-    valueFlowGlobalStaticVar(tokenlist, settings);
-    valueFlowPointerAlias(tokenlist);
-    valueFlowLifetime(tokenlist, symboldatabase, errorLogger, settings);
-    valueFlowSymbolic(tokenlist, symboldatabase);
-    valueFlowBitAnd(tokenlist);
-    valueFlowSameExpressions(tokenlist);
-    valueFlowConditionExpressions(tokenlist, symboldatabase, errorLogger, settings);
+    tokenlist->clearValueFlowMemory();
+
+    // When the memory budget is used up the expensive passes are skipped
+    bool lowMemory = false;
+
+    const std::size_t forks = ForwardAnalyzerCounters::get().forks;
+    const ValuePtrCounters clones = ValuePtrCounters::get();
+
+    VALUEFLOW_PASS("valueFlowEnumValue", valueFlowEnumValue(symboldatabase, settings));
+    VALUEFLOW_PASS("valueFlowNumber", valueFlowNumber(tokenlist));
+    VALUEFLOW_PASS("valueFlowString", valueFlowString(tokenlist));
+    VALUEFLOW_PASS("valueFlowArray", valueFlowArray(tokenlist));
+    VALUEFLOW_PASS("valueFlowUnknownFunctionReturn", valueFlowUnknownFunctionReturn(tokenlist, settings));
+    VALUEFLOW_PASS("valueFlowGlobalConstVar", valueFlowGlobalConstVar(tokenlist, settings));
+    VALUEFLOW_PASS("valueFlowEnumValue", valueFlowEnumValue(symboldatabase, settings));
+    VALUEFLOW_PASS("valueFlowNumber", valueFlowNumber(tokenlist));
+    VALUEFLOW_PASS("valueFlowGlobalStaticVar", valueFlowGlobalStaticVar(tokenlist, settings));
+    VALUEFLOW_PASS("valueFlowPointerAlias", valueFlowPointerAlias(tokenlist));
+    VALUEFLOW_PASS("valueFlowLifetime", valueFlowLifetime(tokenlist, symboldatabase, errorLogger, settings));
+    VALUEFLOW_PASS("valueFlowSymbolic", valueFlowSymbolic(tokenlist, symboldatabase));
+    VALUEFLOW_PASS("valueFlowBitAnd", valueFlowBitAnd(tokenlist));
+    VALUEFLOW_PASS("valueFlowSameExpressions", valueFlowSameExpressions(tokenlist));
+    VALUEFLOW_PASS("valueFlowConditionExpressions", valueFlowConditionExpressions(tokenlist, symboldatabase, errorLogger, settings));
 
     std::size_t values = 0;
     std::size_t n = 4;
     while (n > 0 && values < getTotalValues(tokenlist)) {
         values = getTotalValues(tokenlist);
-        valueFlowImpossibleValues(tokenlist, settings);
-        valueFlowSymbolicIdentity(tokenlist);
-        valueFlowSymbolicAbs(tokenlist, symboldatabase);
-        valueFlowCondition(SymbolicConditionHandler{}, tokenlist, symboldatabase, errorLogger, settings);
-        valueFlowSymbolicInfer(tokenlist, symboldatabase);
-        valueFlowArrayBool(tokenlist);
-        valueFlowRightShift(tokenlist, settings);
-        valueFlowAfterAssign(tokenlist, symboldatabase, errorLogger, settings);
-        valueFlowAfterSwap(tokenlist, symboldatabase, errorLogger, settings);
-        valueFlowCondition(SimpleConditionHandler{}, tokenlist, symboldatabase, errorLogger, settings);
-        valueFlowInferCondition(tokenlist, settings);
-        valueFlowSwitchVariable(tokenlist, symboldatabase, errorLogger, settings);
-        valueFlowForLoop(tokenlist, symboldatabase, errorLogger, settings);
-        valueFlowSubFunction(tokenlist, symboldatabase, errorLogger, settings);
-        valueFlowFunctionReturn(tokenlist, errorLogger);
-        valueFlowLifetime(tokenlist, symboldatabase, errorLogger, settings);
-        valueFlowFunctionDefaultParameter(tokenlist, symboldatabase, settings);
-        valueFlowUninit(tokenlist, symboldatabase, settings);
+        VALUEFLOW_PASS("valueFlowImpossibleValues", valueFlowImpossibleValues(tokenlist, settings));
+        VALUEFLOW_PASS("valueFlowSymbolicIdentity", valueFlowSymbolicIdentity(tokenlist));
+        VALUEFLOW_PASS("valueFlowSymbolicAbs", valueFlowSymbolicAbs(tokenlist, symboldatabase));
+        VALUEFLOW_PASS("valueFlowCondition::SymbolicConditionHandler", valueFlowCondition(SymbolicConditionHandler{}, tokenlist, symboldatabase, errorLogger, settings));
+        VALUEFLOW_PASS("valueFlowSymbolicInfer", valueFlowSymbolicInfer(tokenlist, symboldatabase));
+        VALUEFLOW_PASS("valueFlowArrayBool", valueFlowArrayBool(tokenlist));
+        VALUEFLOW_PASS("valueFlowRightShift", valueFlowRightShift(tokenlist, settings));
+        VALUEFLOW_PASS("valueFlowAfterAssign", valueFlowAfterAssign(tokenlist, symboldatabase, errorLogger, settings));
+        VALUEFLOW_PASS("valueFlowAfterSwap", valueFlowAfterSwap(tokenlist, symboldatabase, errorLogger, settings));
+        VALUEFLOW_PASS("valueFlowCondition::SimpleConditionHandler", valueFlowCondition(SimpleConditionHandler{}, tokenlist, symboldatabase, errorLogger, settings));
+        VALUEFLOW_PASS("valueFlowInferCondition", valueFlowInferCondition(tokenlist, settings));
+        VALUEFLOW_PASS("valueFlowSwitchVariable", valueFlowSwitchVariable(tokenlist, symboldatabase, errorLogger, settings));
+        if (!lowMemory)
+            VALUEFLOW_PASS("valueFlowForLoop", valueFlowForLoop(tokenlist, symboldatabase, errorLogger, settings));
+        if (!lowMemory)
+            VALUEFLOW_PASS("valueFlowSubFunction", valueFlowSubFunction(tokenlist, symboldatabase, errorLogger, settings));
+        VALUEFLOW_PASS("valueFlowFunctionReturn", valueFlowFunctionReturn(tokenlist, errorLogger));
+        VALUEFLOW_PASS("valueFlowLifetime", valueFlowLifetime(tokenlist, symboldatabase, errorLogger, settings));
+        VALUEFLOW_PASS("valueFlowFunctionDefaultParameter", valueFlowFunctionDefaultParameter(tokenlist, symboldatabase, settings));
+        VALUEFLOW_PASS("valueFlowUninit", valueFlowUninit(tokenlist, symboldatabase, settings));
         if (tokenlist->isCPP()) {
-            valueFlowAfterMove(tokenlist, symboldatabase, settings);
-            valueFlowSmartPointer(tokenlist, errorLogger, settings);
-            valueFlowIterators(tokenlist, settings);
-            valueFlowCondition(IteratorConditionHandler{}, tokenlist, symboldatabase, errorLogger, settings);
-            valueFlowIteratorInfer(tokenlist, settings);
-            valueFlowContainerSize(tokenlist, symboldatabase, errorLogger, settings);
-            valueFlowCondition(ContainerConditionHandler{}, tokenlist, symboldatabase, errorLogger, settings);
-        }
-        valueFlowSafeFunctions(tokenlist, symboldatabase, settings);
+            VALUEFLOW_PASS("valueFlowAfterMove", valueFlowAfterMove(tokenlist, symboldatabase, settings));
+            VALUEFLOW_PASS("valueFlowSmartPointer", valueFlowSmartPointer(tokenlist, errorLogger, settings));
+            VALUEFLOW_PASS("valueFlowIterators", valueFlowIterators(tokenlist, settings));
+            VALUEFLOW_PASS("valueFlowCondition::IteratorConditionHandler", valueFlowCondition(IteratorConditionHandler{}, tokenlist, symboldatabase, errorLogger, settings));
+            VALUEFLOW_PASS("valueFlowIteratorInfer", valueFlowIteratorInfer(tokenlist, settings));
+            VALUEFLOW_PASS("valueFlowContainerSize", valueFlowContainerSize(tokenlist, symboldatabase, errorLogger, settings));
+            VALUEFLOW_PASS("valueFlowCondition::ContainerConditionHandler", valueFlowCondition(ContainerConditionHandler{}, tokenlist, symboldatabase, errorLogger, settings));
+        }
+        VALUEFLOW_PASS("valueFlowSafeFunctions", valueFlowSafeFunctions(tokenlist, symboldatabase, settings));
+        if (lowMemory)
+            break;
         n--;
     }
 
-    valueFlowDynamicBufferSize(tokenlist, symboldatabase, settings);
+    VALUEFLOW_PASS("valueFlowDynamicBufferSize", valueFlowDynamicBufferSize(tokenlist, symboldatabase, settings));
+
+    valueFlowFunctionLimits(tokenlist, symboldatabase, errorLogger, settings);
+
+    if (timerResults) {
+        Timer::count("ValueFlow::forks", ForwardAnalyzerCounters::get().forks - forks, settings->showtime, timerResults);
+        Timer::count("ValueFlow::clones", ValuePtrCounters::get().clones - clones.clones, settings->showtime, timerResults);
+        Timer::count("ValueFlow::cloneBytes", ValuePtrCounters::get().bytes - clones.bytes, settings->showtime, timerResults);
+    }
 }
 
+#undef VALUEFLOW_PASS
+
 ValueFlow::Value ValueFlow::Value::unknown()
 {
     Value v;
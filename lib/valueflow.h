@@ -37,6 +37,7 @@ class ErrorLogger;
 struct InferModel;
 class Settings;
 class SymbolDatabase;
+class TimerResultsIntf;
 class Token;
 class TokenList;
 class ValueType;
@@ -443,7 +444,10 @@ namespace ValueFlow {
     const ValueFlow::Value * valueFlowConstantFoldAST(Token *expr, const Settings *settings);
 
     /// Perform valueflow analysis.
-    void setValues(TokenList *tokenlist, SymbolDatabase* symboldatabase, ErrorLogger *errorLogger, const Settings *settings);
+    void setValues(TokenList *tokenlist, SymbolDatabase* symboldatabase, ErrorLogger *errorLogger, const Settings *settings, TimerResultsIntf *timerResults = nullptr);
+
+    /// Report the messages of the valueflow analysis, for --errorlist
+    void getErrorMessages(ErrorLogger *errorLogger);
 
     std::string eitherTheConditionIsRedundant(const Token *condition);
 
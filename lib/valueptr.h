@@ -22,14 +22,34 @@
 //---------------------------------------------------------------------------
 
 #include "config.h"
+#include <cstddef>
 #include <functional>
 #include <memory>
 
+/** Number of values that are cloned by ValuePtr, counted per thread (--showtime) */
+struct ValuePtrCounters {
+    ValuePtrCounters() : clones(0), bytes(0) {}
+    std::size_t clones;
+    std::size_t bytes;
+
+    static ValuePtrCounters& get() {
+        static thread_local ValuePtrCounters counters;
+        return counters;
+    }
+};
+
+/**
+ * Value semantics for polymorphic objects. Copies share the object until
+ * it is accessed through a non-const member; then the copy clones it. That
+ * way a copy is cheap when it is only read.
+ */
 template<class T>
 class CPPCHECKLIB ValuePtr {
     template<class U>
     struct cloner {
         static T* apply(const T* x) {
+            ++ValuePtrCounters::get().clones;
+            ValuePtrCounters::get().bytes += sizeof(U);
             return new U(*static_cast<const U*>(x));
         }
     };
@@ -43,21 +63,16 @@ public:
 
     template<class U>
     // cppcheck-suppress noExplicitConstructor
-    ValuePtr(const U& value) : mPtr(cloner<U>::apply(&value)), mClone(&cloner<U>::apply)
+    ValuePtr(const U& value) : mPtr(new U(value)), mClone(&cloner<U>::apply)
     {}
 
-    ValuePtr(const ValuePtr& rhs) : mPtr(nullptr), mClone(rhs.mClone) {
-        if (rhs) {
-            mPtr.reset(mClone(rhs.get()));
-        }
-    }
+    ValuePtr(const ValuePtr& rhs) : mPtr(rhs.mPtr), mClone(rhs.mClone) {}
     ValuePtr(ValuePtr&& rhs) : mPtr(std::move(rhs.mPtr)), mClone(std::move(rhs.mClone)) {}
 
-    pointer release() {
-        return mPtr.release();
-    }
-
-    T* get() NOEXCEPT {
+    /** the object can be modified, it is cloned first if it is shared with a copy */
+    T* get() {
+        if (mPtr && mPtr.use_count() > 1)
+            mPtr.reset(mClone(mPtr.get()));
         return mPtr.get();
     }
     const T* get() const NOEXCEPT {
@@ -71,7 +86,7 @@ public:
         return *get();
     }
 
-    T* operator->() NOEXCEPT {
+    T* operator->() {
         return get();
     }
     const T* operator->() const NOEXCEPT {
@@ -1,6 +1,7 @@
 # python -m pytest test-more-projects.py
 import json
 import os
+import time
 from testutils import cppcheck
 
 
@@ -65,3 +66,119 @@ def test_project_custom_platform(tmpdir):
     ret, stdout, stderr = cppcheck(['--project=' + project_file, '--template=cppcheck1'])
     assert ret == 0, stdout
     assert stderr == ''
+
+
+def test_build_dir_manifest(tmpdir):
+    # unchanged files are not reanalyzed, changed headers are detected
+    build_dir = os.path.join(tmpdir, 'b1')
+    os.mkdir(build_dir)
+    with open(os.path.join(tmpdir, 'header.h'), 'wt') as f:
+        f.write('#define DIVISOR 0\n')
+    with open(os.path.join(tmpdir, 'test.c'), 'wt') as f:
+        f.write('#include "header.h"\n'
+                'int x = 123 / DIVISOR;\n')
+
+    args = ['--cppcheck-build-dir=' + build_dir, '--template=cppcheck1', '-rp=' + str(tmpdir), os.path.join(tmpdir, 'test.c')]
+    ret, stdout, stderr = cppcheck(args)
+    assert ret == 0, stdout
+    assert stderr == '[test.c:2]: (error) Division by zero.\n'
+
+    with open(os.path.join(build_dir, 'test.a1'), 'rt') as f:
+        analyzer_info = f.read()
+    assert '<manifest ' in analyzer_info
+    assert 'header.h' in analyzer_info
+
+    # cached results are replayed
+    ret, stdout, stderr = cppcheck(args)
+    assert ret == 0, stdout
+    assert stderr == '[test.c:2]: (error) Division by zero.\n'
+
+    # the header is changed => reanalyze
+    with open(os.path.join(tmpdir, 'header.h'), 'wt') as f:
+        f.write('#define DIVISOR 2\n')
+    ret, stdout, stderr = cppcheck(args)
+    assert ret == 0, stdout
+    assert stderr == ''
+
+
+def test_include_path_index(tmpdir):
+    # headers are found through the cached directory index of the include paths
+    include_paths = []
+    for name in ('a', 'b', 'c'):
+        include_paths.append(os.path.join(tmpdir, name))
+        os.mkdir(include_paths[-1])
+    os.mkdir(os.path.join(tmpdir, 'c', 'sub'))
+    with open(os.path.join(tmpdir, 'c', 'sub', 'header.h'), 'wt') as f:
+        f.write('#define DIVISOR 0\n')
+    with open(os.path.join(tmpdir, 'test.c'), 'wt') as f:
+        f.write('#include <missing.h>\n'
+                '#include "sub/header.h"\n'
+                '#include <missing.h>\n'
+                'int x = 123 / DIVISOR;\n')
+
+    args = ['--template=cppcheck1', '--showtime=summary', '-rp=' + str(tmpdir), os.path.join(tmpdir, 'test.c')]
+    ret, stdout, stderr = cppcheck(['-I' + p for p in include_paths] + args)
+    assert ret == 0, stdout
+    assert stderr == '[test.c:4]: (error) Division by zero.\n'
+    assert 'simplecpp::fileLookupHits: ' in stdout
+    assert 'simplecpp::fileLookupMisses: ' in stdout
+
+
+def backdate(*paths):
+    # make sure the manifest is newer than the files and directories
+    t = time.time() - 10
+    for p in paths:
+        os.utime(p, (t, t))
+
+
+def test_build_dir_manifest_shadowing_header(tmpdir):
+    # a header that is added to a directory that is searched before the
+    # include path is detected
+    build_dir = os.path.join(tmpdir, 'b1')
+    os.mkdir(build_dir)
+    inc_dir = os.path.join(tmpdir, 'inc')
+    os.mkdir(inc_dir)
+    with open(os.path.join(inc_dir, 'header.h'), 'wt') as f:
+        f.write('#define DIVISOR 0\n')
+    with open(os.path.join(tmpdir, 'test.c'), 'wt') as f:
+        f.write('#include "header.h"\n'
+                'int x = 123 / DIVISOR;\n')
+    backdate(os.path.join(inc_dir, 'header.h'), os.path.join(tmpdir, 'test.c'), inc_dir, str(tmpdir))
+
+    args = ['--cppcheck-build-dir=' + build_dir, '--template=cppcheck1', '-rp=' + str(tmpdir), '-I' + inc_dir, os.path.join(tmpdir, 'test.c')]
+    ret, stdout, stderr = cppcheck(args)
+    assert ret == 0, stdout
+    assert stderr == '[test.c:2]: (error) Division by zero.\n'
+
+    with open(os.path.join(build_dir, 'test.a1'), 'rt') as f:
+        analyzer_info = f.read()
+    assert '<dir ' in analyzer_info
+
+    # header.h next to test.c is found before inc/header.h
+    with open(os.path.join(tmpdir, 'header.h'), 'wt') as f:
+        f.write('#define DIVISOR 2\n')
+    ret, stdout, stderr = cppcheck(args)
+    assert ret == 0, stdout
+    assert stderr == ''
+
+
+def test_build_dir_manifest_missing_header(tmpdir):
+    # a header that was missing and is added later is detected
+    build_dir = os.path.join(tmpdir, 'b1')
+    os.mkdir(build_dir)
+    with open(os.path.join(tmpdir, 'test.c'), 'wt') as f:
+        f.write('#include "sub/config.h"\n'
+                'int x = 123 / DIVISOR;\n')
+    backdate(os.path.join(tmpdir, 'test.c'), str(tmpdir))
+
+    args = ['--cppcheck-build-dir=' + build_dir, '--template=cppcheck1', '-rp=' + str(tmpdir), os.path.join(tmpdir, 'test.c')]
+    ret, stdout, stderr = cppcheck(args)
+    assert ret == 0, stdout
+    assert stderr == ''
+
+    os.mkdir(os.path.join(tmpdir, 'sub'))
+    with open(os.path.join(tmpdir, 'sub', 'config.h'), 'wt') as f:
+        f.write('#define DIVISOR 0\n')
+    ret, stdout, stderr = cppcheck(args)
+    assert ret == 0, stdout
+    assert stderr == '[test.c:2]: (error) Division by zero.\n'
@@ -0,0 +1,346 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2021 Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "binarydump.h"
+#include "testsuite.h"
+
+#include "settings.h"
+#include "symboldatabase.h"
+#include "tokenize.h"
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+
+class TestBinaryDump : public TestFixture {
+public:
+    TestBinaryDump() : TestFixture("TestBinaryDump") {}
+
+private:
+    void run() OVERRIDE {
+        TEST_CASE(roundtrip);
+        TEST_CASE(tokenlist);
+        TEST_CASE(symbolsAndValues);
+        TEST_CASE(smallerThanXml);
+        TEST_CASE(invalid);
+        TEST_CASE(invalidLength);
+    }
+
+    void roundtrip() const {
+        std::ostringstream out;
+        BinaryDump::Writer writer(out);
+        BinaryDump::Platform platform{"unix64", 8, 16, 32, 64, 64, 64};
+        writer.platform(platform);
+        writer.rawToken("a.c", 1, 1, "int");
+        writer.rawToken("a.c", 1, 5, "x");
+        writer.xml("<suppressions/>");
+        writer.beginConfiguration("A=1");
+        BinaryDump::Token tok;
+        tok.id = 0x1000;
+        tok.file = "a.c";
+        tok.linenr = 3;
+        tok.column = 7;
+        tok.str = "x";
+        tok.type = BinaryDump::Token::Name;
+        tok.flags = BinaryDump::Token::fIsUnsigned;
+        tok.varId = 2;
+        tok.astParent = 0x0f80;
+        tok.link = 0x2000;
+        tok.valueType = "valueType-type=\"int\"";
+        writer.token(tok);
+        BinaryDump::Scope scope;
+        scope.id = 0x3000;
+        scope.type = 3;
+        scope.className = "f";
+        BinaryDump::Function function;
+        function.id = 0x3100;
+        function.name = "f";
+        function.type = "Function";
+        function.flags = BinaryDump::Function::fIsStatic;
+        function.args.push_back(0x3200);
+        scope.functions.push_back(function);
+        scope.varlist.push_back(0x3200);
+        writer.scope(scope);
+        BinaryDump::Variable var;
+        var.id = 0x3200;
+        var.access = "Argument";
+        var.flags = BinaryDump::Variable::fIsPointer;
+        writer.variable(var);
+        BinaryDump::Values values;
+        values.id = 0x4000;
+        BinaryDump::Value value;
+        value.intvalue = -5;
+        value.kind = BinaryDump::Value::Known;
+        value.bound = "Point";
+        value.path = 1;
+        values.values.push_back(value);
+        value.type = BinaryDump::Value::Float;
+        value.floatValue = 0.5;
+        values.values.push_back(value);
+        writer.values(values);
+        BinaryDump::TypedefInfo info;
+        info.name = "u32";
+        info.file = "a.c";
+        info.line = 2;
+        info.used = true;
+        writer.typedefInfo(info);
+        writer.xml("<directivelist/>");
+        writer.endConfiguration();
+        writer.finish();
+
+        std::istringstream in(out.str());
+        ASSERT(BinaryDump::isBinaryDump(in));
+        BinaryDump::Data data;
+        std::string errmsg;
+        ASSERT(BinaryDump::read(in, data, errmsg));
+        ASSERT_EQUALS("", errmsg);
+        ASSERT_EQUALS("unix64", data.platform.name);
+        ASSERT_EQUALS(64, data.platform.pointer_bit);
+        ASSERT_EQUALS(2U, data.rawTokens.size());
+        ASSERT_EQUALS("a.c", data.rawTokens[1].file);
+        ASSERT_EQUALS(5U, data.rawTokens[1].column);
+        ASSERT_EQUALS("x", data.rawTokens[1].str);
+        ASSERT_EQUALS("<suppressions/>", data.xml);
+        ASSERT_EQUALS(1U, data.configurations.size());
+        const BinaryDump::Configuration &cfg = data.configurations[0];
+        ASSERT_EQUALS("A=1", cfg.name);
+        ASSERT_EQUALS("<directivelist/>", cfg.xml);
+        ASSERT_EQUALS(1U, cfg.tokens.size());
+        const BinaryDump::Token &t = cfg.tokens[0];
+        ASSERT(t.id == 0x1000);
+        ASSERT_EQUALS("a.c", t.file);
+        ASSERT_EQUALS(3U, t.linenr);
+        ASSERT_EQUALS(7U, t.column);
+        ASSERT_EQUALS("x", t.str);
+        ASSERT(t.type == BinaryDump::Token::Name);
+        ASSERT(t.isSet(BinaryDump::Token::fIsUnsigned));
+        ASSERT(!t.isSet(BinaryDump::Token::fIsSigned));
+        ASSERT_EQUALS(2U, t.varId);
+        ASSERT(t.astParent == 0x0f80);
+        ASSERT(t.link == 0x2000);
+        ASSERT(t.astOperand1 == 0);
+        ASSERT_EQUALS("valueType-type=\"int\"", t.valueType);
+
+        ASSERT_EQUALS(1U, cfg.scopes.size());
+        ASSERT(cfg.scopes[0].id == 0x3000);
+        ASSERT_EQUALS(3U, cfg.scopes[0].type);
+        ASSERT_EQUALS("f", cfg.scopes[0].className);
+        ASSERT_EQUALS(1U, cfg.scopes[0].functions.size());
+        ASSERT_EQUALS("Function", cfg.scopes[0].functions[0].type);
+        ASSERT(cfg.scopes[0].functions[0].isSet(BinaryDump::Function::fIsStatic));
+        ASSERT_EQUALS(1U, cfg.scopes[0].functions[0].args.size());
+        ASSERT(cfg.scopes[0].functions[0].args[0] == 0x3200);
+        ASSERT_EQUALS(1U, cfg.scopes[0].varlist.size());
+        ASSERT_EQUALS(1U, cfg.variables.size());
+        ASSERT_EQUALS("Argument", cfg.variables[0].access);
+        ASSERT(cfg.variables[0].isSet(BinaryDump::Variable::fIsPointer));
+        ASSERT(!cfg.variables[0].isSet(BinaryDump::Variable::fHasConstness));
+        ASSERT_EQUALS(1U, cfg.values.size());
+        ASSERT(cfg.values[0].id == 0x4000);
+        ASSERT_EQUALS(2U, cfg.values[0].values.size());
+        ASSERT(cfg.values[0].values[0].type == BinaryDump::Value::Int);
+        ASSERT(cfg.values[0].values[0].kind == BinaryDump::Value::Known);
+        ASSERT_EQUALS(-5, cfg.values[0].values[0].intvalue);
+        ASSERT_EQUALS("Point", cfg.values[0].values[0].bound);
+        ASSERT_EQUALS(1, cfg.values[0].values[0].path);
+        ASSERT(cfg.values[0].values[1].type == BinaryDump::Value::Float);
+        ASSERT_EQUALS_DOUBLE(0.5, cfg.values[0].values[1].floatValue, 1E-9);
+        ASSERT_EQUALS(1U, cfg.typedefInfo.size());
+        ASSERT_EQUALS("u32", cfg.typedefInfo[0].name);
+        ASSERT(cfg.typedefInfo[0].used);
+    }
+
+    void tokenlist() {
+        Settings settings;
+        Tokenizer tokenizer(&settings, this);
+        std::istringstream istr("void f(unsigned int x) { if (x == 1) {} }");
+        ASSERT(tokenizer.tokenize(istr, "test.cpp"));
+
+        std::ostringstream out;
+        BinaryDump::Writer writer(out);
+        writer.beginConfiguration("");
+        tokenizer.dump(writer);
+        writer.endConfiguration();
+        writer.finish();
+
+        std::istringstream in(out.str());
+        BinaryDump::Data data;
+        std::string errmsg;
+        ASSERT(BinaryDump::read(in, data, errmsg));
+        ASSERT_EQUALS(1U, data.configurations.size());
+        const BinaryDump::Configuration &cfg = data.configurations[0];
+
+        std::string str;
+        const Token *tok = tokenizer.tokens();
+        for (const BinaryDump::Token &t : cfg.tokens) {
+            ASSERT(tok != nullptr);
+            if (!tok)
+                break;
+            ASSERT_EQUALS(tok->str(), t.str);
+            ASSERT(t.id == reinterpret_cast<std::uintptr_t>(tok));
+            ASSERT(t.link == reinterpret_cast<std::uintptr_t>(tok->link()));
+            ASSERT(t.astOperand1 == reinterpret_cast<std::uintptr_t>(tok->astOperand1()));
+            ASSERT_EQUALS(tok->varId(), t.varId);
+            str += t.str + " ";
+            tok = tok->next();
+        }
+        ASSERT(tok == nullptr);
+        ASSERT_EQUALS("void f ( int x ) { if ( x == 1 ) { } } ", str);
+        ASSERT(cfg.xml.empty());
+
+        ASSERT(cfg.tokens[1].type == BinaryDump::Token::Name);
+        ASSERT(cfg.tokens[3].isSet(BinaryDump::Token::fIsUnsigned));
+        ASSERT(cfg.tokens[10].isSet(BinaryDump::Token::fIsComparisonOp));
+        ASSERT(cfg.tokens[11].isSet(BinaryDump::Token::fIsInt));
+        ASSERT(!cfg.tokens[11].valueType.empty());
+    }
+
+    void symbolsAndValues() {
+        Settings settings;
+        Tokenizer tokenizer(&settings, this);
+        std::istringstream istr("struct S { int m; };\n"
+                                "int f(int *p) { int x = 3; return x + *p; }");
+        ASSERT(tokenizer.tokenize(istr, "test.cpp"));
+
+        std::ostringstream out;
+        BinaryDump::Writer writer(out);
+        writer.beginConfiguration("");
+        tokenizer.dump(writer);
+        writer.endConfiguration();
+        writer.finish();
+
+        std::istringstream in(out.str());
+        BinaryDump::Data data;
+        std::string errmsg;
+        ASSERT(BinaryDump::read(in, data, errmsg));
+        const BinaryDump::Configuration &cfg = data.configurations[0];
+        const SymbolDatabase *symbolDatabase = tokenizer.getSymbolDatabase();
+
+        // scopes
+        ASSERT_EQUALS(symbolDatabase->scopeList.size(), cfg.scopes.size());
+        const Scope *fscope = symbolDatabase->functionScopes[0];
+        const BinaryDump::Scope *dscope = nullptr;
+        for (const BinaryDump::Scope &s : cfg.scopes) {
+            if (s.id == reinterpret_cast<std::uintptr_t>(fscope))
+                dscope = &s;
+        }
+        ASSERT(dscope != nullptr);
+        if (!dscope)
+            return;
+        ASSERT(dscope->bodyStart == reinterpret_cast<std::uintptr_t>(fscope->bodyStart));
+        ASSERT(dscope->function == reinterpret_cast<std::uintptr_t>(fscope->function));
+        ASSERT_EQUALS(1U, dscope->varlist.size());
+
+        // the global scope has the function
+        const BinaryDump::Scope &global = cfg.scopes[0];
+        ASSERT_EQUALS(1U, global.functions.size());
+        ASSERT_EQUALS("f", global.functions[0].name);
+        ASSERT_EQUALS(1U, global.functions[0].args.size());
+
+        // variables: m, p, x
+        ASSERT_EQUALS(3U, cfg.variables.size());
+        bool pointer = false;
+        for (const BinaryDump::Variable &var : cfg.variables) {
+            if (var.id == global.functions[0].args[0]) {
+                ASSERT_EQUALS("Argument", var.access);
+                pointer = var.isSet(BinaryDump::Variable::fIsPointer);
+            }
+        }
+        ASSERT(pointer);
+
+        // values: "3", "=" and "x" in "return x" have the value 3
+        int values = 0;
+        for (const BinaryDump::Token &t : cfg.tokens) {
+            if (!t.values)
+                continue;
+            for (const BinaryDump::Values &v : cfg.values) {
+                if (v.id != t.values)
+                    continue;
+                ++values;
+                ASSERT_EQUALS(1U, v.values.size());
+                ASSERT(v.values[0].type == BinaryDump::Value::Int);
+                ASSERT_EQUALS(3, v.values[0].intvalue);
+            }
+        }
+        ASSERT_EQUALS(3, values);
+    }
+
+    void smallerThanXml() {
+        Settings settings;
+        Tokenizer tokenizer(&settings, this);
+        std::istringstream istr("int a[10];\n"
+                                "void f() {\n"
+                                "  for (int i = 0; i < 10; i++) { a[i] = i * 2; }\n"
+                                "  for (int i = 0; i < 10; i++) { a[i] = i * 3; }\n"
+                                "}");
+        ASSERT(tokenizer.tokenize(istr, "test.cpp"));
+
+        std::ostringstream xml;
+        tokenizer.dump(xml);
+
+        std::ostringstream bin;
+        BinaryDump::Writer writer(bin);
+        writer.beginConfiguration("");
+        tokenizer.dump(writer);
+        writer.endConfiguration();
+        writer.finish();
+
+        ASSERT(bin.str().size() < xml.str().size());
+    }
+
+    void invalid() const {
+        BinaryDump::Data data;
+        std::string errmsg;
+
+        std::istringstream xml("<?xml version=\"1.0\"?>");
+        ASSERT(!BinaryDump::isBinaryDump(xml));
+        ASSERT(!BinaryDump::read(xml, data, errmsg));
+        ASSERT_EQUALS("not a binary dump file", errmsg);
+
+        // truncated file
+        std::ostringstream out;
+        BinaryDump::Writer writer(out);
+        writer.beginConfiguration("abc");
+        const std::string s = out.str();
+        std::istringstream truncated(s.substr(0, s.size() - 1));
+        ASSERT(!BinaryDump::read(truncated, data, errmsg));
+        ASSERT_EQUALS("unexpected end of binary dump", errmsg);
+    }
+
+    void invalidLength() const {
+        // the record length is not trusted, nothing is allocated for it up front
+        std::ostringstream out;
+        const BinaryDump::Writer writer(out);
+        const std::string header = out.str();
+        const char string = static_cast<char>(BinaryDump::Record::String);
+
+        BinaryDump::Data data;
+        std::string errmsg;
+        std::istringstream huge(header + string + "\xff\xff\xff\xff\xff\xff\xff\xff\xff\x01" "abc");
+        ASSERT(!BinaryDump::read(huge, data, errmsg));
+        ASSERT_EQUALS("invalid record length in binary dump", errmsg);
+
+        std::istringstream large(header + string + "\x80\x80\x80\x80\x02" "abc");
+        ASSERT(!BinaryDump::read(large, data, errmsg));
+        ASSERT_EQUALS("unexpected end of binary dump", errmsg);
+    }
+};
+
+REGISTER_TEST(TestBinaryDump)
@@ -304,6 +304,7 @@ private:
         TEST_CASE(ctu_malloc);
         TEST_CASE(ctu_array);
         TEST_CASE(ctu_variable);
+        TEST_CASE(ctu_jobs);
         TEST_CASE(ctu_arithmetic);
 
         TEST_CASE(objectIndex);
@@ -4620,6 +4621,54 @@ private:
         delete ctu;
     }
 
+    void ctu_jobs() {
+        // whole program analysis with several jobs reports the same errors in the same order
+        const char * const code[] = {
+            "void dostuff1(char *p) { p[-3] = 0; }\n"
+            "int main1() { char *s = malloc(4); dostuff1(s); }",
+            "void dostuff2(char *p) { p[10] = 0; }\n"
+            "int main2() { char s[4]; dostuff2(s); }",
+            "void dostuff3(char *p) { p[-1] = 0; }\n"
+            "int main3() { char *s = malloc(4); dostuff3(s); }",
+            "void dostuff4(char *p) { p[20] = 0; }\n"
+            "int main4() { char s[4]; dostuff4(s); }"
+        };
+        std::string expected;
+        for (int jobs : {1, 3}) {
+            errout.str("");
+            Settings settings = settings0;
+            settings.jobs = jobs;
+            CTU::FileInfo ctu;
+            std::list<Check::FileInfo*> fileInfo;
+            int fileNr = 0;
+            for (const char *c : code) {
+                Tokenizer tokenizer(&settings, this);
+                std::istringstream istr(c);
+                ASSERT(tokenizer.tokenize(istr, ("test" + std::to_string(++fileNr) + ".cpp").c_str()));
+                const CTU::FileInfo *fi = CTU::getFileInfo(&tokenizer);
+                ctu.functionCalls.insert(ctu.functionCalls.end(), fi->functionCalls.begin(), fi->functionCalls.end());
+                ctu.nestedCalls.insert(ctu.nestedCalls.end(), fi->nestedCalls.begin(), fi->nestedCalls.end());
+                delete fi;
+                CheckBufferOverrun checkBO(&tokenizer, &settings, this);
+                fileInfo.push_back(checkBO.getFileInfo(&tokenizer, &settings));
+            }
+            CheckBufferOverrun checkBO(nullptr, &settings, this);
+            checkBO.analyseWholeProgram(&ctu, fileInfo, settings, *this);
+            while (!fileInfo.empty()) {
+                delete fileInfo.back();
+                fileInfo.pop_back();
+            }
+            if (jobs == 1)
+                expected = errout.str();
+        }
+        ASSERT_EQUALS("[test1.cpp:2] -> [test1.cpp:2] -> [test1.cpp:1]: (error) Array index out of bounds; buffer 'p' is accessed at offset -3.\n"
+                      "[test2.cpp:2] -> [test2.cpp:1]: (error) Array index out of bounds; 'p' buffer size is 4 and it is accessed at offset 10.\n"
+                      "[test3.cpp:2] -> [test3.cpp:2] -> [test3.cpp:1]: (error) Array index out of bounds; buffer 'p' is accessed at offset -1.\n"
+                      "[test4.cpp:2] -> [test4.cpp:1]: (error) Array index out of bounds; 'p' buffer size is 4 and it is accessed at offset 20.\n",
+                      expected);
+        ASSERT_EQUALS(expected, errout.str());
+    }
+
     void ctu_malloc() {
         ctu("void dostuff(char *p) {\n"
             "  p[-3] = 0;\n"
@@ -16,6 +16,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "bughuntingchecks.h"
 #include "config.h"
 #include "exprengine.h"
 #include "settings.h"
@@ -61,6 +62,8 @@ private:
         TEST_CASE(uninit_fp_struct_member_init_2);
         TEST_CASE(uninit_fp_template_var);
         TEST_CASE(ctu);
+        TEST_CASE(jobs);
+        TEST_CASE(solverReport);
 #endif
     }
 
@@ -380,6 +383,54 @@ private:
               "}");
         ASSERT_EQUALS("", errout.str());
     }
+
+    void jobs() {
+        const char code[] = "void f1(int x) {\n"
+                            "  int p[8];\n"
+                            "  p[x] = 0;\n"
+                            "}\n"
+                            "void f2(int x) {\n"
+                            "  return 100 / x;\n"
+                            "}\n"
+                            "void f3(int x) {\n"
+                            "  int p[8];\n"
+                            "  p[x] = 0;\n"
+                            "}";
+        check(code);
+        const std::string expected = errout.str();
+        ASSERT(!expected.empty());
+
+        // The errors are reported in the same order when the functions are executed in parallel
+        settings.bugHuntingJobs = 3;
+        check(code);
+        settings.bugHuntingJobs = 1;
+        ASSERT_EQUALS(expected, errout.str());
+    }
+
+    void solverReport() {
+        Settings s(settings);
+        s.bugHunting = true;
+        s.bugHuntingReport = "report.txt";
+        Tokenizer tokenizer(&s, this);
+        std::istringstream istr("int f(int x, int y) {\n"
+                                "  if (x > 3) {\n"
+                                "    if (y > 3)\n"
+                                "      return 100 / (x - 2) + 100 / (y - 4);\n"
+                                "  }\n"
+                                "  return 0;\n"
+                                "}");
+        ASSERT(tokenizer.tokenize(istr, "test.cpp"));
+        std::vector<ExprEngine::Callback> callbacks;
+        addBughuntingChecks(&callbacks);
+        std::ostringstream report;
+        errout.str("");
+        ExprEngine::executeAllFunctions(this, &tokenizer, &s, callbacks, report);
+        ASSERT_EQUALS("[test.cpp:4]: (error) There is division, cannot determine that there can't be a division by zero.\n", errout.str());
+        // The path constraints are asserted once and reused by the following queries
+        const std::string::size_type pos = report.str().find("[solver time] f(x,y) ");
+        ASSERT(pos != std::string::npos);
+        ASSERT(report.str().find(" 5 queries, 0 cached, 2 reused constraints\n", pos) != std::string::npos);
+    }
 };
 
 REGISTER_TEST(TestBughuntingChecks)
@@ -125,6 +125,13 @@ private:
         TEST_CASE(xmlverinvalid);
         TEST_CASE(doc);
         TEST_CASE(showtime);
+        TEST_CASE(showtimeOutput);
+        TEST_CASE(maxValueFlowMemory);
+        TEST_CASE(maxValueFlowMemoryInvalid);
+        TEST_CASE(maxValueFlowFunctionLimits);
+        TEST_CASE(maxValueFlowFunctionLimitsInvalid);
+        TEST_CASE(bugHuntingJobs);
+        TEST_CASE(bugHuntingJobsInvalid);
         TEST_CASE(errorlist1);
         TEST_CASE(errorlistverbose1);
         TEST_CASE(errorlistverbose2);
@@ -914,6 +921,71 @@ private:
         ASSERT(settings.showtime == SHOWTIME_MODES::SHOWTIME_SUMMARY);
     }
 
+    void showtimeOutput() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--showtime-output=trace.json", "file.cpp"};
+        settings.showtime = SHOWTIME_MODES::SHOWTIME_NONE;
+        settings.showtimeOutput.clear();
+        ASSERT(defParser.parseFromArgs(3, argv));
+        ASSERT_EQUALS("trace.json", settings.showtimeOutput);
+        ASSERT(settings.showtime == SHOWTIME_MODES::SHOWTIME_SUMMARY);
+        settings.showtimeOutput.clear();
+        settings.showtime = SHOWTIME_MODES::SHOWTIME_NONE;
+    }
+
+    void maxValueFlowMemory() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--max-valueflow-memory=512", "file.cpp"};
+        settings.maxValueFlowMemory = 0;
+        ASSERT(defParser.parseFromArgs(3, argv));
+        ASSERT_EQUALS(512, settings.maxValueFlowMemory);
+        settings.maxValueFlowMemory = 0;
+    }
+
+    void maxValueFlowMemoryInvalid() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--max-valueflow-memory=-1", "file.cpp"};
+        // Fails since the budget must not be negative
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv));
+    }
+
+    void maxValueFlowFunctionLimits() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--max-valueflow-function-steps=10000", "--max-valueflow-function-time=5", "file.cpp"};
+        settings.maxValueFlowFunctionSteps = 0;
+        settings.maxValueFlowFunctionTime = 0;
+        ASSERT(defParser.parseFromArgs(4, argv));
+        ASSERT_EQUALS(10000, settings.maxValueFlowFunctionSteps);
+        ASSERT_EQUALS(5, settings.maxValueFlowFunctionTime);
+        settings.maxValueFlowFunctionSteps = 0;
+        settings.maxValueFlowFunctionTime = 0;
+    }
+
+    void maxValueFlowFunctionLimitsInvalid() {
+        REDIRECT;
+        const char * const argv1[] = {"cppcheck", "--max-valueflow-function-steps=-1", "file.cpp"};
+        // Fails since the limit must not be negative
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv1));
+        const char * const argv2[] = {"cppcheck", "--max-valueflow-function-time=-1", "file.cpp"};
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv2));
+    }
+
+    void bugHuntingJobs() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--bug-hunting-jobs=4", "file.cpp"};
+        settings.bugHuntingJobs = 1;
+        ASSERT(defParser.parseFromArgs(3, argv));
+        ASSERT_EQUALS(4, settings.bugHuntingJobs);
+        settings.bugHuntingJobs = 1;
+    }
+
+    void bugHuntingJobsInvalid() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--bug-hunting-jobs=0", "file.cpp"};
+        // Fails since at least one job is needed
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv));
+    }
+
     void errorlist1() {
         REDIRECT;
         const char * const argv[] = {"cppcheck", "--errorlist"};
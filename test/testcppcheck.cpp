@@ -49,6 +49,7 @@ private:
         TEST_CASE(instancesSorted);
         TEST_CASE(classInfoFormat);
         TEST_CASE(getErrorMessages);
+        TEST_CASE(wholeProgramFileInfo);
     }
 
     void instancesSorted() const {
@@ -103,6 +104,30 @@ private:
         ASSERT(foundPurgedConfiguration);
         ASSERT(foundTooManyConfigs);
     }
+
+    unsigned int checkWholeProgram(int jobs, int maxCtuDepth, ErrorLogger2 &errorLogger) const {
+        CppCheck cppCheck(errorLogger, true, nullptr);
+        cppCheck.settings().jobs = jobs;
+        cppCheck.settings().maxCtuDepth = maxCtuDepth;
+        cppCheck.check("test.c",
+                       "void dostuff(int *p) { *p = 0; }\n"
+                       "void f() { dostuff(0); }\n");
+        cppCheck.analyseWholeProgram();
+        return std::count(errorLogger.id.begin(), errorLogger.id.end(), "ctunullpointer");
+    }
+
+    void wholeProgramFileInfo() const {
+        ErrorLogger2 errorLogger1;
+        ASSERT_EQUALS(1U, checkWholeProgram(1, 2, errorLogger1));
+
+        // disabled by max-ctu-depth
+        ErrorLogger2 errorLogger2;
+        ASSERT_EQUALS(0U, checkWholeProgram(1, 0, errorLogger2));
+
+        // no whole program analysis in the worker processes => no file info is collected
+        ErrorLogger2 errorLogger3;
+        ASSERT_EQUALS(0U, checkWholeProgram(2, 2, errorLogger3));
+    }
 };
 
 REGISTER_TEST(TestCppcheck)
@@ -25,7 +25,10 @@
 #include "tokenlist.h"
 
 #include <tinyxml2.h>
+#include <cstdio>
+#include <fstream>
 #include <map>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -62,6 +65,8 @@ private:
         TEST_CASE(resource);
         TEST_CASE(podtype);
         TEST_CASE(container);
+        TEST_CASE(containerDetect);
+        TEST_CASE(cache);
         TEST_CASE(version);
         TEST_CASE(loadLibErrors);
     }
@@ -590,6 +595,17 @@ private:
             ASSERT(tokenizer.tokenize(istr, "test.cpp"));
             ASSERT(!library.isnullargbad(Token::findsimplematch(tokenizer.tokens(), "f"),1));
         }
+
+        // the function is replaced by another one, the number of functions is the same
+        library.functions["Base::g"] = library.functions["Base::f"];
+        library.functions.erase("Base::f");
+        library.buildIndexes();
+        {
+            Tokenizer tokenizer(&settings, nullptr);
+            std::istringstream istr("struct X : public Base { void dostuff() { g(0); } };");
+            ASSERT(tokenizer.tokenize(istr, "test.cpp"));
+            ASSERT(library.isnullargbad(Token::findsimplematch(tokenizer.tokens(), "g"),1));
+        }
     }
 
     void function_warn() const {
@@ -840,6 +856,161 @@ private:
         ASSERT_EQUALS(C.arrayLike_indexOp, true);
     }
 
+    void containerDetect() const {
+        const char xmldata[] = "<?xml version=\"1.0\"?>\n"
+                               "<def>\n"
+                               "  <container id=\"A\" startPattern=\"std :: A|AA &lt;\" endPattern=\"&gt; !!::\" itEndPattern=\"&gt; :: iterator\"/>\n"
+                               "  <container id=\"B\" startPattern=\"B\"/>\n"
+                               "  <container id=\"C\" startPattern=\"%name% :: C\"/>\n"
+                               "  <container id=\"D\" startPattern=\"std :: experimental :: D\"/>\n"
+                               "</def>";
+
+        Library library;
+        ASSERT_EQUALS(true, Library::ErrorCode::OK == (readLibrary(library, xmldata)).errorcode);
+
+        TokenList tokenList(nullptr);
+        std::istringstream istr("std :: A < int > a ; std :: AA < int > :: iterator it ; B b ; x :: C c ; std :: experimental :: D d ; std :: B e ;");
+        tokenList.createTokens(istr);
+        for (Token *tok = tokenList.front(); tok; tok = tok->next()) {
+            if (tok->str() == "<")
+                Token::createMutualLinks(tok, tok->tokAt(2));
+        }
+
+        const Token *tok = tokenList.front();
+        ASSERT(library.detectContainer(tok) == &library.containers["A"]);
+        ASSERT(library.detectContainer(tok, true) == nullptr);
+        tok = Token::findsimplematch(tok, "AA")->tokAt(-2);
+        ASSERT(library.detectContainer(tok) == nullptr);
+        ASSERT(library.detectContainer(tok, true) == &library.containers["A"]);
+        ASSERT(library.detectContainer(Token::findsimplematch(tok, "B")) == &library.containers["B"]);
+        ASSERT(library.detectContainer(Token::findsimplematch(tok, "x")) == &library.containers["C"]);
+        ASSERT(library.detectContainer(Token::findsimplematch(tok, "std :: experimental")) == &library.containers["D"]);
+        ASSERT(library.detectContainer(Token::findsimplematch(tok, "std :: B")) == nullptr);
+        ASSERT(library.detectContainer(nullptr) == nullptr);
+
+        // containers that are added after the library is loaded are found when the indexes are rebuilt
+        Library::Container e;
+        e.startPattern = "x";
+        e.startPattern2 = "x !!::";
+        library.containers["E"] = e;
+        library.buildIndexes();
+        ASSERT(library.detectContainer(Token::findsimplematch(tok, "x")) == &library.containers["C"]);
+        e.startPattern = "std :: B";
+        e.startPattern2 = "std :: B !!::";
+        library.containers["E2"] = e;
+        library.buildIndexes();
+        ASSERT(library.detectContainer(Token::findsimplematch(tok, "std :: B")) == &library.containers["E2"]);
+
+        library.containers["D"].startPattern = "std :: A";
+        library.containers["D"].startPattern2 = "std :: A !!::";
+        library.containers["A"].startPattern = library.containers["A"].startPattern2 = "QString";
+        library.buildIndexes();
+        ASSERT(library.detectContainer(tokenList.front()) == &library.containers["D"]);
+    }
+
+    void cache() const {
+        const char cfg[] = "testlibrarycache.cfg";
+        const char cacheFile[] = "testlibrarycache.cache";
+        {
+            std::ofstream fout(cfg);
+            fout << "<?xml version=\"1.0\"?>\n"
+                 "<def>\n"
+                 "  <memory>\n"
+                 "    <alloc init=\"false\" buffer-size=\"malloc\">malloc</alloc>\n"
+                 "    <dealloc>free</dealloc>\n"
+                 "  </memory>\n"
+                 "  <function name=\"foo\">\n"
+                 "    <noreturn>true</noreturn>\n"
+                 "    <arg nr=\"1\"><not-null/><valid>0:</valid></arg>\n"
+                 "    <arg nr=\"2\"><minsize type=\"argvalue\" arg=\"1\"/></arg>\n"
+                 "  </function>\n"
+                 "  <container id=\"A\" startPattern=\"std :: A &lt;\">\n"
+                 "    <size><function name=\"size\" yields=\"size\"/></size>\n"
+                 "  </container>\n"
+                 "  <podtype name=\"u8\" sign=\"u\" size=\"1\"/>\n"
+                 "  <define name=\"X\" value=\"1\"/>\n"
+                 "</def>";
+        }
+
+        Library library;
+        ASSERT(library.load(nullptr, cfg).errorcode == Library::ErrorCode::OK);
+        ASSERT(library.saveCache(cacheFile));
+
+        Library cached;
+        ASSERT(cached.loadCache(cacheFile, nullptr, std::vector<std::string>(1, cfg)));
+        ASSERT_EQUALS(library.allocId("malloc"), cached.allocId("malloc"));
+        ASSERT_EQUALS(library.deallocId("free"), cached.deallocId("free"));
+        ASSERT(cached.getAllocFuncInfo("malloc")->bufferSize == Library::AllocFunc::BufferSize::malloc);
+        ASSERT_EQUALS(1U, cached.functions.count("foo"));
+        ASSERT_EQUALS(true, cached.functions["foo"].argumentChecks[1].notnull);
+        ASSERT_EQUALS("0:", cached.functions["foo"].argumentChecks[1].valid);
+        ASSERT_EQUALS(1U, cached.functions["foo"].argumentChecks[2].minsizes.size());
+        ASSERT_EQUALS(1U, cached.containers.count("A"));
+        ASSERT_EQ(Library::Container::Yield::SIZE, cached.containers["A"].getYield("size"));
+        ASSERT_EQUALS(1U, cached.podtype("u8")->size);
+        ASSERT_EQUALS("X 1", cached.defines.front());
+
+        TokenList tokenList(nullptr);
+        std::istringstream istr("foo ( 1 , 2 ) ; std :: A < int > a ;");
+        tokenList.createTokens(istr);
+        ASSERT(cached.isnoreturn(tokenList.front()));
+        ASSERT(cached.detectContainer(Token::findsimplematch(tokenList.front(), "std")) == &cached.containers["A"]);
+
+        // the library must be empty
+        ASSERT(!cached.loadCache(cacheFile, nullptr, std::vector<std::string>(1, cfg)));
+        // other configuration files are requested
+        Library other;
+        ASSERT(!other.loadCache(cacheFile, nullptr, std::vector<std::string>(1, "std.cfg")));
+        // the configuration file has changed
+        {
+            std::ofstream fout(cfg, std::ios::app);
+            fout << "\n";
+        }
+        ASSERT(!other.loadCache(cacheFile, nullptr, std::vector<std::string>(1, cfg)));
+        ASSERT(other.functions.empty());
+        // the cache was written with another layout, it follows the magic string and the version
+        {
+            std::ofstream fout(cfg, std::ios::trunc);
+            fout << "<?xml version=\"1.0\"?>\n<def/>";
+        }
+        Library empty;
+        ASSERT(empty.load(nullptr, cfg).errorcode == Library::ErrorCode::OK);
+        ASSERT(empty.saveCache(cacheFile));
+        Library reloaded;
+        ASSERT(reloaded.loadCache(cacheFile, nullptr, std::vector<std::string>(1, cfg)));
+        {
+            std::fstream f(cacheFile, std::ios::in | std::ios::out | std::ios::binary);
+            f.seekg(24);
+            const char c = static_cast<char>(f.get() ^ 1);
+            f.seekp(24);
+            f.put(c);
+        }
+        Library otherLayout;
+        ASSERT(!otherLayout.loadCache(cacheFile, nullptr, std::vector<std::string>(1, cfg)));
+
+        // "testlibrarycache" is found as "testlibrarycache.cfg"..
+        const char name[] = "testlibrarycache";
+        Library byName;
+        ASSERT(byName.load(nullptr, name).errorcode == Library::ErrorCode::OK);
+        ASSERT(byName.saveCache(cacheFile));
+        Library reloadedByName;
+        ASSERT(reloadedByName.loadCache(cacheFile, nullptr, std::vector<std::string>(1, name)));
+        // ..until a file with that name shadows it
+        {
+            std::ofstream fout(name);
+            fout << "<?xml version=\"1.0\"?>\n<def/>";
+        }
+        Library shadowed;
+        ASSERT(!shadowed.loadCache(cacheFile, nullptr, std::vector<std::string>(1, name)));
+        std::remove(name);
+        // the configuration file is removed
+        std::remove(cfg);
+        Library removed;
+        ASSERT(!removed.loadCache(cacheFile, nullptr, std::vector<std::string>(1, name)));
+
+        std::remove(cacheFile);
+    }
+
     void version() const {
         {
             const char xmldata[] = "<?xml version=\"1.0\"?>\n"
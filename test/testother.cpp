@@ -57,6 +57,7 @@ private:
         TEST_CASE(zeroDiv11);
         TEST_CASE(zeroDiv12);
         TEST_CASE(zeroDiv13);
+        TEST_CASE(zeroDiv14); // error order
 
         TEST_CASE(zeroDivCond); // division by zero / useless condition
 
@@ -585,6 +586,16 @@ private:
         ASSERT_EQUALS("[test.cpp:4]: (error) Division by zero.\n", errout.str());
     }
 
+    void zeroDiv14() {
+        // the division by zero is reported before the errors of the checks executed after it
+        check("int f(int x) {\n"
+              "label:\n"
+              "    return x / 0;\n"
+              "}\n");
+        ASSERT_EQUALS("[test.cpp:3]: (error) Division by zero.\n"
+                      "[test.cpp:2]: (style) Label 'label' is not used.\n", errout.str());
+    }
+
     void zeroDivCond() {
         check("void f(unsigned int x) {\n"
               "  int y = 17 / x;\n"
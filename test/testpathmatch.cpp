@@ -67,6 +67,8 @@ private:
         TEST_CASE(filemaskpath2);
         TEST_CASE(filemaskpath3);
         TEST_CASE(filemaskpath4);
+        TEST_CASE(mixedmasks);
+        TEST_CASE(manymasks);
     }
 
     // Test empty PathMatch
@@ -201,6 +203,33 @@ private:
     void filemaskpath4() const {
         ASSERT(!srcFooCppMatcher.match("bar/foo.cpp"));
     }
+
+    void mixedmasks() const {
+        // directory and file masks are split into separate tries, the
+        // result must be the same as when each mask is tried in turn
+        std::vector<std::string> masks = { "src/", "foo.cpp" };
+        PathMatch match(masks);
+        ASSERT(match.match("foo.cpp"));
+        ASSERT(match.match("lib/foo.cpp"));
+        ASSERT(match.match("lib/src/bar.cpp"));
+        ASSERT(!match.match("lib/bar.cpp"));
+    }
+
+    void manymasks() const {
+        std::vector<std::string> masks;
+        for (int i = 0; i < 10000; ++i) {
+            masks.push_back("dir" + std::to_string(i) + "/");
+            masks.push_back("file" + std::to_string(i) + ".cpp");
+        }
+        PathMatch match(masks);
+        ASSERT(match.match("dir42/"));
+        ASSERT(match.match("project/dir9999/a.cpp"));
+        ASSERT(match.match("project/src/file123.cpp"));
+        ASSERT(!match.match("project/dir10000/a.cpp"));
+        ASSERT(!match.match("project/mydir1/a.cpp"));
+        ASSERT(!match.match("project/src/file123.cpp.bak"));
+        ASSERT(!match.match("project/src/file123.c"));
+    }
 };
 
 REGISTER_TEST(TestPathMatch)
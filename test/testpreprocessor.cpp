@@ -26,11 +26,16 @@
 #include "testsuite.h"
 
 #include <simplecpp.h>
+#include <chrono>
+#include <cstdio>
 #include <cstring>
+#include <ctime>
+#include <fstream>
 #include <list>
 #include <map>
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 class ErrorLogger;
@@ -248,6 +253,15 @@ private:
         TEST_CASE(testDirectiveIncludeTypes);
         TEST_CASE(testDirectiveIncludeLocations);
         TEST_CASE(testDirectiveIncludeComments);
+
+        TEST_CASE(checksum);
+
+        TEST_CASE(headerCache);
+
+        TEST_CASE(tokensInOtherThread);
+        TEST_CASE(fileBuffers);
+        TEST_CASE(fileLookupCache);
+        TEST_CASE(fileStatus);
     }
 
     void preprocess(const char* code, std::map<std::string, std::string>& actual, const char filename[] = "file.c") {
@@ -2383,6 +2397,225 @@ private:
         preprocessor.dump(ostr);
         ASSERT_EQUALS(dumpdata, ostr.str());
     }
+
+    static unsigned long long checksum(const char code[], const std::string &toolinfo) {
+        std::istringstream istr(code);
+        std::vector<std::string> files;
+        simplecpp::TokenList tokens(istr, files, "test.c");
+        Settings settings;
+        Preprocessor preprocessor(settings);
+        return preprocessor.calculateChecksum(tokens, toolinfo);
+    }
+
+    void checksum() {
+        const unsigned long long c = checksum("int x; // comment", "cppcheck");
+        ASSERT(c == checksum("int x; // comment", "cppcheck"));
+        // comments are ignored
+        ASSERT(c == checksum("int x; /* other comment */", "cppcheck"));
+        ASSERT(c != checksum("int y;", "cppcheck"));
+        ASSERT(c != checksum("int x;", "cppcheck 2"));
+    }
+
+    void headerCache() {
+        const char code[] = "#include \"a.h\"\n"
+                            "#include \"a.h\"\n"
+                            "int y = A;\n";
+        const char header[] = "#ifndef A_H\n"
+                              "#define A_H\n"
+                              "#ifdef X\n"
+                              "#define A 1\n"
+                              "#else\n"
+                              "#define A 2\n"
+                              "#endif\n"
+                              "int x = A;\n"
+                              "#endif\n";
+        std::vector<std::string> files;
+        std::istringstream istr(code);
+        const simplecpp::TokenList tokens1(istr, files, "test.c");
+        std::istringstream istrHeader(header);
+        simplecpp::TokenList tokensHeader(istrHeader, files, "a.h");
+        std::map<std::string, simplecpp::TokenList*> filedata;
+        filedata["a.h"] = &tokensHeader;
+
+        simplecpp::PreprocessCache cache;
+        const char * const configs[] = { "", "X", "", "X" };
+        for (const char *cfg : configs) {
+            simplecpp::DUI dui;
+            if (*cfg)
+                dui.defines.emplace_back(cfg);
+            simplecpp::TokenList cached(files);
+            std::list<simplecpp::IfCond> cachedIfCond;
+            simplecpp::preprocess(cached, tokens1, files, filedata, dui, nullptr, nullptr, &cachedIfCond, &cache);
+            simplecpp::TokenList uncached(files);
+            std::list<simplecpp::IfCond> uncachedIfCond;
+            simplecpp::preprocess(uncached, tokens1, files, filedata, dui, nullptr, nullptr, &uncachedIfCond);
+            ASSERT_EQUALS(uncached.stringify(), cached.stringify());
+            ASSERT_EQUALS(uncachedIfCond.size(), cachedIfCond.size());
+        }
+        // the second #include is a different macro state (A_H is defined)
+        ASSERT_EQUALS(3U, cache.misses());
+        ASSERT_EQUALS(5U, cache.hits());
+    }
+
+    void tokensInOtherThread() {
+        // tokens are allocated from per thread caches, they can be deleted by another thread
+        std::string code;
+        for (int i = 0; i < 1000; ++i)
+            code += "int x" + std::to_string(i) + " = " + std::to_string(i) + ";\n";
+        std::vector<std::string> files;
+        simplecpp::TokenList *tokens = nullptr;
+        std::thread t1([&]() {
+            std::istringstream istr(code);
+            tokens = new simplecpp::TokenList(istr, files, "test.c");
+        });
+        t1.join();
+        std::thread t2([&]() {
+            delete tokens;
+        });
+        t2.join();
+
+        std::istringstream istr("int x ;");
+        const simplecpp::TokenList tokens2(istr, files, "test.c");
+        ASSERT_EQUALS("int x ;", tokens2.stringify());
+    }
+
+    static std::string loadHeader(const char header[]) {
+        std::istringstream istr(std::string("#include \"") + header + "\"\n");
+        std::vector<std::string> files;
+        const simplecpp::TokenList rawtokens(istr, files, "test.c");
+        simplecpp::clearFileLookupCache();
+        std::map<std::string, simplecpp::TokenList*> filedata = simplecpp::load(rawtokens, files, simplecpp::DUI());
+        std::string ret = "missing";
+        if (filedata.count(header)) {
+            ret.clear();
+            for (const simplecpp::Token *tok = filedata[header]->cfront(); tok; tok = tok->next)
+                ret += (ret.empty() ? "" : " ") + tok->str();
+        }
+        simplecpp::cleanup(filedata);
+        return ret;
+    }
+
+    void fileBuffers() {
+        // a header is read once, it is read again when it has changed
+        const char filename[] = "testpreprocessor_filebuffers.h";
+
+        // the file is changed in the same second as it was read, the size and mtime are the same
+        const std::time_t start = std::time(nullptr);
+        while (std::time(nullptr) == start)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        {
+            std::ofstream fout(filename);
+            fout << "int x ;\r\n";
+        }
+        ASSERT_EQUALS("int x ;", loadHeader(filename));
+        {
+            std::ofstream fout(filename);
+            fout << "int y ;\r\n";
+        }
+        ASSERT_EQUALS("int y ;", loadHeader(filename));
+
+        // the file is read again in a later second, then it is not read anymore
+        const std::time_t written = std::time(nullptr);
+        while (std::time(nullptr) == written)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        simplecpp::FileBufferStats before = simplecpp::getFileBufferStats();
+        ASSERT_EQUALS("int y ;", loadHeader(filename));
+        ASSERT_EQUALS("int y ;", loadHeader(filename));
+        simplecpp::FileBufferStats after = simplecpp::getFileBufferStats();
+        ASSERT_EQUALS(1U, after.misses - before.misses);
+        ASSERT_EQUALS(1U, after.hits - before.hits);
+
+        // source files are not cached
+        std::vector<std::string> files;
+        before = simplecpp::getFileBufferStats();
+        const simplecpp::TokenList source(filename, files);
+        after = simplecpp::getFileBufferStats();
+        ASSERT_EQUALS("int y ;", source.stringify());
+        ASSERT_EQUALS(0U, after.misses - before.misses);
+        ASSERT_EQUALS(0U, after.hits - before.hits);
+
+        {
+            std::ofstream fout(filename);
+            fout << "int xyz ;\n";
+        }
+        ASSERT_EQUALS("int xyz ;", loadHeader(filename));
+        std::remove(filename);
+        ASSERT_EQUALS("missing", loadHeader(filename));
+
+        const simplecpp::TokenList missing("testpreprocessor_missing.h", files);
+        ASSERT(missing.empty());
+    }
+
+    void fileLookupCache() {
+        // a missing header is remembered until the cache is cleared
+        const char header[] = "testpreprocessor_lookup.h";
+        std::remove(header);
+        std::istringstream istr("#include \"testpreprocessor_lookup.h\"\n");
+        std::vector<std::string> files;
+        const simplecpp::TokenList rawtokens(istr, files, "test.c");
+
+        std::map<std::string, simplecpp::TokenList*> filedata = simplecpp::load(rawtokens, files, simplecpp::DUI());
+        ASSERT_EQUALS(0U, filedata.count(header));
+        simplecpp::cleanup(filedata);
+
+        {
+            std::ofstream fout(header);
+            fout << "int x ;\n";
+        }
+        simplecpp::clearFileLookupCache();
+        filedata = simplecpp::load(rawtokens, files, simplecpp::DUI());
+        ASSERT_EQUALS(1U, filedata.count(header));
+        simplecpp::cleanup(filedata);
+        std::remove(header);
+
+        simplecpp::clearFileLookupCache();
+        filedata = simplecpp::load(rawtokens, files, simplecpp::DUI());
+        ASSERT_EQUALS(0U, filedata.count(header));
+        simplecpp::cleanup(filedata);
+    }
+
+    void fileStatus() {
+        // the status is taken when the files are read, not when it is asked for
+        const char source[] = "testpreprocessor_status.c";
+        const char header[] = "testpreprocessor_status.h";
+        {
+            std::ofstream fout(source);
+            fout << "#include \"testpreprocessor_status.h\"\n";
+        }
+        {
+            std::ofstream fout(header);
+            fout << "int x;\n";
+        }
+        simplecpp::FileStatus sourceStatus, headerStatus;
+        ASSERT(simplecpp::getFileStatus(source, sourceStatus));
+        ASSERT(simplecpp::getFileStatus(header, headerStatus));
+
+        Settings settings;
+        Preprocessor preprocessor(settings, this);
+        std::vector<std::string> files;
+        simplecpp::clearFileLookupCache();
+        const simplecpp::TokenList rawtokens(source, files);
+        ASSERT(preprocessor.loadFiles(rawtokens, files));
+        {
+            std::ofstream fout(header);
+            fout << "int xyz;\n";
+        }
+
+        const std::map<std::string, simplecpp::FileStatus> status = preprocessor.getFileStatus(source, rawtokens);
+        ASSERT_EQUALS(2U, status.size());
+        ASSERT_EQUALS(sourceStatus.size, status.at(source).size);
+        ASSERT_EQUALS(sourceStatus.hash, status.at(source).hash);
+        ASSERT_EQUALS(headerStatus.size, status.at(header).size);
+        ASSERT_EQUALS(headerStatus.mtime, status.at(header).mtime);
+        ASSERT_EQUALS(headerStatus.hash, status.at(header).hash);
+
+        simplecpp::FileStatus changed;
+        ASSERT(simplecpp::getFileStatus(header, changed));
+        ASSERT(changed.hash != status.at(header).hash);
+
+        std::remove(source);
+        std::remove(header);
+    }
 };
 
 REGISTER_TEST(TestPreprocessor)
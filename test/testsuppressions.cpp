@@ -46,6 +46,9 @@ private:
         TEST_CASE(suppressionsPathSeparator);
         TEST_CASE(suppressionsLine0);
         TEST_CASE(suppressionsFileComment);
+        TEST_CASE(suppressionsMatchOrder);
+        TEST_CASE(suppressionsCopy);
+        TEST_CASE(suppressionsFilePatterns);
 
         TEST_CASE(inlinesuppress);
         TEST_CASE(inlinesuppress_symbolname);
@@ -516,6 +519,62 @@ private:
         ASSERT_EQUALS(true, suppressions6.isSuppressed(errorMessage("abc", "test.cpp", 123)));
     }
 
+    void suppressionsMatchOrder() {
+        // the first matching suppression is marked as matched, no matter how it is indexed
+        Suppressions suppressions;
+        suppressions.addSuppression(Suppressions::Suppression("*", "test.*"));
+        suppressions.addSuppression(Suppressions::Suppression("abc", "test.cpp", 4));
+        suppressions.addSuppression(Suppressions::Suppression("abc", ""));
+        ASSERT_EQUALS(true, suppressions.isSuppressed(errorMessage("abc", "test.cpp", 4)));
+        ASSERT_EQUALS(1, suppressions.getUnmatchedLocalSuppressions("test.cpp", true).size());
+        ASSERT_EQUALS(1, suppressions.getUnmatchedGlobalSuppressions(true).size());
+
+        Suppressions suppressions2;
+        suppressions2.addSuppression(Suppressions::Suppression("abc", ""));
+        Suppressions::Suppression s("abc", "test\\1.cpp", 4);
+        s.thisAndNextLine = true;
+        suppressions2.addSuppression(s);
+        ASSERT_EQUALS(true, suppressions2.isSuppressedLocal(errorMessage("abc", "test/1.cpp", 5)));
+        ASSERT_EQUALS(false, suppressions2.isSuppressedLocal(errorMessage("abc", "test/1.cpp", 6)));
+        ASSERT_EQUALS(0, suppressions2.getUnmatchedLocalSuppressions("test\\1.cpp", true).size());
+        ASSERT_EQUALS(1, suppressions2.getUnmatchedGlobalSuppressions(true).size());
+
+        // a suppression that is added again is not duplicated
+        suppressions2.addSuppression(s);
+        ASSERT_EQUALS(2, suppressions2.getSuppressions().size());
+    }
+
+    void suppressionsCopy() {
+        Suppressions suppressions;
+        suppressions.addSuppression(Suppressions::Suppression("abc", "test.cpp", 4));
+        ASSERT_EQUALS(false, suppressions.isSuppressed(errorMessage("abc", "test.cpp", 5)));
+        Suppressions copy(suppressions);
+        copy.addSuppression(Suppressions::Suppression("abc", "test.cpp", 5));
+        ASSERT_EQUALS(true, copy.isSuppressed(errorMessage("abc", "test.cpp", 5)));
+        ASSERT_EQUALS(false, suppressions.isSuppressed(errorMessage("abc", "test.cpp", 5)));
+    }
+
+    void suppressionsFilePatterns() {
+        Suppressions suppressions;
+        suppressions.addSuppressionLine("abc:src/a/*.cpp");
+        suppressions.addSuppressionLine("abc:src\\b\\*");
+        suppressions.addSuppressionLine("*:lib/?.cpp");
+        suppressions.addSuppressionLine("def:*/c.cpp");
+        suppressions.addSuppressionLine("def:src/d.cpp");
+        ASSERT_EQUALS(true, suppressions.isSuppressed(errorMessage("abc", "src/a/1.cpp", 1)));
+        ASSERT_EQUALS(false, suppressions.isSuppressed(errorMessage("abc", "src/a/1.h", 1)));
+        ASSERT_EQUALS(false, suppressions.isSuppressed(errorMessage("def", "src/a/1.cpp", 1)));
+        ASSERT_EQUALS(true, suppressions.isSuppressed(errorMessage("abc", "src/b/1.h", 1)));
+        ASSERT_EQUALS(true, suppressions.isSuppressed(errorMessage("def", "lib/x.cpp", 1)));
+        ASSERT_EQUALS(false, suppressions.isSuppressed(errorMessage("def", "lib/xy.cpp", 1)));
+        ASSERT_EQUALS(true, suppressions.isSuppressed(errorMessage("def", "src/c.cpp", 1)));
+        ASSERT_EQUALS(true, suppressions.isSuppressed(errorMessage("def", "src/d.cpp", 1)));
+        ASSERT_EQUALS(false, suppressions.isSuppressed(errorMessage("def", "src/d.cpp.bak", 1)));
+        ASSERT_EQUALS(false, suppressions.isSuppressed(errorMessage("def", "src", 1)));
+        ASSERT_EQUALS(0, suppressions.getUnmatchedGlobalSuppressions(true).size());
+        ASSERT_EQUALS(0, suppressions.getUnmatchedLocalSuppressions("src/d.cpp", true).size());
+    }
+
     void inlinesuppress() {
         Suppressions::Suppression s;
         std::string msg;
@@ -21,6 +21,8 @@
 
 #include <cmath>
 #include <ctime>
+#include <sstream>
+#include <string>
 
 class TestTimer : public TestFixture {
 public:
@@ -30,6 +32,11 @@ private:
 
     void run() OVERRIDE {
         TEST_CASE(result);
+        TEST_CASE(timer);
+        TEST_CASE(merge);
+        TEST_CASE(mergeInvalid);
+        TEST_CASE(json);
+        TEST_CASE(counters);
     }
 
     void result() const {
@@ -40,6 +47,86 @@ private:
         t1.mClocks = CLOCKS_PER_SEC * 5 / 2;
         ASSERT(std::fabs(t1.seconds()-2.5) < 0.01);
     }
+
+    static TimerResultsData measurement(long clocks, long wallTime) {
+        TimerResultsData data;
+        data.mClocks = clocks;
+        data.mWallTime = wallTime;
+        data.mNumberOfResults = 1;
+        return data;
+    }
+
+    void timer() const {
+        TimerResults results;
+        results.setTrace(true);
+        {
+            Timer t("a", SHOWTIME_MODES::SHOWTIME_SUMMARY, &results);
+        }
+        {
+            Timer t("b", SHOWTIME_MODES::SHOWTIME_NONE, &results);
+        }
+        const std::string data = results.serialize();
+        ASSERT_EQUALS(0U, data.find("R\ta\t"));
+        ASSERT(data.find("\nE\ta\t") != std::string::npos);
+        ASSERT(data.find("\tb\t") == std::string::npos);
+    }
+
+    void merge() const {
+        TimerResults child;
+        child.setTrace(true);
+        child.addResults("Tokenizer::tokenize", measurement(10, 20), 1000);
+        child.addResults("Tokenizer::tokenize", measurement(5, 6), 2000);
+
+        TimerResults parent;
+        parent.setTrace(true);
+        parent.addResults("Tokenizer::tokenize", measurement(1, 2), 3000);
+        ASSERT(parent.merge(child.serialize()));
+
+        std::ostringstream out;
+        parent.writeJson(out);
+        const std::string json = out.str();
+        ASSERT(json.find("{\"name\":\"Tokenizer::tokenize\",\"calls\":3,") != std::string::npos);
+        ASSERT(json.find("\"ts\":1000,\"dur\":20,") != std::string::npos);
+        ASSERT(json.find("\"ts\":2000,\"dur\":6,") != std::string::npos);
+        ASSERT(json.find("\"ts\":3000,\"dur\":2,") != std::string::npos);
+    }
+
+    void mergeInvalid() const {
+        TimerResults results;
+        ASSERT(!results.merge("X\tabc\n"));
+        ASSERT(!results.merge("R\tabc\tdef\n"));
+    }
+
+    void json() const {
+        TimerResults results;
+        results.addResults("a\"b", measurement(0, 1500000), 0);
+
+        std::ostringstream out;
+        results.writeJson(out);
+        ASSERT_EQUALS("{\"traceEvents\":[],\n"
+                      "\"displayTimeUnit\":\"ms\",\n"
+                      "\"summary\":[\n"
+                      "{\"name\":\"a\\\"b\",\"calls\":1,\"wall\":1.5,\"cpu\":0,\"rss\":0}]}\n", out.str());
+    }
+
+    void counters() const {
+        TimerResults child;
+        Timer::count("ValueFlow::forks", 3, SHOWTIME_MODES::SHOWTIME_SUMMARY, &child);
+        Timer::count("ValueFlow::forks", 4, SHOWTIME_MODES::SHOWTIME_SUMMARY, &child);
+        Timer::count("ValueFlow::clones", 5, SHOWTIME_MODES::SHOWTIME_NONE, &child);
+
+        TimerResults parent;
+        Timer::count("ValueFlow::forks", 1, SHOWTIME_MODES::SHOWTIME_TOP5, &parent);
+        ASSERT(parent.merge(child.serialize()));
+        ASSERT(!parent.merge("C\tValueFlow::forks\tabc\n"));
+
+        std::ostringstream out;
+        parent.writeJson(out);
+        ASSERT_EQUALS("{\"traceEvents\":[],\n"
+                      "\"displayTimeUnit\":\"ms\",\n"
+                      "\"summary\":[],\n"
+                      "\"counters\":{\n\"ValueFlow::forks\":8}}\n", out.str());
+    }
 };
 
 REGISTER_TEST(TestTimer)
@@ -92,6 +92,7 @@ private:
         TEST_CASE(operators);
 
         TEST_CASE(updateProperties);
+        TEST_CASE(numberValues);
         TEST_CASE(isNameGuarantees1);
         TEST_CASE(isNameGuarantees2);
         TEST_CASE(isNameGuarantees3);
@@ -1021,6 +1022,47 @@ private:
         ASSERT_EQUALS(true, tok.isNumber());
     }
 
+    void numberValues() const {
+        Token tok;
+        tok.str("0x10");
+        ASSERT_EQUALS(true, tok.isIntNumber());
+        ASSERT_EQUALS(false, tok.isFloatNumber());
+        ASSERT_EQUALS(16, tok.intNumber());
+        ASSERT_EQUALS_DOUBLE(16.0, tok.floatNumber(), 0.0);
+        ASSERT_EQUALS(16, tok.intNumber());
+
+        // the cached value is reset when the string changes
+        tok.str("1.5e1f");
+        ASSERT_EQUALS(false, tok.isIntNumber());
+        ASSERT_EQUALS(true, tok.isFloatNumber());
+        ASSERT_EQUALS_DOUBLE(15.0, tok.floatNumber(), 0.0);
+        tok.str("-7LL");
+        ASSERT_EQUALS(true, tok.isIntNumber());
+        ASSERT_EQUALS(-7, tok.intNumber());
+
+        // not a number token
+        tok.str("'a'");
+        ASSERT_EQUALS(false, tok.isNumber());
+        ASSERT_EQUALS(97, tok.intNumber());
+
+        // same results as MathLib for a larger set of literals
+        const char * const literals[] = { "0", "1U", "0777", "0b101", "1'000'000", "18446744073709551615ULL", "0x7fffffffffffffff",
+                                          "1.", ".5", "1e-3", "0x1p4", "3.14159L", "2E+2"
+                                        };
+        for (const char *literal : literals) {
+            Token numtok;
+            numtok.str(literal);
+            for (int i = 0; i < 2; ++i) {
+                ASSERT_EQUALS_MSG(MathLib::isInt(literal), numtok.isIntNumber(), literal);
+                ASSERT_EQUALS_MSG(MathLib::isFloat(literal), numtok.isFloatNumber(), literal);
+                if (numtok.isIntNumber())
+                    ASSERT_EQUALS_MSG(MathLib::toLongNumber(literal), numtok.intNumber(), literal);
+                else
+                    ASSERT_EQUALS_DOUBLE(MathLib::toDoubleNumber(literal), numtok.floatNumber(), 0.0);
+            }
+        }
+    }
+
     void isNameGuarantees1() const {
         Token tok;
         tok.str("Name");
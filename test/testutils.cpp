@@ -30,6 +30,7 @@ private:
     void run() OVERRIDE {
         TEST_CASE(isValidGlobPattern);
         TEST_CASE(matchglob);
+        TEST_CASE(hash64);
     }
 
     void isValidGlobPattern() {
@@ -68,6 +69,21 @@ private:
         ASSERT_EQUALS(true, ::matchglob("?y?", "xyz"));
         ASSERT_EQUALS(true, ::matchglob("?/?/?", "x/y/z"));
     }
+
+    void hash64() const {
+        // FNV-1a test vectors
+        ASSERT(Hash64().get() == 0xcbf29ce484222325ULL);
+        Hash64 h;
+        h.add("a");
+        ASSERT(h.get() == 0xaf63dc4c8601ec8cULL);
+        // the data can be added in pieces
+        Hash64 h1, h2;
+        h1.add("foobar");
+        h2.add("foo");
+        h2.add("bar");
+        ASSERT(h1.get() == 0x85944171f73967e8ULL);
+        ASSERT(h1.get() == h2.get());
+    }
 };
 
 REGISTER_TEST(TestUtils)
@@ -19,6 +19,7 @@
 #include "library.h"
 #include "platform.h"
 #include "settings.h"
+#include "symboldatabase.h"
 #include "testsuite.h"
 #include "token.h"
 #include "tokenize.h"
@@ -149,6 +150,8 @@ private:
         TEST_CASE(valueFlowSymbolic);
         TEST_CASE(valueFlowSymbolicIdentity);
         TEST_CASE(valueFlowSmartPointer);
+        TEST_CASE(valueFlowMemoryBudget);
+        TEST_CASE(valueFlowFunctionLimits);
     }
 
     static bool isNotTokValue(const ValueFlow::Value &val) {
@@ -6840,6 +6843,72 @@ private:
                "}\n";
         ASSERT_EQUALS(false, testValueOfX(code, 5U, 0));
     }
+
+    void valueFlowMemoryBudget() {
+        // many values in the first functions..
+        std::string code;
+        for (int i = 0; i < 2000; i++)
+            code += "void f" + MathLib::toString(i) + "(int x) { if (x == " + MathLib::toString(i) + ") {} int y = x + 1; return y; }\n";
+        // ..a possible value in the last function
+        code += "int g(int x) { if (x == 3) {} return x; }\n";
+
+        for (const int budget : { 0, 1 }) {
+            errout.str("");
+            Settings s(settings);
+            s.debugwarnings = true;
+            s.maxValueFlowMemory = budget;
+            Tokenizer tokenizer(&s, this);
+            std::istringstream istr(code);
+            ASSERT(tokenizer.tokenize(istr, "test.cpp"));
+            const Token *tok = Token::findsimplematch(tokenizer.tokens(), "return x ;");
+            ASSERT(tok != nullptr);
+            if (!tok)
+                return;
+            const bool possible = std::any_of(tok->next()->values().begin(), tok->next()->values().end(), [](const ValueFlow::Value &v) {
+                return v.isPossible() && v.intvalue == 3;
+            });
+            const bool bailout = errout.str().find("ValueFlow memory budget of 1 MB is used up") != std::string::npos;
+            ASSERT_EQUALS(budget == 0, possible);
+            ASSERT_EQUALS(budget != 0, bailout);
+            ASSERT(tokenizer.list.valueFlowMemory() > 0);
+        }
+    }
+
+    void valueFlowFunctionLimits() {
+        // expensive function..
+        std::string code = "void f(int x) {\n";
+        for (int i = 0; i < 200; i++)
+            code += "  if (x == " + MathLib::toString(i) + ") { x++; }\n";
+        code += "}\n";
+        // ..does not prevent the analysis of the next function
+        code += "int g(int y) { if (y == 3) {} return y; }\n";
+
+        for (const int limit : { 0, 1000 }) {
+            errout.str("");
+            Settings s(settings);
+            s.severity.enable(Severity::information);
+            s.maxValueFlowFunctionSteps = limit;
+            Tokenizer tokenizer(&s, this);
+            std::istringstream istr(code);
+            ASSERT(tokenizer.tokenize(istr, "test.cpp"));
+            const Token *tok = Token::findsimplematch(tokenizer.tokens(), "return y ;");
+            ASSERT(tok != nullptr);
+            if (!tok)
+                return;
+            ASSERT(std::any_of(tok->next()->values().begin(), tok->next()->values().end(), [](const ValueFlow::Value &v) {
+                return v.isPossible() && v.intvalue == 3;
+            }));
+
+            const Scope *f = tokenizer.getSymbolDatabase()->functionScopes.front();
+            const Scope *g = tokenizer.getSymbolDatabase()->functionScopes.back();
+            ASSERT_EQUALS(limit != 0, f->valueFlowCost.bailout);
+            ASSERT_EQUALS(false, g->valueFlowCost.bailout);
+            ASSERT(f->valueFlowCost.steps > g->valueFlowCost.steps);
+            ASSERT(g->valueFlowCost.steps > 0);
+            ASSERT_EQUALS(limit != 0, errout.str().find("ValueFlow analysis of function 'f' is cut off") != std::string::npos);
+            ASSERT_EQUALS(std::string::npos, errout.str().find("function 'g'"));
+        }
+    }
 };
 
 REGISTER_TEST(TestValueFlow)
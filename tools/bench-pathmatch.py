@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+#
+# PathMatch benchmark
+#
+# Generates a source tree with many files and runs cppcheck with many -i
+# patterns. The last pattern ignores the whole tree so only the file
+# discovery and the matching of the paths against the patterns is measured.
+#
+# Usage:
+# python3 tools/bench-pathmatch.py [--cppcheck=path] [--dirs=N] [--files=N] [--patterns=N] [--runs=N]
+#
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+
+def generate_tree(root, dirs, files):
+    for d in range(dirs):
+        path = os.path.join(root, 'src', 'module%d' % d, 'impl')
+        os.makedirs(path)
+        for f in range(files):
+            with open(os.path.join(path, 'file%d.c' % f), 'wt') as fh:
+                fh.write('int x%d;\n' % f)
+
+
+def generate_patterns(patterns):
+    # directory and file patterns that do not match any generated path
+    ret = []
+    for i in range(patterns):
+        if i % 2 == 0:
+            ret.append('-ithirdparty%d/' % i)
+        else:
+            ret.append('-igenerated%d.c' % i)
+    ret.append('-iimpl/')
+    return ret
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Measure the performance of -i with many patterns on a generated source tree')
+    parser.add_argument('--cppcheck', default='./cppcheck', help='cppcheck binary')
+    parser.add_argument('--dirs', type=int, default=200, help='number of generated directories')
+    parser.add_argument('--files', type=int, default=50, help='number of files per directory')
+    parser.add_argument('--patterns', type=int, default=1000, help='number of -i patterns')
+    parser.add_argument('--runs', type=int, default=5, help='number of runs, the fastest is reported')
+    args = parser.parse_args()
+
+    if not os.path.isfile(args.cppcheck):
+        print('cppcheck binary not found: ' + args.cppcheck)
+        sys.exit(1)
+    cppcheck = os.path.abspath(args.cppcheck)
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        generate_tree(tmpdir, args.dirs, args.files)
+        cmd = [cppcheck, '-q'] + generate_patterns(args.patterns) + ['src']
+
+        best = None
+        for _ in range(args.runs):
+            start = time.perf_counter()
+            subprocess.run(cmd, cwd=tmpdir, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+            elapsed = time.perf_counter() - start
+            if best is None or elapsed < best:
+                best = elapsed
+
+        print('files: %d, patterns: %d, time: %.3f s' % (args.dirs * args.files, args.patterns, best))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+#
+# Preprocessor benchmark
+#
+# Generates a macro heavy header (X-macros, Boost.PP style repetition,
+# token pasting and stringification) and a source file that includes it and
+# measures how long "cppcheck -E" needs to preprocess it. With --configs the
+# source file has that many configurations.
+#
+# Usage:
+# python3 tools/bench-preprocessor.py [--cppcheck=path] [--size=N] [--configs=N] [--runs=N]
+#
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+
+def generate_repeat_header(size):
+    # Boost.PP style REPEAT macros: REPEAT_n(M, d) expands M(0, d) ... M(n-1, d)
+    lines = ['#define CAT_I(a, b) a ## b',
+             '#define CAT(a, b) CAT_I(a, b)',
+             '#define STR_I(x) #x',
+             '#define STR(x) STR_I(x)',
+             '#define REPEAT_0(M, d)']
+    for i in range(1, size + 1):
+        lines.append('#define REPEAT_%d(M, d) REPEAT_%d(M, d) M(%d, d)' % (i, i - 1, i - 1))
+    lines.append('#define REPEAT(n, M, d) CAT(REPEAT_, n)(M, d)')
+    return '\n'.join(lines) + '\n'
+
+
+def generate_source(size):
+    code = [generate_repeat_header(size)]
+
+    # X-macro table that is expanded several times
+    code.append('#define COLORS(X) \\')
+    for i in range(size):
+        code.append('    X(color%d, %d, "c%d") \\' % (i, i, i))
+    code.append('')
+    code.append('#define AS_ENUM(name, value, text) CAT(E_, name) = value,')
+    code.append('#define AS_STRING(name, value, text) text STR(name),')
+    code.append('#define AS_CASE(name, value, text) case CAT(E_, name): return STR(CAT(name, _str));')
+    code.append('enum Color { COLORS(AS_ENUM) };')
+    code.append('const char *names[] = { COLORS(AS_STRING) };')
+    code.append('const char *name(enum Color c) { switch (c) { COLORS(AS_CASE) } return 0; }')
+
+    # nested repetition
+    code.append('#define FIELD(n, type) type CAT(field, n);')
+    code.append('#define STRUCT(n, d) struct CAT(S, n) { REPEAT(%d, FIELD, int) };' % min(size, 16))
+    code.append('REPEAT(%d, STRUCT, ~)' % size)
+
+    # function-like macros that take other macros as arguments
+    code.append('#define APPLY(f, x) f(x)')
+    code.append('#define TWICE(x) APPLY(STR, CAT(x, x))')
+    code.append('#define USE(n, d) const char *CAT(use, n) = TWICE(CAT(d, n));')
+    code.append('REPEAT(%d, USE, v)' % size)
+    return '\n'.join(code) + '\n'
+
+
+def generate_main(configs):
+    code = ['#include "macros.h"']
+    if configs > 1:
+        for i in range(1, configs):
+            code.append('#ifdef CFG%d' % i)
+            code.append('int cfg%d;' % i)
+            code.append('#endif')
+    return '\n'.join(code) + '\n'
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Measure the preprocessor performance on a generated macro heavy file')
+    parser.add_argument('--cppcheck', default='./cppcheck', help='cppcheck binary')
+    parser.add_argument('--size', type=int, default=200, help='number of repetitions in the generated code')
+    parser.add_argument('--configs', type=int, default=1, help='number of configurations of the source file')
+    parser.add_argument('--runs', type=int, default=5, help='number of runs, the fastest is reported')
+    args = parser.parse_args()
+
+    if not os.path.isfile(args.cppcheck):
+        print('cppcheck binary not found: ' + args.cppcheck)
+        sys.exit(1)
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        with open(os.path.join(tmpdir, 'macros.h'), 'wt') as f:
+            f.write(generate_source(args.size))
+        filename = os.path.join(tmpdir, 'main.c')
+        with open(filename, 'wt') as f:
+            f.write(generate_main(args.configs))
+
+        best = None
+        for _ in range(args.runs):
+            start = time.perf_counter()
+            p = subprocess.run([args.cppcheck, '-E', '--force', filename], stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+            elapsed = time.perf_counter() - start
+            if p.returncode != 0:
+                print('cppcheck failed: ' + p.stderr.decode('utf-8', 'replace'))
+                sys.exit(1)
+            if best is None or elapsed < best:
+                best = elapsed
+
+        print('size: %d, configs: %d, output: %d bytes, time: %.3f s' % (args.size, args.configs, len(p.stdout), best))
+
+
+if __name__ == '__main__':
+    main()